@@ -1,564 +1,5151 @@
-// SimpleTiling.cpp : Defines the functions for the static library.
-//
-
-#include "SimpleTiling.h"
-#include <thread>
-#include <vector>
-#include <intrin.h>
-#include <cassert>
-#include "..\ThirdParty\tracy-0.8\Tracy.hpp"
-
-#define WIN32_LEAN_AND_MEAN
-#include <windows.h>
-#undef min
-#undef max
-
-#include <algorithm>
-#include <concepts>
-#include <condition_variable>
-
-// Define statics declared in [SimpleTiling.h]
-uint32_t canvas_width = 0;
-uint32_t canvas_height = 0;
-BITMAPINFO canvas_bmi;
-uint32_t* back_buffer = nullptr;
-
-// Our design goal is to automate tiling/thread scheduling, so that rendering apps can focus on their core details instead
-namespace simple_tiling_utils
-{
-	// BEEG SOA port didn't really affect performance here; more work needed
-	struct job_q
-	{
-		// Max number of queued jobs per-thread
-		static constexpr int32_t max_queued_jobs = 16;
-
-		// Draw & update job backlogs
-		// void* for trashy C-style runtime polymorphism; valid casts are to/from draw_job and update_job
-		// (depending on the value encoded in work_types for each job)
-		// Bithacking to keep everything in cache instead of array explosion
-		struct job_packet
-		{
-			// 48 bits original pointer data
-			// 1 bit work-type
-			// 1 bit sync mode
-			uint64_t data;
-
-			static constexpr uint64_t payload_mask = static_cast<uint64_t>(UINT8_MAX) << 56;
-			static constexpr uint64_t address_mask = ~(static_cast<uint64_t>(UINT8_MAX) << 56);
-
-			void decode(void*& address, WORK_TYPES& work_type, TASK_SYNC_TYPE& sync_mode)
-			{
-				address = reinterpret_cast<void*>(data & address_mask); // No need to worry about sign-extending with 1s; only working with userland pointers (whew)
-				work_type = static_cast<WORK_TYPES>((data & (1ull << 63)) >> 63);
-				sync_mode = static_cast<TASK_SYNC_TYPE>((data & (1ull << 62)) >> 62);
-			}
-
-			job_packet(void* address, WORK_TYPES work_type, TASK_SYNC_TYPE sync_mode)
-			{
-				data = reinterpret_cast<uint64_t>(address) & address_mask; // Address encoding
-				data |= static_cast<uint64_t>(work_type) << 63; // Work type encoding
-				data |= static_cast<uint64_t>(sync_mode) << 62; // Sync mode encoding
-			}
-
-			job_packet() : data(0) {}
-		};
-		job_packet jobs[max_queued_jobs * max_tiles] = {};
-
-		// Wrappers for each job type
-		draw_job_wrapper draw_wrapper;
-		update_job_wrapper update_wrapper;
-
-		// Book-keeping! Queue depth per-tile
-		std::atomic_int front[max_tiles] = {};
-
-		// More book-keeping; semaphores per-job to enable synchronisation
-		std::atomic_int task_completion[max_queued_jobs * max_tiles] = {};
-
-		void init_q(draw_job_wrapper _draw_wrapper, update_job_wrapper _update_wrapper)
-		{
-			ZeroMemory(jobs, sizeof(jobs));
-			ZeroMemory(front, sizeof(front));
-			ZeroMemory(task_completion, sizeof(task_completion));
-
-			draw_wrapper = _draw_wrapper;
-			update_wrapper = _update_wrapper;
-		}
-
-		template<typename job_type>
-		void append_job(job_type job, uint32_t tile_count, WORK_TYPES work_type, TASK_SYNC_TYPE sync_mode, uint64_t tile_mask) requires (std::same_as<job_type, draw_job> || std::same_as<job_type, update_job>)
-		{
-			ZoneScoped;
-
-			// SOA ring buffer
-			// Can probably be optimized further by reformatting so wrappers/jobs/inputs can be memset - not up to that yet though
-
-			// Sneaky math - instead of filling bits manually, over-shift and subtract to flush them to 1 automatically
-			const bool tiles_filtered = tile_mask != UINT64_MAX && tile_mask != ((1ull << (tile_count + 1)) - 1);
-			if (tiles_filtered)
-			{
-				for (uint32_t i = 0; i < tile_count; i++)
-				{
-					if (tile_mask & (1ull << i)) // Skip processing masked tiles
-					{
-						const uint32_t ndx = (i * max_queued_jobs) + (front[i] % max_queued_jobs);
-						jobs[ndx] = job_packet(job, work_type, sync_mode);
-
-						// Only set these atomics if we need to - polling them is expensive
-						if (sync_mode == EXPLICIT_SYNC)
-						{
-							task_completion[ndx] = 0;
-						}
-
-						front[i]++;
-					}
-				}
-			}
-			else
-			{
-				for (uint32_t i = 0; i < tile_count; i++)
-				{
-					const uint32_t ndx = (i * max_queued_jobs) + (front[i] % max_queued_jobs);
-					jobs[ndx] = job_packet(job, work_type, sync_mode);
-
-					// Only set these atomics if we need to - polling them is expensive
-					if (sync_mode == EXPLICIT_SYNC)
-					{
-						task_completion[ndx] = 0;
-					}
-
-					front[i]++;
-				}
-			}
-		}
-
-		void consume_job(uint32_t tile_ndx, uint32_t tile_count, WORK_TYPES* last_task_type)
-		{
-			ZoneScoped;
-
-			// Only consume jobs if at least one is available in the queue; dip out if no consumeable work
-			if (front == 0)
-			{
-				return;
-			}
-
-			// All good! Consume the most recently-submitted job
-			const uint32_t ndx = std::max((front[tile_ndx] % max_queued_jobs) - 1, 0);
-			const uint32_t offset = (tile_ndx * max_queued_jobs) + ndx;
-
-			void* job;
-			WORK_TYPES work_type;
-			TASK_SYNC_TYPE sync_mode;
-			jobs[offset].decode(job, work_type, sync_mode);
-
-			// Ultra-hacky void* cast, but it's easier than anything else ^_^'
-			if (work_type == DRAW_WORK)
-			{
-				draw_wrapper(tile_ndx, reinterpret_cast<draw_job>(job));
-			}
-			else
-			{
-				update_wrapper(tile_ndx, reinterpret_cast<update_job>(job));
-			}
-
-			// Flag task completed, wait for other threads if necessary
-			// Both tasks are expensive, so only perform them if the current task uses the EXPLICIT_SYNC sync mode
-			if (sync_mode == EXPLICIT_SYNC)
-			{
-				task_completion[offset]++;
-				task_completion[offset].wait(tile_count);
-			}
-
-			front[tile_ndx]--;
-			*last_task_type = work_type;
-		}
-	};
-};
-
-simple_tiling_utils::job_q tile_jobs = {};
-simple_tiling_utils::color_batch* tileBuffers[simple_tiling_utils::max_tiles] = {};
-
-// Padded wrapper used with variables intended for specific threads, to avoid false sharing
-struct XThreadWrapper
-{
-	enum BLIT_MESSAGING
-	{
-		AWAITING_COPY,
-		COPIED
-	};
-
-	struct data
-	{
-		uint32_t tileMinX = 0;
-		uint32_t tileMaxX = 0;
-		uint32_t tileMinY = 0;
-		uint32_t tileMaxY = 0;
-		uint8_t interlace_offset_x = 0; // 2D interlacing on every second row/column, offset is either 0 or 1; mostly only used for draw jobs
-		uint8_t interlace_offset_y = 0; // 2D interlacing on every second row/column, offset is either 0 or 1; mostly only used for draw jobs
-		std::atomic_bool tile_running = {};
-		std::atomic_bool tile_shutdown_success = {};
-		std::atomic<simple_tiling_utils::TILE_STATES> tile_state = {};
-		std::atomic<BLIT_MESSAGING> blit_state = {};
-		std::thread tile;
-	};
-	data threadData = {};
-
-	static constexpr uint8_t padlen = sizeof(data) > 64 ? 0 : (64 - sizeof(data));
-	uint8_t padding[padlen] = {};
-
-	XThreadWrapper(data inputs)
-	{
-		memcpy(&threadData, &inputs, sizeof(data));
-		memset(&padding, 0x0, sizeof(padding));
-	}
-	XThreadWrapper() {}
-};
-
-XThreadWrapper tile_data[simple_tiling_utils::max_tiles] = {};
-
-uint32_t numTiles = 0;
-uint32_t numTilesX = 0;
-uint32_t numTilesY = 0;
-
-bool interlacing = true;
-void draw_wrapper(uint32_t tile_id, simple_tiling_utils::draw_job wrapped_job)
-{
-	ZoneScoped;
-	XThreadWrapper::data& tileInfo = tile_data[tile_id].threadData;
-	const uint32_t minX = tileInfo.tileMinX;
-	const uint32_t maxX = tileInfo.tileMaxX;
-	const uint32_t minY = tileInfo.tileMinY;
-	const uint32_t maxY = tileInfo.tileMaxY;
-	const uint8_t interlace_offs_x = tileInfo.interlace_offset_x;
-	const uint8_t interlace_offs_y = tileInfo.interlace_offset_y;
-	bool unblocked = false;
-
-	// Need to de-interlace X and Y separately - otherwise one axis will always have gaps
-	tileInfo.tile_state = simple_tiling_utils::PROCESSING;
-	uint32_t dy = interlace_offs_y * interlacing;
-	uint32_t dx = interlace_offs_x * NUM_VECTOR_LANES * interlacing;
-	for (uint32_t pixel_row = minY + dy; pixel_row < maxY; pixel_row += (1 + dy))
-	{
-		//  Core pixel processing
-		for (uint32_t pixel_batch = minX + dx; pixel_batch < maxX; pixel_batch += (NUM_VECTOR_LANES + dx)) // For each vectorized pixel batch
-		{
-			// Define outputs
-			const uint32_t tile_width = maxX - minX;
-			const uint32_t tile_height = maxY - minY;
-			const uint32_t tile_px_x = pixel_batch - minX;
-			const uint32_t tile_px_y = pixel_row - minY;
-			const uint32_t tile_px = (tile_px_y * tile_width) + tile_px_x;
-			simple_tiling_utils::color_batch* batch_colors = tileBuffers[tile_id] + (tile_px / NUM_VECTOR_LANES);
-
-			// Issue work
-			const float init_px = static_cast<float>((pixel_row * canvas_width) + pixel_batch);
-			wrapped_job(_mm256_set_ps(init_px, init_px + 1, init_px + 2, init_px + 3, init_px + 4, init_px + 5, init_px + 6, init_px + 7), tile_id, batch_colors);
-		}
-	}
-
-	// No reason to execute copy-outs if tiling has been stopped anyway
-	if (tileInfo.tile_running)
-	{
-		// Signal the main thread that this tile is uploading, so the main thread knows to wait for it
-		tileInfo.tile_state = simple_tiling_utils::UPLOADING;
-
-		// Run back-buffer copies on source threads to prevent them stumbling over each other
-		// Only run copies if the main thread is currently waiting on one
-		if (tileInfo.blit_state == XThreadWrapper::AWAITING_COPY)
-		{
-			const uint32_t dest_w = (maxX - minX);
-			const uint32_t src_w = (maxX - minX) / NUM_VECTOR_LANES;
-
-			auto in_ptr = tileBuffers[tile_id];
-			auto out_ptr = back_buffer + ((minY * canvas_width) + minX);
-
-			for (uint32_t y = minY; y < maxY; y++)
-			{
-				memcpy(out_ptr, in_ptr, sizeof(uint32_t) * dest_w);
-				in_ptr += src_w;
-				out_ptr += canvas_width;
-			}
-
-			tileInfo.blit_state = XThreadWrapper::COPIED;
-
-			// Signal the main thread that we've finished copying-out this tile, so the main thread can proceed with e.g. frame blits
-			tileInfo.tile_state = simple_tiling_utils::IDLE;
-			tileInfo.tile_state.notify_one();
-		}
-	}
-}
-
-void update_wrapper(uint32_t tile_id, simple_tiling_utils::update_job wrapped_job)
-{
-	ZoneScoped;
-	XThreadWrapper::data& tileInfo = tile_data[tile_id].threadData;
-	if (tileInfo.tile_running) // Avoid starting new jobs on terminated tiles
-	{
-		tileInfo.tile_state = simple_tiling_utils::PROCESSING; // No loops or swapchains - totes safe to enter PROCESSING on job start and return to IDLE on job resolve ( / wrapper return)
-		wrapped_job(tile_id); // Updates are expected to take their tile index, but nothing else/
-		tileInfo.tile_state = simple_tiling_utils::IDLE; // No loops or swapchains, so tiles go straight back to IDLE after completing
-	}
-}
-
-void simple_tiling::submit_draw_work(simple_tiling_utils::draw_job work, simple_tiling_utils::TASK_SYNC_TYPE sync_mode, uint64_t tile_mask)
-{
-	ZoneScoped;
-	tile_jobs.append_job(work, numTiles, simple_tiling_utils::DRAW_WORK, sync_mode, tile_mask);
-}
-
-void simple_tiling::submit_update_work(simple_tiling_utils::update_job work, simple_tiling_utils::TASK_SYNC_TYPE sync_mode, uint64_t tile_mask)
-{
-	ZoneScoped;
-	tile_jobs.append_job(work, numTiles, simple_tiling_utils::UPDATE_WORK, sync_mode, tile_mask);
-}
-
-void thread_main(uint32_t tile_ndx)
-{
-	uint32_t tick_ctr = 0;
-	XThreadWrapper::data& tile_info = tile_data[tile_ndx].threadData;
-	while (tile_info.tile_running)
-	{
-		// Consume draw jobs, then consume update jobs
-		// I don't *think* that should cause any issues
-		// (no reason updates drawing during an upload would be a problem, unless the user is intentionally trying to make the main/tile threads interfere with each other)
-		const uint32_t job_count = tile_jobs.front[tile_ndx];
-		if (job_count > 0)
-		{
-			const uint32_t work_type_offset = (tile_ndx * simple_tiling_utils::job_q::max_queued_jobs) + job_count;
-			simple_tiling_utils::WORK_TYPES last_job_type;
-			tile_jobs.consume_job(tile_ndx, numTiles, &last_job_type);
-
-			// Only iterate interlacing for draw tasks - ignore for update work
-			if (last_job_type == simple_tiling_utils::DRAW_WORK)
-			{
-				tile_info.interlace_offset_x = tick_ctr % 2;
-				tile_info.interlace_offset_y = (tick_ctr % 2) * NUM_VECTOR_LANES;
-				tick_ctr++;
-			}
-		}
-	}
-	tile_info.tile_shutdown_success = true;
-}
-
-uint32_t simple_tiling::GetNumTilesTotal()
-{
-	return numTiles;
-}
-
-uint32_t simple_tiling::GetNumTilesX()
-{
-	return numTilesX;
-}
-
-uint32_t simple_tiling::GetNumTilesY()
-{
-	return numTilesY;
-}
-
-static constexpr uint64_t mem_budget = 100000000;
-uint8_t* tiling_pool = nullptr;
-uint8_t* alloc_front = tiling_pool;
-template<typename t>
-t* alloc()
-{
-	t* ptr = reinterpret_cast<t*>(alloc_front);
-	alloc_front += sizeof(t);
-	return ptr;
-}
-
-template<typename t>
-t* alloc_array(uint64_t num_elts)
-{
-	t* ptr = reinterpret_cast<t*>(alloc_front);
-	alloc_front += sizeof(t) * num_elts;
-	return ptr;
-}
-
-// Call after your application's window setup
-//uint32_t* test_canvas = nullptr;
-void simple_tiling::setup(uint32_t num_tiles, uint32_t window_width, uint32_t window_height, bool using_interlacing)
-{
-	// Resolve canvas dimensions
-	canvas_width = window_width;
-	canvas_height = window_height;
-
-	// Resolve tile dimensions
-	//////////////////////////
-
-	// If numTiles is square, use square tiling
-	numTiles = num_tiles;
-	const double root = sqrt(static_cast<double>(num_tiles));
-	if ((root - floor(root)) == 0)
-	{
-		numTilesX = static_cast<uint32_t>(root);
-		numTilesY = static_cast<uint32_t>(root);
-	}
-	else if (num_tiles % 2 == 0) // If numTiles is modulo-2, make two columns of N tiles each
-	{
-		numTilesX = 2;
-		numTilesY = num_tiles / 2;
-	}
-	else // If numTiles is odd and non-square, add one and do the same as above
-		 // (not ideal, but easiest for worker layout)
-	{
-		numTiles++;
-		num_tiles++;
-		numTilesX = 2;
-		numTilesY = num_tiles / 2;
-	}
-
-	const uint32_t tile_width_px = canvas_width / numTilesX;
-	const uint32_t tile_height_px = canvas_height / numTilesY;
-	uint32_t tileCtr = 0;
-	XThreadWrapper::data* tileInfo = &tile_data[tileCtr].threadData;
-	for (uint32_t x = 0; x < numTilesX; x++)
-	{
-		for (uint32_t y = 0; y < numTilesY; y++)
-		{
-			tileInfo->tileMinX = tile_width_px * x;
-			tileInfo->tileMaxX = tileInfo->tileMinX + tile_width_px;
-
-			tileInfo->tileMinY = tile_height_px * y;
-			tileInfo->tileMaxY = tileInfo->tileMinY + tile_height_px;
-
-			tileCtr++;
-			tileInfo = &tile_data[tileCtr].threadData;
-		}
-	}
-
-	// Allocate working memory
-	tiling_pool = (uint8_t*)malloc(mem_budget); // 100MB to start with, we can increase/decrease as we need
-	alloc_front = tiling_pool;
-
-	// Initialize tile data + thread controls
-	const uint32_t tile_width_vectors = tile_width_px / NUM_VECTOR_LANES;
-	const uint32_t tile_height_vectors = tile_height_px;
-	const uint32_t tile_area_vectors = tile_width_vectors * tile_height_vectors;
-
-	tile_jobs.init_q(draw_wrapper, update_wrapper);
-
-	interlacing = using_interlacing;
-	for (uint32_t i = 0; i < num_tiles; i++)
-	{
-		tileBuffers[i] = alloc_array<simple_tiling_utils::color_batch>(tile_area_vectors);
-
-		tile_data[i].threadData.tile_running = true;
-		tile_data[i].threadData.tile_shutdown_success = false;
-		tile_data[i].threadData.tile_state = simple_tiling_utils::IDLE;
-		tile_data[i].threadData.blit_state = XThreadWrapper::COPIED;
-		tile_data[i].threadData.interlace_offset_x = 0;
-		tile_data[i].threadData.interlace_offset_y = 0;
-		tile_data[i].threadData.tile = std::thread(thread_main, i);
-	}
-
-	// Allocate the canvas back-buffer
-	//test_canvas = alloc_array<uint32_t>(canvas_width * canvas_height);
-	back_buffer = alloc_array<uint32_t>(canvas_width * canvas_height);
-	//memset(back_buffer, 0xff, canvas_width * canvas_height * 4);
-
-	// Prepare BITMAPINFO (needed for Windows' blitting interface)
-	BITMAPINFO nfo;
-	ZeroMemory(&nfo, sizeof(BITMAPINFO));
-	nfo.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
-	nfo.bmiHeader.biWidth = canvas_width;
-	nfo.bmiHeader.biHeight = canvas_height;
-	nfo.bmiHeader.biPlanes = 1;
-	nfo.bmiHeader.biBitCount = 32;
-	nfo.bmiHeader.biCompression = BI_RGB;
-	nfo.bmiHeader.biSizeImage = 0;
-	nfo.bmiHeader.biXPelsPerMeter = 0; // 3840 / 36cm
-	nfo.bmiHeader.biYPelsPerMeter = 0; // 2160 / 16cm
-	nfo.bmiHeader.biClrUsed = FALSE;
-	nfo.bmiHeader.biClrImportant = FALSE;
-	canvas_bmi = nfo;
-}
-
-void simple_tiling::shutdown()
-{
-	// Terminate tile threads
-	for (uint32_t i = 0; i < numTiles; i++)
-	{
-		XThreadWrapper::data& tileInfo = tile_data[i].threadData;
-		tileInfo.tile_running = false;
-		while (!tileInfo.tile_shutdown_success)
-		{
-			// Repeatedly notify blocked threads until they unblock
-			tileInfo.tile_state.store(simple_tiling_utils::IDLE);
-			tileInfo.tile_state.notify_one();
-		}
-	}
-
-	// Separate loops so that calls to [join] are delayed enough for tile states to be well-defined
-	for (uint32_t i = 0; i < numTiles; i++)
-	{
-		XThreadWrapper::data& tileInfo = tile_data[i].threadData;
-		tileInfo.tile.join();
-	}
-
-	// ... other shutdown things ... //
-	free(tiling_pool); // <3 linear allocators
-}
-
-// Called from the WM_PAINT block of your message pump
-// (between BeginPaint() and EndPaint())
-void simple_tiling::win_paint(void* hdc, uint32_t frame_budget_ms)
-{
-	ZoneScoped;
-	auto t = std::chrono::steady_clock::now();
-	auto start_t = t.time_since_epoch();
-	uint32_t d_i = 1;
-	for (uint32_t i = 0; i < numTiles; i += d_i)
-	{
-		ZoneScoped;
-		XThreadWrapper::data& tileInfo = tile_data[i].threadData;
-
-		// Spin here if the back-buffer is still blocked
-		if (tileInfo.tile_state == simple_tiling_utils::UPLOADING)
-		{
-			tileInfo.blit_state = XThreadWrapper::AWAITING_COPY;
-		}
-		else
-		{
-			ZoneScoped;
-			const uint32_t minY = tileInfo.tileMinY;
-			const uint32_t minX = tileInfo.tileMinX;
-			const uint32_t maxY = tileInfo.tileMaxY;
-			const uint32_t h = maxY - minY;
-			uint32_t maxX = tileInfo.tileMaxX;
-
-			// If the current tile & the following tiles have the same y-value, they're adjacent (because of the logic we used to lay-out the tiles when we placed them)
-			// In that case, check if each of the following tiles are also not being uploaded and copy them out with the current one; that may be faster than many separate copies
-			uint32_t skipped_ctr = 1;
-			bool searching = true;
-			while (searching)
-			{
-				const XThreadWrapper::data& nextTileInfo = tile_data[i + skipped_ctr].threadData;
-				const uint32_t nextMinY = nextTileInfo.tileMinY;
-				const uint32_t nextBlitState = nextTileInfo.blit_state;
-
-				if (nextMinY == minY && nextBlitState == tileInfo.blit_state)
-				{
-					d_i = skipped_ctr;
-					maxX = nextTileInfo.tileMaxX;
-					skipped_ctr++;
-				}
-				else
-				{
-					searching = false;
-					break;
-				}
-			}
-
-			const uint32_t w = maxX - minX;
-			uint32_t test = SetDIBitsToDevice(static_cast<HDC>(hdc), minX, minY, w, h, minX, minY, minY, h, back_buffer, &canvas_bmi, DIB_RGB_COLORS);
-			assert(test);
-		}
-
-		t = std::chrono::steady_clock::now();
-		const auto curr_t = t.time_since_epoch();
-		const auto dt_ms = std::chrono::duration_cast<std::chrono::milliseconds>(curr_t - start_t);
-		if (dt_ms.count() > frame_budget_ms)
-		{
-			break;
-		}
-	}
-}
+// SimpleTiling.cpp : Defines the functions for the static library.
+//
+
+#include "SimpleTiling.h"
+#include "SimpleTilingBackends.h"
+#include <thread>
+#include <vector>
+#include <cassert>
+#include <cmath>
+#include <cfloat>
+#include <cstring>
+#include <chrono>
+#include "../ThirdParty/tracy-0.8/Tracy.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <condition_variable>
+#include <mutex>
+
+// Define statics declared in [SimpleTiling.h]
+uint32_t canvas_width = 0;
+uint32_t canvas_height = 0;
+
+// Presentation backend selected in [setup]
+const simple_tiling_utils::present_backend* presenter = nullptr;
+simple_tiling_utils::present_stats presentation_stats = {};
+std::mutex presentation_stats_lock; // Stats are written by whichever thread presents, and read by the host
+
+// Presenter thread state (see [simple_tiling::start_presenter])
+std::thread presenter_thread;
+std::atomic_bool presenter_running = false;
+std::atomic_bool repaint_requested = false; // Set by [win_paint] while the presenter thread owns presentation
+std::mutex presenter_wake_lock; // Lets [stop_presenter] cut the presenter's sleep short, instead of waiting out the interval
+std::condition_variable presenter_wake;
+void* presenter_target = nullptr;
+uint32_t presenter_interval_us = 0;
+bool present_complete = false; // Whether the last [present] reached every tile before running out of budget
+
+// Presentation order + per-tile book-keeping; only ever touched by whichever thread calls [present]
+// (apart from presentation timestamps, which hosts can poll from any thread through [GetTilePresentAge])
+simple_tiling_utils::PRESENT_ORDERS present_order = simple_tiling_utils::ROUND_ROBIN_PRESENT;
+uint32_t present_cursor = 0;
+std::atomic<uint64_t> tile_last_presented_us[simple_tiling_utils::max_tiles] = {}; // steady_clock timestamps; zero until [setup]
+
+// Our design goal is to automate tiling/thread scheduling, so that rendering apps can focus on their core details instead
+namespace simple_tiling_utils
+{
+	// BEEG SOA port didn't really affect performance here; more work needed
+	struct job_q
+	{
+		// Max number of queued jobs per-thread
+		static constexpr int32_t max_queued_jobs = 16;
+
+		// Draw & update job backlogs
+		// void* for trashy C-style runtime polymorphism; valid casts are to/from draw_job, hdr_draw_job, fused_chain*, inlined_draw_job*, span_draw_job and update_job
+		// (depending on the value encoded in work_types for each job, and the draw-job type for draw jobs)
+		// Bithacking to keep everything in cache instead of array explosion
+		struct job_packet
+		{
+			// 48 bits original pointer data
+			// 6 bits damage-list slot (zero for full-tile work, otherwise an index into [damage_lists] + 1)
+			// 3 bits draw-job type (draw jobs only, see [DRAW_JOB_TYPES])
+			// 5 bits render-scale level (zero for native resolution, see [render_scale_steps])
+			// 1 bit work-type
+			// 1 bit sync mode
+			uint64_t data;
+
+			static constexpr uint64_t address_mask = (1ull << 48) - 1;
+			static constexpr uint64_t damage_mask = 63ull << 48;
+			static constexpr uint64_t draw_type_mask = 7ull << 54;
+			static constexpr uint64_t level_mask = 31ull << 57;
+			static_assert(SPAN_DRAW_JOB < 8 && render_scale_steps <= 32, "Draw-job types + render-scale levels need to fit in [job_packet]");
+
+			void decode(void*& address, WORK_TYPES& work_type, TASK_SYNC_TYPE& sync_mode, uint32_t& damage_slot, uint32_t& render_level, DRAW_JOB_TYPES& draw_type)
+			{
+				address = reinterpret_cast<void*>(data & address_mask); // No need to worry about sign-extending with 1s; only working with userland pointers (whew)
+				damage_slot = static_cast<uint32_t>((data & damage_mask) >> 48);
+				draw_type = static_cast<DRAW_JOB_TYPES>((data & draw_type_mask) >> 54);
+				render_level = static_cast<uint32_t>((data & level_mask) >> 57);
+				work_type = static_cast<WORK_TYPES>((data & (1ull << 63)) >> 63);
+				sync_mode = static_cast<TASK_SYNC_TYPE>((data & (1ull << 62)) >> 62);
+			}
+
+			job_packet(void* address, WORK_TYPES work_type, TASK_SYNC_TYPE sync_mode, uint32_t damage_slot, uint32_t render_level, DRAW_JOB_TYPES draw_type)
+			{
+				data = reinterpret_cast<uint64_t>(address) & address_mask; // Address encoding
+				data |= (static_cast<uint64_t>(damage_slot) << 48) & damage_mask; // Damage-list encoding
+				data |= (static_cast<uint64_t>(draw_type) << 54) & draw_type_mask; // Draw-job type encoding
+				data |= (static_cast<uint64_t>(render_level) << 57) & level_mask; // Render-scale encoding
+				data |= static_cast<uint64_t>(work_type) << 63; // Work type encoding
+				data |= static_cast<uint64_t>(sync_mode) << 62; // Sync mode encoding
+			}
+
+			job_packet() : data(0) {}
+		};
+		job_packet jobs[max_queued_jobs * max_tiles] = {};
+
+		// Wrappers for each job type
+		draw_job_wrapper draw_wrapper;
+		update_job_wrapper update_wrapper;
+
+		// Book-keeping! Queue depth per-tile
+		std::atomic_int front[max_tiles] = {};
+
+		// Damage lists for damage-driven draw jobs; a ring twice the per-tile queue depth, so a list normally comes back around long after
+		// every tile has finished with it
+		// Submissions with a [tile_mask] still advance the ring without queueing anything on masked tiles though, so a slow tile can fall
+		// further behind than that, so [claim_slot] skips lists that queued jobs still carry
+		static constexpr uint32_t max_damage_lists = max_queued_jobs * 2;
+		damage_list damage_lists[max_damage_lists] = {};
+		uint32_t damage_list_ctr = 0;
+		static_assert(max_damage_lists < 64, "Damage-list slots (+ 1) need to fit in six bits, see [job_packet]");
+
+		// Fused chains, copied in on submission; same ring (+ reasoning, + [claim_slot] check) as [damage_lists]
+		static constexpr uint32_t max_fused_chains = max_queued_jobs * 2;
+		fused_chain fused_chains[max_fused_chains] = {};
+		uint32_t fused_chain_ctr = 0;
+
+		// Inlined jobs, copied in on submission (kernel object and all); same ring (+ [claim_slot] check) again
+		static constexpr uint32_t max_inlined_jobs = max_queued_jobs * 2;
+		inlined_draw_job inlined_jobs[max_inlined_jobs] = {};
+		uint32_t inlined_job_ctr = 0;
+
+		// More book-keeping; semaphores per-job to enable synchronisation
+		std::atomic_int task_completion[max_queued_jobs * max_tiles] = {};
+
+		// Frame-constant snapshots (see [simple_tiling::publish_frame_constants]); jobs are stamped with the newest published frame when they're
+		// queued, and read that frame's snapshot however long they wait, so every tile sees the same state for the same submission
+		// Unlike the rings above, the queue depth doesn't bound how far behind tiles can be here (hosts can publish without submitting anything),
+		// so [publish_frame] checks that no queued job still carries the frame it's about to overwrite
+		static constexpr uint32_t max_frame_snapshots = max_queued_jobs * 2;
+		frame_constants frame_snapshots[max_frame_snapshots] = {};
+		uint64_t published_frame = 0; // Only touched by the submitting thread
+		uint64_t job_frames[max_queued_jobs * max_tiles] = {};
+		uint64_t running_frames[max_tiles] = {}; // Stamp on the job each tile is running; only touched by that tile
+
+		void init_frames()
+		{
+			for (frame_constants& snapshot : frame_snapshots)
+			{
+				snapshot = frame_constants();
+			}
+			published_frame = 0;
+			memset(job_frames, 0, sizeof(job_frames));
+			memset(running_frames, 0, sizeof(running_frames));
+		}
+
+		// True if any job queued (or running; tiles pop jobs after they finish) in the first [tile_count] tiles carries [frame]
+		// Tiles only ever shrink their queues, so whatever we miss here had already finished with the snapshot
+		bool frame_in_use(uint64_t frame, uint32_t tile_count)
+		{
+			for (uint32_t i = 0; i < tile_count; i++)
+			{
+				const uint32_t depth = static_cast<uint32_t>(std::min(front[i].load(), max_queued_jobs));
+				for (uint32_t j = 0; j < depth; j++)
+				{
+					if (job_frames[(i * max_queued_jobs) + j] == frame)
+					{
+						return true;
+					}
+				}
+			}
+			return false;
+		}
+
+		void publish_frame(const frame_constants& constants, uint32_t tile_count)
+		{
+			ZoneScoped;
+			const uint64_t frame = published_frame + 1;
+			if (frame >= max_frame_snapshots)
+			{
+				while (frame_in_use(frame - max_frame_snapshots, tile_count))
+				{
+					std::this_thread::yield();
+				}
+			}
+
+			// Tiles only see the snapshot through jobs queued after this, and queueing goes through [front], so there's no need to fence it separately
+			frame_constants& snapshot = frame_snapshots[frame % max_frame_snapshots];
+			snapshot = constants;
+			snapshot.frame_index = frame;
+			published_frame = frame;
+		}
+
+		void init_q(draw_job_wrapper _draw_wrapper, update_job_wrapper _update_wrapper)
+		{
+			for (uint32_t i = 0; i < (max_queued_jobs * max_tiles); i++)
+			{
+				jobs[i] = job_packet();
+				task_completion[i] = 0;
+			}
+
+			for (std::atomic_int& depth : front)
+			{
+				depth = 0;
+			}
+			memset(job_frames, 0, sizeof(job_frames));
+			damage_list_ctr = 0;
+			fused_chain_ctr = 0;
+			inlined_job_ctr = 0;
+
+			draw_wrapper = _draw_wrapper;
+			update_wrapper = _update_wrapper;
+		}
+
+		// Pick the next slot in a [ring_size]-entry ring that no job queued (or running) in the first [tile_count] tiles still refers to, and
+		// move [ring_ctr] past it; [packet_slot] maps a queued [job_packet] to the slot it reads, or [ring_size] if it doesn't use the ring
+		// Same reasoning as [frame_in_use]; tiles only ever shrink their queues, so whatever we miss here had already finished with its slot
+		// Busy slots are skipped rather than waited on (tiles a frame ahead of a masked-out tile hold theirs until that tile gets work), so we
+		// only wait when every slot is taken
+		template<typename slot_mapping>
+		uint32_t claim_slot(uint32_t& ring_ctr, uint32_t ring_size, uint32_t tile_count, slot_mapping packet_slot)
+		{
+			ZoneScoped;
+			static_assert(max_queued_jobs * 2 <= 64, "Ring slots need to fit in a 64-bit busy mask");
+			while (true)
+			{
+				uint64_t busy = 0;
+				for (uint32_t i = 0; i < tile_count; i++)
+				{
+					const uint32_t depth = static_cast<uint32_t>(std::min(front[i].load(), max_queued_jobs));
+					for (uint32_t j = 0; j < depth; j++)
+					{
+						const uint32_t slot = packet_slot(jobs[(i * max_queued_jobs) + j]);
+						busy |= (slot < ring_size) ? (1ull << slot) : 0;
+					}
+				}
+
+				for (uint32_t i = 0; i < ring_size; i++)
+				{
+					const uint32_t slot = (ring_ctr + i) % ring_size;
+					if ((busy & (1ull << slot)) == 0)
+					{
+						ring_ctr = slot + 1;
+						return slot;
+					}
+				}
+				std::this_thread::yield();
+			}
+		}
+
+		// Claim a damage-list slot that no queued job still reads
+		uint32_t claim_damage_slot(uint32_t tile_count)
+		{
+			return claim_slot(damage_list_ctr, max_damage_lists, tile_count, [](const job_packet& packet)
+			{
+				return static_cast<uint32_t>((packet.data & job_packet::damage_mask) >> 48) - 1; // Zero (no list) wraps past the ring
+			});
+		}
+
+		// Copy [rects] into a free damage-list slot, and return the slot ID for [append_job]
+		uint32_t push_damage(const damage_rect* rects, uint32_t num_rects, uint32_t tile_count)
+		{
+			const uint32_t slot = claim_damage_slot(tile_count);
+			damage_list& list = damage_lists[slot];
+			list.num_rects = std::min(num_rects, damage_list::max_rects);
+			list.sparse = false;
+			memcpy(list.rects, rects, sizeof(damage_rect) * list.num_rects);
+
+			// Too many rects; merge the overflow into the last one we have room for
+			damage_rect& tail = list.rects[damage_list::max_rects - 1];
+			for (uint32_t i = damage_list::max_rects; i < num_rects; i++)
+			{
+				tail.minX = std::min(tail.minX, rects[i].minX);
+				tail.minY = std::min(tail.minY, rects[i].minY);
+				tail.maxX = std::max(tail.maxX, rects[i].maxX);
+				tail.maxY = std::max(tail.maxY, rects[i].maxY);
+			}
+			return slot + 1;
+		}
+
+		// Claim a free damage-list slot for a sparse pass (no rects, see [damage_list::sparse]), and return the slot ID for [append_job]
+		uint32_t push_sparse(uint32_t tile_count)
+		{
+			const uint32_t slot = claim_damage_slot(tile_count);
+			damage_lists[slot].num_rects = 0;
+			damage_lists[slot].sparse = true;
+			return slot + 1;
+		}
+
+		// Copy [chain] into a fused-chain slot no queued job still reads, and return the copy for [append_job]
+		fused_chain* push_chain(const fused_chain& chain, uint32_t tile_count)
+		{
+			const uint32_t slot = claim_slot(fused_chain_ctr, max_fused_chains, tile_count, [this](const job_packet& packet)
+			{
+				const uint64_t offset = (packet.data & job_packet::address_mask) - reinterpret_cast<uint64_t>(fused_chains); // Wraps for addresses below the ring
+				return (offset < sizeof(fused_chains)) ? static_cast<uint32_t>(offset / sizeof(fused_chain)) : max_fused_chains;
+			});
+			fused_chains[slot] = chain;
+			return &fused_chains[slot];
+		}
+
+		// Copy [job] into an inlined-job slot no queued job still reads, and return the copy for [append_job]
+		inlined_draw_job* push_inlined(const inlined_draw_job& job, uint32_t tile_count)
+		{
+			const uint32_t slot = claim_slot(inlined_job_ctr, max_inlined_jobs, tile_count, [this](const job_packet& packet)
+			{
+				const uint64_t offset = (packet.data & job_packet::address_mask) - reinterpret_cast<uint64_t>(inlined_jobs); // Wraps for addresses below the ring
+				return (offset < sizeof(inlined_jobs)) ? static_cast<uint32_t>(offset / sizeof(inlined_draw_job)) : max_inlined_jobs;
+			});
+			inlined_jobs[slot] = job;
+			return &inlined_jobs[slot];
+		}
+
+		template<typename job_type>
+		void append_job(job_type job, uint32_t tile_count, WORK_TYPES work_type, TASK_SYNC_TYPE sync_mode, uint64_t tile_mask, uint32_t damage_slot = 0, uint32_t render_level = 0)
+			requires (std::same_as<job_type, draw_job> || std::same_as<job_type, hdr_draw_job> || std::same_as<job_type, fused_chain*> || std::same_as<job_type, inlined_draw_job*> ||
+					  std::same_as<job_type, span_draw_job> || std::same_as<job_type, update_job>)
+		{
+			ZoneScoped;
+			constexpr DRAW_JOB_TYPES draw_type = std::same_as<job_type, hdr_draw_job> ? HDR_DRAW_JOB :
+												 std::same_as<job_type, fused_chain*> ? FUSED_DRAW_JOB :
+												 std::same_as<job_type, inlined_draw_job*> ? INLINED_DRAW_JOB :
+												 std::same_as<job_type, span_draw_job> ? SPAN_DRAW_JOB : PLAIN_DRAW_JOB;
+
+			// SOA ring buffer
+			// Can probably be optimized further by reformatting so wrappers/jobs/inputs can be memset - not up to that yet though
+
+			// Sneaky math - instead of filling bits manually, over-shift and subtract to flush them to 1 automatically
+			const bool tiles_filtered = tile_mask != UINT64_MAX && tile_mask != ((1ull << (tile_count + 1)) - 1);
+			if (tiles_filtered)
+			{
+				for (uint32_t i = 0; i < tile_count; i++)
+				{
+					if (tile_mask & (1ull << i)) // Skip processing masked tiles
+					{
+						const uint32_t ndx = (i * max_queued_jobs) + (front[i] % max_queued_jobs);
+						jobs[ndx] = job_packet(reinterpret_cast<void*>(job), work_type, sync_mode, damage_slot, render_level, draw_type);
+						job_frames[ndx] = published_frame;
+
+						// Only set these atomics if we need to - polling them is expensive
+						if (sync_mode == EXPLICIT_SYNC)
+						{
+							task_completion[ndx] = 0;
+						}
+
+						front[i]++;
+					}
+				}
+			}
+			else
+			{
+				for (uint32_t i = 0; i < tile_count; i++)
+				{
+					const uint32_t ndx = (i * max_queued_jobs) + (front[i] % max_queued_jobs);
+					jobs[ndx] = job_packet(reinterpret_cast<void*>(job), work_type, sync_mode, damage_slot, render_level, draw_type);
+					job_frames[ndx] = published_frame;
+
+					// Only set these atomics if we need to - polling them is expensive
+					if (sync_mode == EXPLICIT_SYNC)
+					{
+						task_completion[ndx] = 0;
+					}
+
+					front[i]++;
+				}
+			}
+		}
+
+		void consume_job(uint32_t tile_ndx, uint32_t tile_count, WORK_TYPES* last_task_type)
+		{
+			ZoneScoped;
+
+			// Only consume jobs if at least one is available in the queue; dip out if no consumeable work
+			if (front[tile_ndx] == 0)
+			{
+				return;
+			}
+
+			// All good! Consume the most recently-submitted job
+			const uint32_t ndx = std::max((front[tile_ndx] % max_queued_jobs) - 1, 0);
+			const uint32_t offset = (tile_ndx * max_queued_jobs) + ndx;
+
+			void* job;
+			WORK_TYPES work_type;
+			TASK_SYNC_TYPE sync_mode;
+			uint32_t damage_slot;
+			uint32_t render_level;
+			DRAW_JOB_TYPES draw_type;
+			jobs[offset].decode(job, work_type, sync_mode, damage_slot, render_level, draw_type);
+			running_frames[tile_ndx] = job_frames[offset];
+
+			// Ultra-hacky void* cast, but it's easier than anything else ^_^'
+			if (work_type == DRAW_WORK)
+			{
+				draw_wrapper(tile_ndx, reinterpret_cast<draw_job>(job), damage_slot > 0 ? &damage_lists[damage_slot - 1] : nullptr, render_level, draw_type);
+			}
+			else
+			{
+				update_wrapper(tile_ndx, reinterpret_cast<update_job>(job));
+			}
+
+			// Flag task completed, wait for other threads if necessary
+			// Both tasks are expensive, so only perform them if the current task uses the EXPLICIT_SYNC sync mode
+			if (sync_mode == EXPLICIT_SYNC)
+			{
+				task_completion[offset]++;
+				task_completion[offset].wait(tile_count);
+			}
+
+			front[tile_ndx]--;
+			*last_task_type = work_type;
+		}
+	};
+
+	// Triple-buffered swap chain
+	// Tiles copy into the shared write buffer; once every tile has contributed, the last one in flips the write buffer into the
+	// "ready" slot with a single atomic exchange. The presenter swaps its own buffer with the ready slot whenever that's marked
+	// fresh, so it always reads a complete frame (no tearing) and never blocks tiles (there's always a third buffer to write into)
+	struct swap_chain
+	{
+		static constexpr uint32_t num_buffers = 3;
+		static constexpr uint32_t fresh_bit = 1u << 31; // Set on the ready slot when it holds a frame the presenter hasn't seen yet
+		static constexpr uint32_t ndx_mask = ~fresh_bit;
+
+		uint32_t* buffers[num_buffers] = {};
+		std::atomic_uint64_t publish_us[num_buffers] = {}; // steady_clock time each buffer was last published, for measuring present latency
+
+		// Buffer roles; [write_ndx] is only modified by the tile that completes a frame (while every other tile is waiting on
+		// [generation]), [present_ndx] is only touched by the presenter, and [ready] is the hand-off between the two
+		uint32_t write_ndx = 0;
+		uint32_t present_ndx = 2;
+		std::atomic_uint32_t ready = 1;
+
+		// Frame book-keeping
+		std::atomic_uint32_t generation = 0; // Number of published frames
+		std::atomic_uint32_t tiles_contributed = 0; // Tiles that have copied into the current write buffer
+		std::atomic_uint32_t last_published = 1; // Most recently completed buffer, whether or not the presenter has picked it up
+
+		void init(uint32_t* const _buffers[num_buffers])
+		{
+			for (uint32_t i = 0; i < num_buffers; i++)
+			{
+				buffers[i] = _buffers[i];
+			}
+			write_ndx = 0;
+			ready = 1;
+			present_ndx = 2;
+			generation = 0;
+			tiles_contributed = 0;
+			last_published = 1;
+		}
+
+		// Returns the buffer a tile should copy into, or nullptr if [running] drops while we wait
+		// Tiles that already contributed to the in-flight frame wait for it to publish first; otherwise they could overwrite
+		// pixels from the frame that's about to be presented
+		uint32_t* begin_copy(uint32_t& tile_generation, const std::atomic_bool& running)
+		{
+			ZoneScoped;
+			uint32_t gen = generation;
+			while (tile_generation == (gen + 1) && running)
+			{
+				generation.wait(gen);
+				gen = generation;
+			}
+			return running ? buffers[write_ndx] : nullptr;
+		}
+
+		// Flag a tile's copy-out as finished; the tile completing the frame publishes it
+		void end_copy(uint32_t& tile_generation, uint32_t tile_count)
+		{
+			tile_generation = generation + 1;
+			if ((tiles_contributed.fetch_add(1) + 1) == tile_count)
+			{
+				ZoneScopedN("Publish frame");
+				tiles_contributed = 0;
+				last_published = write_ndx;
+				publish_us[write_ndx] = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+				write_ndx = ready.exchange(write_ndx | fresh_bit) & ndx_mask;
+				generation++;
+				generation.notify_all();
+			}
+		}
+
+		// Called by the presenter; picks up the newest complete frame if there is one, otherwise keeps presenting the last one
+		// [fresh_publish_us] receives the new frame's publish time, or zero if we're re-presenting a frame we've already shown
+		uint32_t* acquire_present(uint64_t& fresh_publish_us)
+		{
+			fresh_publish_us = 0;
+			if (ready & fresh_bit)
+			{
+				present_ndx = ready.exchange(present_ndx) & ndx_mask;
+				fresh_publish_us = publish_us[present_ndx];
+			}
+			return buffers[present_ndx];
+		}
+
+		bool has_fresh_frame()
+		{
+			return (ready & fresh_bit) != 0;
+		}
+
+		// Unblock tiles waiting on a frame that's never going to finish (shutdown)
+		void release_waiters()
+		{
+			generation++;
+			generation.notify_all();
+		}
+	};
+};
+
+simple_tiling_utils::job_q tile_jobs = {};
+simple_tiling_utils::swap_chain tile_swap_chain = {};
+simple_tiling_utils::color_batch* tileBuffers[simple_tiling_utils::max_tiles] = {};
+uint32_t* resolveBuffers[simple_tiling_utils::max_tiles] = {}; // Checkerboard output, resolved from [tileBuffers]; interlacing only
+uint8_t* checker_motion[simple_tiling_utils::max_tiles] = {}; // Per-tile checkerboard motion flags; one per row, per sixteen-pixel segment of each region
+uint32_t* upscale_scratch[simple_tiling_utils::max_tiles] = {}; // Dynamic-resolution working memory, sized for each tile's largest region; see [shade_upscaled]
+uint8_t* shading_rates[simple_tiling_utils::max_tiles] = {}; // Per-tile adaptive shading rates; one per block of each region, see [shade_rated]
+float* accum_buffers[simple_tiling_utils::max_tiles] = {}; // Per-tile running color sums, laid out like tile scratch; accumulation only, see [shade_accumulated]
+uint8_t* hdr_buffers[simple_tiling_utils::max_tiles] = {}; // Per-tile HDR colors, laid out like tile scratch; buffered HDR output only, see [shade_hdr_block]
+static constexpr uint32_t num_history_frames = 3;
+uint32_t* history_frames[num_history_frames] = {}; // Canvas-sized copies of recent frames; reprojection only, see [shade_reprojected]
+static constexpr uint32_t num_post_canvases = 3;
+uint32_t* post_canvases[num_post_canvases] = {}; // Padded canvases for post-processing; the unprocessed frame, then two more effects alternate between
+uint32_t* post_buffers[simple_tiling_utils::max_tiles] = {}; // Post-processed output, laid out like tile scratch; tile-buffer output only, see [run_post_effects]
+float* post_scratch[simple_tiling_utils::max_tiles] = {}; // Separable-effect working memory, sized for each tile's largest region; see [post_separable]
+uint32_t* pixel_lists[simple_tiling_utils::max_tiles][2] = {}; // Per-tile sparse pixel lists (canvas indices); pixel lists only, see [simple_tiling::mark_pixels]
+uint32_t pixel_list_capacity[simple_tiling_utils::max_tiles] = {}; // Entries in each of a tile's lists; every pixel it owns, plus room for one more whole-vector store
+uint32_t* edge_lists[simple_tiling_utils::max_tiles] = {}; // Per-tile edge pixels, sized for each tile's largest region; anti-aliasing only, see [find_edges]
+
+// Padded wrapper used with variables intended for specific threads, to avoid false sharing
+// (aligned rather than explicitly padded; [data] is already a full cache-line under MSVC, where std::thread carries its id as well as a handle)
+struct alignas(64) XThreadWrapper
+{
+	struct data
+	{
+		uint32_t tileMinX = 0;
+		uint32_t tileMaxX = 0;
+		uint32_t tileMinY = 0;
+		uint32_t tileMaxY = 0;
+		uint8_t checker_parity = 0; // Which half of the checkerboard the next interlaced pass shades; flips after every draw job
+		uint8_t rate_refresh_phase = 0; // Which coarse shading-rate blocks re-shade at full rate next pass; cycles through eight phases, see [shade_rated]
+		std::atomic_bool history_valid = {}; // Whether our output surface holds a complete previous frame to reconstruct skipped pixels from
+		std::atomic_bool tile_running = {};
+		std::atomic_bool tile_shutdown_success = {};
+		std::atomic<simple_tiling_utils::TILE_STATES> tile_state = {};
+		uint32_t swap_generation = 0; // Swap-chain frame this tile last copied into (see [simple_tiling_utils::swap_chain])
+		std::atomic_uint32_t copy_outs = {}; // Number of completed back-buffer copies; lets [render_frame] block until a tile has actually landed its pixels
+		std::atomic_uint64_t bytes_shaded = {}; // Framebuffer traffic counters, see [simple_tiling_utils::output_stats]
+		std::atomic_uint64_t bytes_copied = {};
+		std::atomic_uint64_t spans_hashed = {}; // Dirty-tracking counters, see [simple_tiling::set_dirty_tracking]
+		std::atomic_uint64_t spans_dirty = {};
+		std::atomic_uint64_t rate_blocks[3] = {}; // Variable-rate shading counters, see [simple_tiling::set_shading_rates]
+		uint32_t first_region = 0; // Canvas regions owned by this tile, see [tile_region]
+		uint32_t num_regions = 0;
+		uint32_t num_spans = 0; // Dirty-tracking spans, summed over every region
+		std::atomic_uint64_t draw_ns = {}; // Time spent in full (non-damage) draw passes since the last adaptive-tiling window, see [rebalance_tiles]
+		std::atomic_uint32_t draw_passes = {};
+		std::atomic_uint64_t last_draw_ns = {}; // Latest full draw pass, the render-scale level it ran at + how much of it went on upscaling;
+		std::atomic_uint32_t last_draw_level = {}; // see [simple_tiling::update_dynamic_resolution]
+		std::atomic_uint64_t last_upscale_ns = {};
+		std::atomic_uint32_t accum_samples = {}; // Samples averaged into this tile's accumulation buffer so far, see [simple_tiling::set_accumulation]
+		uint32_t accum_epoch = 0; // [accumulation_epoch] when the current run started
+		bool accum_hdr = false; // Whether the current run's sums hold HDR colors (linear) or 8bpc ones (0-255)
+		simple_tiling_utils::hdr_draw_job hdr_job = nullptr; // HDR job for the pass in flight, see [shade_tonemapped]
+		const simple_tiling_utils::fused_chain* fused_chain = nullptr; // Fused chain for the pass in flight, see [shade_fused]
+		const simple_tiling_utils::inlined_draw_job* inlined_job = nullptr; // Inlined job for the pass in flight, see [shade_inlined]
+		simple_tiling_utils::span_draw_job span_job = nullptr; // Span job for the pass in flight, see [shade_span]
+		simple_tiling_utils::sample_jitter jitter = {}; // Sample position for the pass in flight, see [simple_tiling::GetSampleJitter]
+		std::atomic_uint32_t history_passes = {}; // Passes this tile has stored in [history_frames]; pass [n] lands in frame (n % 3)
+		std::atomic_uint64_t pixels_reused = {}; // Reprojection counters, see [simple_tiling_utils::output_stats]
+		std::atomic_uint64_t pixels_reshaded = {};
+		std::atomic_uint64_t last_pixels_reused = {};
+		std::atomic_uint64_t last_pixels_reshaded = {};
+		bool post_source_valid = false; // Whether this tile's regions of the unprocessed-frame canvas hold a whole frame yet, see [store_post_source]
+		uint8_t marked_list = 0; // Which of our [pixel_lists] the pass in flight marks into; the other one holds the previous pass' marks
+		uint32_t list_counts[2] = {}; // Pixels on each of our [pixel_lists]
+		std::atomic_uint32_t listed_pixels = {}; // Pixel-list counters, see [simple_tiling_utils::output_stats]
+		std::atomic_uint64_t sparse_pixels = {};
+		std::atomic_uint64_t marks_dropped = {};
+		std::atomic_uint64_t aa_pixels = {}; // Anti-aliasing counter, see [simple_tiling_utils::output_stats]
+		std::thread tile;
+	};
+	data threadData = {};
+
+	XThreadWrapper() {}
+};
+
+XThreadWrapper tile_data[simple_tiling_utils::max_tiles] = {};
+
+// Canvas regions owned by each tile
+// Strip/square layouts give every tile exactly one region (its whole rectangle); Morton layouts deal many small micro-tiles out to each tile
+// instead. Regions are grouped by tile, so tile [i] owns tile_regions[first_region, first_region + num_regions)
+struct tile_region
+{
+	uint32_t minX = 0;
+	uint32_t maxX = 0;
+	uint32_t minY = 0;
+	uint32_t maxY = 0;
+	uint64_t scratch_offset = 0; // Pixel offset of this region's rows within its tile's scratch
+	uint32_t span_offset = 0; // First dirty-tracking span belonging to this region, within its tile
+	uint64_t motion_offset = 0; // First checkerboard motion flag belonging to this region, within its tile (see [resolve_checkerboard])
+	uint64_t rate_offset = 0; // First shading-rate block belonging to this region, within its tile (see [shade_rated])
+};
+
+static constexpr uint32_t max_regions = 16384;
+tile_region tile_regions[max_regions] = {};
+simple_tiling_utils::TILE_LAYOUTS tile_layout = simple_tiling_utils::SQUARE_TILES;
+
+// Morton layouts only; the region (index into [tile_regions]) covering each micro-tile, row-major, so sparse passes can find which region a
+// listed pixel belongs to without searching (see [pixel_region])
+uint32_t micro_tile_px = 0;
+uint32_t micro_tile_cols = 0;
+uint16_t micro_tile_regions[max_regions] = {};
+
+// Scratch rows are padded out to whole batches, so regions ending in a partial batch can still shade full vectors into scratch
+uint32_t region_stride_px(const tile_region& region)
+{
+	return (((region.maxX - region.minX) + NUM_VECTOR_LANES - 1) / NUM_VECTOR_LANES) * NUM_VECTOR_LANES;
+}
+
+// Checkerboard passes shade sixteen-pixel segments of each row per batch, and flag segments whose pixels changed since the last pass
+uint32_t region_segments(const tile_region& region)
+{
+	return ((region.maxX - region.minX) + (NUM_VECTOR_LANES * 2) - 1) / (NUM_VECTOR_LANES * 2);
+}
+
+// Shading-rate blocks are anchored to each region's top-left corner, so every block belongs to exactly one region (and tile)
+uint32_t region_rate_cols(const tile_region& region)
+{
+	return ((region.maxX - region.minX) + simple_tiling_utils::shading_rate_block_px - 1) / simple_tiling_utils::shading_rate_block_px;
+}
+
+uint32_t region_rate_rows(const tile_region& region)
+{
+	return ((region.maxY - region.minY) + simple_tiling_utils::shading_rate_block_px - 1) / simple_tiling_utils::shading_rate_block_px;
+}
+
+uint32_t numTiles = 0;
+uint32_t numTilesX = 0;
+uint32_t numTilesY = 0;
+
+bool interlacing = true;
+
+// Dynamic resolution (see [simple_tiling::set_dynamic_resolution]); tiles only ever read the sharpening strength here, since render-scale levels
+// travel with each draw job
+bool dynamic_resolution = false;
+int32_t upscale_sharpening = 0; // 7-bit fixed-point, 0-32
+
+// Dynamic-resolution controller (see [simple_tiling::update_dynamic_resolution]); only touched by the thread submitting work
+float resolution_budget_ms = 16.0f;
+uint32_t max_render_level = 0;
+
+// Variable-rate shading (see [simple_tiling::set_shading_rates]); read by tiles during every full pass
+simple_tiling_utils::SHADING_RATE_MODES shading_rate_mode = simple_tiling_utils::FULL_RATE_SHADING;
+const uint8_t* shading_rate_map = nullptr;
+uint32_t coarse_contrast_limit = 12;
+
+// Progressive accumulation (see [simple_tiling::set_accumulation]); tiles restart their averages whenever [accumulation_epoch] moves on
+bool accumulating = false;
+uint32_t accumulation_max_samples = 64;
+std::atomic_uint32_t accumulation_epoch = {};
+
+// Temporal reprojection (see [simple_tiling::set_reprojection])
+simple_tiling_utils::reprojection_job reprojection = nullptr;
+
+// Sparse pixel lists (see [simple_tiling::set_pixel_lists])
+bool pixel_lists_enabled = false;
+
+// Adaptive anti-aliasing (see [simple_tiling::set_anti_aliasing]); only changes while tiles are idle
+simple_tiling_utils::ANTI_ALIASING_MODES aa_mode = simple_tiling_utils::AA_OFF;
+simple_tiling_utils::AA_FILTERS aa_filter = simple_tiling_utils::AA_BOX_FILTER;
+uint32_t aa_edge_contrast = 32;
+
+// HDR output (see [simple_tiling::set_tonemapping] + [simple_tiling::set_hdr_buffering]); read by tiles during every HDR pass
+simple_tiling_utils::TONEMAP_OPERATORS tonemap_operator = simple_tiling_utils::TONEMAP_ACES;
+float tonemap_exposure = 1.0f;
+bool tonemap_srgb = true;
+bool tonemap_dither = true;
+simple_tiling_utils::HDR_FORMATS hdr_format = simple_tiling_utils::HDR_UNBUFFERED;
+
+// Post-processing (see [simple_tiling::set_post_processing]); effects are copied in, weights included, and only change while tiles are idle
+simple_tiling_utils::post_effect post_effects[simple_tiling_utils::max_post_effects] = {};
+float post_weights[simple_tiling_utils::max_post_effects][2][(simple_tiling_utils::max_post_halo * 2) + 1] = {};
+uint32_t num_post_effects = 0;
+uint32_t post_halo = 0; // Largest halo over every effect
+uint32_t post_padding = 0; // Border around each of [post_canvases]; [post_halo], plus two batches for vector reads running past the right-hand edge
+std::atomic_uint32_t post_arrivals = {}; // Tiles waiting at the current post-processing barrier, see [post_barrier]
+std::atomic_uint32_t post_generation = {}; // Barriers passed so far; waiters block on this
+uint32_t render_level = 0; // Level new draw work is submitted at
+double native_shading_ms = 0.0; // Smoothed estimate of what shading a frame would cost at native resolution
+double upscale_ms = 0.0; // Latest upscaling cost; roughly the same at every level, since it's per output pixel
+simple_tiling_utils::resolution_stats resolution_stats = {};
+
+// Output targets; see [simple_tiling_utils::OUTPUT_MODES]
+simple_tiling_utils::OUTPUT_MODES output_mode = simple_tiling_utils::TILE_BUFFER_OUTPUT;
+uint32_t* external_output = nullptr;
+uint32_t external_output_stride = 0;
+
+// Dirty tracking; regions are split into spans of [dirty_span_rows] rows, and each span carries a content version that only changes when
+// its pixels do. Swap-chain buffers and the screen remember which version they hold per-span, so copy-outs skip spans the write buffer
+// already has (it's usually three frames old, so comparing against the previous frame alone isn't enough) and presents skip spans the
+// screen already shows
+static constexpr uint32_t dirty_span_rows = 16;
+bool dirty_tracking = false;
+uint32_t spans_per_tile = 0; // Largest span count over every tile (sum over its regions); per-tile arrays below are strided by this
+uint64_t* span_hashes = nullptr; // [tile][span]; hash of the span's last rendered contents
+uint32_t* span_versions = nullptr; // [tile][span]; bumped whenever the hash changes
+uint32_t* buffer_span_versions = nullptr; // [buffer][tile][span]; version held by each swap-chain buffer (zero = never written)
+uint32_t* screen_span_versions = nullptr; // [tile][span]; version last presented, presenter-only
+uint8_t* sparse_spans = nullptr; // [tile][span]; spans the sparse pass in flight wrote to, so only those get hashed (see [shade_sparse])
+static constexpr uint32_t unknown_screen_version = UINT32_MAX; // Screen contents unknown (startup/expose); forces a blit
+
+uint32_t region_num_spans(const tile_region& region)
+{
+	return ((region.maxY - region.minY) + dirty_span_rows - 1) / dirty_span_rows;
+}
+
+uint32_t* held_span_versions(uint32_t buffer_ndx, uint32_t tile_id)
+{
+	return buffer_span_versions + (((static_cast<uint64_t>(buffer_ndx) * simple_tiling_utils::max_tiles) + tile_id) * spans_per_tile);
+}
+
+// Cheap content hash for a block of rows; four interleaved CRC32 streams so we're bound by loads rather than CRC latency
+// Whole batches split evenly into 4 * 64-bit words; edge tiles can end in a partial batch, which we fold in a pixel at a time
+uint64_t hash_rows(const uint32_t* rows, uint32_t width_px, uint32_t num_rows, uint64_t stride_px)
+{
+	uint32_t c0 = 0;
+	uint32_t c1 = 0x9e3779b9;
+	uint32_t c2 = 0x85ebca6b;
+	uint32_t c3 = 0xc2b2ae35;
+	const uint32_t full_px = (width_px / NUM_VECTOR_LANES) * NUM_VECTOR_LANES;
+	const uint32_t row_words = full_px / 2;
+	for (uint32_t y = 0; y < num_rows; y++)
+	{
+		const uint32_t* row = rows + (y * stride_px);
+		const uint64_t* words = reinterpret_cast<const uint64_t*>(row);
+		for (uint32_t w = 0; w < row_words; w += 4)
+		{
+			c0 = static_cast<uint32_t>(_mm_crc32_u64(c0, words[w]));
+			c1 = static_cast<uint32_t>(_mm_crc32_u64(c1, words[w + 1]));
+			c2 = static_cast<uint32_t>(_mm_crc32_u64(c2, words[w + 2]));
+			c3 = static_cast<uint32_t>(_mm_crc32_u64(c3, words[w + 3]));
+		}
+
+		for (uint32_t x = full_px; x < width_px; x++)
+		{
+			c0 = _mm_crc32_u32(c0, row[x]);
+		}
+	}
+	c0 = _mm_crc32_u32(c0, c2);
+	c1 = _mm_crc32_u32(c1, c3);
+	return (static_cast<uint64_t>(c0) << 32) | c1;
+}
+
+// Hash spans [first_span, end_span) of a freshly-rendered region ([rows] points at its first row), and bump versions for spans that changed
+// Damage-driven passes only hash the spans they touched; everything else can't have changed
+void update_span_versions(uint32_t tile_id, const tile_region& region, const uint32_t* rows, uint64_t stride_px, uint32_t first_span, uint32_t end_span)
+{
+	ZoneScoped;
+	uint64_t* hashes = span_hashes + (static_cast<uint64_t>(tile_id) * spans_per_tile) + region.span_offset;
+	uint32_t* versions = span_versions + (static_cast<uint64_t>(tile_id) * spans_per_tile) + region.span_offset;
+	const uint32_t width_px = region.maxX - region.minX;
+	const uint32_t height_px = region.maxY - region.minY;
+	uint32_t num_dirty = 0;
+	for (uint32_t s = first_span; s < end_span; s++)
+	{
+		const uint32_t span_y = s * dirty_span_rows;
+		const uint64_t hash = hash_rows(rows + (span_y * stride_px), width_px, std::min(dirty_span_rows, height_px - span_y), stride_px);
+		if (hash != hashes[s] || versions[s] == 0)
+		{
+			hashes[s] = hash;
+			versions[s]++;
+			num_dirty++;
+		}
+	}
+
+	XThreadWrapper::data& tileInfo = tile_data[tile_id].threadData;
+	tileInfo.spans_hashed.fetch_add(end_span - first_span, std::memory_order_relaxed);
+	tileInfo.spans_dirty.fetch_add(num_dirty, std::memory_order_relaxed);
+}
+
+// Checkerboard rows; every batch covers one sixteen-pixel segment, and lane [i] shades pixel [first + 2i]
+// Kernels still write eight contiguous colors, so we shade into a scratch batch and spread it over the even lanes of two masked stores
+// (masked on the right as well, so partial batches never touch pixels past [x1] - no padding needed)
+// Each segment's [motion_row] flag records whether any of its shaded pixels changed since the last pass; see [resolve_checkerboard]
+uint64_t shade_checkerboard_row(uint32_t tile_id, simple_tiling_utils::draw_job wrapped_job, uint32_t* out_row, uint8_t* motion_row, uint32_t tileMinX,
+								uint32_t pixel_row, uint32_t x0, uint32_t x1, uint32_t parity)
+{
+	memset(motion_row, 0, ((x1 - x0) + (NUM_VECTOR_LANES * 2) - 1) / (NUM_VECTOR_LANES * 2)); // Segments without a shaded pixel in this row can't change
+	const __m256 lane_offsets = _mm256_setr_ps(0.0f, 2.0f, 4.0f, 6.0f, 8.0f, 10.0f, 12.0f, 14.0f);
+	const __m256i spread_lo = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+	const __m256i spread_hi = _mm256_setr_epi32(4, 4, 5, 5, 6, 6, 7, 7);
+	const __m256i even_lanes = _mm256_setr_epi32(-1, 0, -1, 0, -1, 0, -1, 0);
+	uint64_t num_batches = 0;
+	for (uint32_t pixel_x = x0 + ((x0 + pixel_row + parity) & 1); pixel_x < x1; pixel_x += NUM_VECTOR_LANES * 2)
+	{
+		// Spare lanes repeat the last real pixel, same as full-rate partial batches
+		const uint32_t valid_lanes = std::min(((x1 - pixel_x) + 1) / 2, static_cast<uint32_t>(NUM_VECTOR_LANES));
+		const float init_px = static_cast<float>((pixel_row * canvas_width) + pixel_x);
+		const __m256 px = _mm256_add_ps(_mm256_set1_ps(init_px), _mm256_min_ps(lane_offsets, _mm256_set1_ps(static_cast<float>((valid_lanes - 1) * 2))));
+
+		simple_tiling_utils::color_batch colors;
+		wrapped_job(px, tile_id, &colors);
+
+		const __m256i shaded = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(colors.colors8bpc));
+		const __m256i valid = _mm256_set1_epi32(static_cast<int>(valid_lanes));
+		int* out_ptr = reinterpret_cast<int*>(out_row + (pixel_x - tileMinX));
+		const __m256i mask_lo = _mm256_and_si256(even_lanes, _mm256_cmpgt_epi32(valid, spread_lo));
+		const __m256i colors_lo = _mm256_permutevar8x32_epi32(shaded, spread_lo);
+		__m256i changed = _mm256_and_si256(mask_lo, _mm256_xor_si256(colors_lo, _mm256_maskload_epi32(out_ptr, mask_lo)));
+		_mm256_maskstore_epi32(out_ptr, mask_lo, colors_lo);
+		if (valid_lanes > 4)
+		{
+			const __m256i mask_hi = _mm256_and_si256(even_lanes, _mm256_cmpgt_epi32(valid, spread_hi));
+			const __m256i colors_hi = _mm256_permutevar8x32_epi32(shaded, spread_hi);
+			changed = _mm256_or_si256(changed, _mm256_and_si256(mask_hi, _mm256_xor_si256(colors_hi, _mm256_maskload_epi32(out_ptr + NUM_VECTOR_LANES, mask_hi))));
+			_mm256_maskstore_epi32(out_ptr + NUM_VECTOR_LANES, mask_hi, colors_hi);
+		}
+		motion_row[(pixel_x - x0) / (NUM_VECTOR_LANES * 2)] = !_mm256_testz_si256(changed, changed);
+		num_batches++;
+	}
+	return num_batches;
+}
+
+// Trampoline for inlined jobs (see [simple_tiling::submit_inlined_draw_work]), so passes that choose their own lanes can call them like any
+// other draw job; whole blocks skip this and run the job's own loop (see [shade_block])
+void shade_inlined(__m256 pixels, uint32_t tile_id, simple_tiling_utils::color_batch* colors_out)
+{
+	const simple_tiling_utils::inlined_draw_job* job = tile_data[tile_id].threadData.inlined_job;
+	job->batch_job(job->kernel, pixels, tile_id, colors_out);
+}
+
+// Largest span [shade_span] shades to cover one batch; reduced-resolution passes at the lowest render scale spread their lanes furthest
+static constexpr uint32_t max_span_cover_px = NUM_VECTOR_LANES * simple_tiling_utils::render_scale_steps;
+
+// Trampoline for span jobs (see [simple_tiling::submit_span_draw_work]), for passes that choose their own lanes; whole blocks skip this and
+// go straight to [shade_span_block]
+// Contiguous batches (accumulation, reprojection, most of everything else) shade as an eight-pixel span straight into [colors_out]; lanes
+// spread along a row (coarse shading rates, reduced resolution, partial batches) shade the span covering them, and pick their pixels out of that
+void shade_span(__m256 pixels, uint32_t tile_id, simple_tiling_utils::color_batch* colors_out)
+{
+	const simple_tiling_utils::span_draw_job job = tile_data[tile_id].threadData.span_job;
+	const __m256i px = _mm256_cvtps_epi32(pixels);
+	const __m256i lane_ids = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+	const uint32_t first_px = static_cast<uint32_t>(_mm256_cvtsi256_si32(px));
+	const uint32_t first_x = first_px % canvas_width;
+	const uint32_t first_y = first_px / canvas_width;
+	const __m256i contiguous = _mm256_cmpeq_epi32(px, _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(first_px)), lane_ids));
+	if (_mm256_movemask_epi8(contiguous) == -1 && (first_x + NUM_VECTOR_LANES) <= canvas_width)
+	{
+		job(colors_out->colors8bpc, NUM_VECTOR_LANES, first_x, first_y, NUM_VECTOR_LANES, 1, tile_id);
+		return;
+	}
+
+	alignas(32) uint32_t lane_px[NUM_VECTOR_LANES];
+	_mm256_store_si256(reinterpret_cast<__m256i*>(lane_px), px);
+	uint32_t min_px = lane_px[0];
+	uint32_t max_px = lane_px[0];
+	for (uint32_t i = 1; i < NUM_VECTOR_LANES; i++)
+	{
+		min_px = std::min(min_px, lane_px[i]);
+		max_px = std::max(max_px, lane_px[i]);
+	}
+
+	alignas(32) uint32_t span[max_span_cover_px];
+	const uint32_t cover_px = ((max_px - min_px) + NUM_VECTOR_LANES) & ~(NUM_VECTOR_LANES - 1);
+	if ((min_px / canvas_width) == (max_px / canvas_width) && cover_px <= max_span_cover_px)
+	{
+		job(span, cover_px, min_px % canvas_width, min_px / canvas_width, cover_px, 1, tile_id);
+		for (uint32_t i = 0; i < NUM_VECTOR_LANES; i++)
+		{
+			colors_out->colors8bpc[i] = span[lane_px[i] - min_px];
+		}
+		return;
+	}
+
+	// Lanes spread over rows, or further than we're willing to shade; one span per lane
+	for (uint32_t i = 0; i < NUM_VECTOR_LANES; i++)
+	{
+		job(span, NUM_VECTOR_LANES, lane_px[i] % canvas_width, lane_px[i] / canvas_width, NUM_VECTOR_LANES, 1, tile_id);
+		colors_out->colors8bpc[i] = span[0];
+	}
+}
+
+// Checkerboard rows for span jobs; those shade runs of pixels, so skipping every second pixel would cost as much as shading all of them
+// Instead the checkerboard alternates eight-pixel cells, counted from [x0]; cell [c] of [pixel_row] is shaded when (c + [pixel_row] + [parity])
+// is even, as one span straight out of the kernel. Every sixteen-pixel segment holds exactly one shaded cell per row, so motion flags mean the
+// same thing as [shade_checkerboard_row]'s; cells at the right edge are shaded whole into scratch, and only their real pixels stored
+uint64_t shade_span_checkerboard_row(uint32_t tile_id, simple_tiling_utils::span_draw_job job, uint32_t* out_row, uint8_t* motion_row, uint32_t tileMinX,
+									 uint32_t pixel_row, uint32_t x0, uint32_t x1, uint32_t parity)
+{
+	memset(motion_row, 0, ((x1 - x0) + (NUM_VECTOR_LANES * 2) - 1) / (NUM_VECTOR_LANES * 2));
+	const __m256i lane_ids = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+	uint64_t num_batches = 0;
+	for (uint32_t pixel_x = x0 + (((pixel_row + parity) & 1) * NUM_VECTOR_LANES); pixel_x < x1; pixel_x += NUM_VECTOR_LANES * 2)
+	{
+		alignas(32) uint32_t cell[NUM_VECTOR_LANES];
+		job(cell, NUM_VECTOR_LANES, pixel_x, pixel_row, NUM_VECTOR_LANES, 1, tile_id);
+
+		const uint32_t valid_lanes = std::min(x1 - pixel_x, static_cast<uint32_t>(NUM_VECTOR_LANES));
+		const __m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(valid_lanes)), lane_ids);
+		const __m256i shaded = _mm256_load_si256(reinterpret_cast<const __m256i*>(cell));
+		int* out_ptr = reinterpret_cast<int*>(out_row + (pixel_x - tileMinX));
+		const __m256i changed = _mm256_and_si256(mask, _mm256_xor_si256(shaded, _mm256_maskload_epi32(out_ptr, mask)));
+		_mm256_maskstore_epi32(out_ptr, mask, shaded);
+		motion_row[(pixel_x - x0) / (NUM_VECTOR_LANES * 2)] = !_mm256_testz_si256(changed, changed);
+		num_batches++;
+	}
+	return num_batches;
+}
+
+// Full-rate block for a span job; one call for every whole batch in the block, then (for unpadded output) the partial batch at its right edge
+// shades into a scratch column, and only the real pixels come back out
+uint64_t shade_span_block(simple_tiling_utils::span_draw_job job, const simple_tiling_utils::shade_block_args& block)
+{
+	const uint32_t width_px = block.x1 - block.x0;
+	const uint32_t num_rows = block.y1 - block.y0;
+	const uint32_t batches_per_row = (width_px + NUM_VECTOR_LANES - 1) / NUM_VECTOR_LANES;
+	uint32_t* dst = block.out_origin + (static_cast<uint64_t>(block.y0 - block.origin_y) * block.out_stride) + (block.x0 - block.origin_x);
+	const uint32_t span_px = block.padded_output ? (batches_per_row * NUM_VECTOR_LANES) : (width_px & ~(NUM_VECTOR_LANES - 1));
+	if (span_px > 0)
+	{
+		job(dst, block.out_stride, block.x0, block.y0, span_px, num_rows, block.tile_id);
+	}
+
+	const uint32_t tail_px = width_px - std::min(span_px, width_px);
+	if (tail_px > 0)
+	{
+		static constexpr uint32_t tail_rows = 32;
+		alignas(32) uint32_t tail[tail_rows * NUM_VECTOR_LANES];
+		for (uint32_t row = 0; row < num_rows; row += tail_rows)
+		{
+			const uint32_t rows = std::min(tail_rows, num_rows - row);
+			job(tail, NUM_VECTOR_LANES, block.x0 + span_px, block.y0 + row, NUM_VECTOR_LANES, rows, block.tile_id);
+			for (uint32_t r = 0; r < rows; r++)
+			{
+				memcpy(dst + (static_cast<uint64_t>(row + r) * block.out_stride) + span_px, tail + (r * NUM_VECTOR_LANES), tail_px * sizeof(uint32_t));
+			}
+		}
+	}
+	return static_cast<uint64_t>(batches_per_row) * num_rows;
+}
+
+// Shade a block of pixels within one tile; [out_origin] addresses the tile's top-left pixel, and output rows are [out_stride] pixels apart
+// [x0]/[x1] need to sit on the tile's batch grid; given [checker_motion] (the region's motion flags), only pixels where (x + y + [parity]) is even
+// are shaded, see [shade_checkerboard_row] (or every second eight-pixel cell for span jobs, see [shade_span_checkerboard_row])
+// [padded_output] means every output row has room for a whole batch past [x1] (true for tile scratch, false when shading into the canvas/host memory)
+// Full-rate blocks run [simple_tiling_utils::shade_block_rows]; inlined jobs bring their own copy of it, with the kernel compiled in, and span
+// jobs take the whole block at once (see [shade_span_block])
+uint64_t shade_block(uint32_t tile_id, simple_tiling_utils::draw_job wrapped_job, uint32_t* out_origin, uint32_t out_stride, uint32_t tileMinX, uint32_t tileMinY,
+					 uint32_t x0, uint32_t x1, uint32_t y0, uint32_t y1, uint8_t* checker_motion_flags, uint32_t parity, bool padded_output)
+{
+	if (checker_motion_flags != nullptr)
+	{
+		uint64_t num_batches = 0;
+		for (uint32_t pixel_row = y0; pixel_row < y1; pixel_row++)
+		{
+			uint32_t* out_row = out_origin + (static_cast<uint64_t>(pixel_row - tileMinY) * out_stride);
+			uint8_t* motion_row = checker_motion_flags + (static_cast<uint64_t>(pixel_row - y0) * (((x1 - x0) + (NUM_VECTOR_LANES * 2) - 1) / (NUM_VECTOR_LANES * 2)));
+			num_batches += (wrapped_job == shade_span) ?
+						   shade_span_checkerboard_row(tile_id, tile_data[tile_id].threadData.span_job, out_row, motion_row, tileMinX, pixel_row, x0, x1, parity) :
+						   shade_checkerboard_row(tile_id, wrapped_job, out_row, motion_row, tileMinX, pixel_row, x0, x1, parity);
+		}
+		return num_batches;
+	}
+
+	const simple_tiling_utils::shade_block_args block = { out_origin, out_stride, tileMinX, tileMinY, x0, x1, y0, y1, canvas_width, tile_id, padded_output };
+	if (wrapped_job == shade_inlined)
+	{
+		const simple_tiling_utils::inlined_draw_job* job = tile_data[tile_id].threadData.inlined_job;
+		return job->block_loop(job->kernel, block);
+	}
+	if (wrapped_job == shade_span)
+	{
+		return shade_span_block(tile_data[tile_id].threadData.span_job, block);
+	}
+	return simple_tiling_utils::shade_block_rows(wrapped_job, block);
+}
+
+// Reconstruct one skipped checkerboard pixel from whichever of its four neighbours are inside the region; see [resolve_checkerboard]
+uint32_t reconstruct_pixel(const uint32_t* raw, uint32_t stride, uint32_t w, uint32_t h, uint32_t rx, uint32_t ry)
+{
+	const uint32_t* px = raw + (static_cast<uint64_t>(ry) * stride) + rx;
+	uint32_t neighbours[4];
+	uint32_t num_neighbours = 0;
+	if (rx > 0) neighbours[num_neighbours++] = px[-1];
+	if (rx + 1 < w) neighbours[num_neighbours++] = px[1];
+	if (ry > 0) neighbours[num_neighbours++] = *(px - stride);
+	if (ry + 1 < h) neighbours[num_neighbours++] = *(px + stride);
+	if (num_neighbours == 0)
+	{
+		return *px; // Single-pixel region; history is all we have
+	}
+
+	uint32_t result = 0;
+	for (uint32_t c = 0; c < 32; c += 8)
+	{
+		uint32_t lo = 0xff;
+		uint32_t hi = 0;
+		for (uint32_t n = 0; n < num_neighbours; n++)
+		{
+			const uint32_t v = (neighbours[n] >> c) & 0xff;
+			lo = std::min(lo, v);
+			hi = std::max(hi, v);
+		}
+		result |= std::clamp((*px >> c) & 0xff, lo, hi) << c;
+	}
+	return result;
+}
+
+// Resolve a checkerboarded region from tile scratch ([raw]) into its resolve buffer ([resolved]); both share the region's scratch stride
+// Scratch always holds exactly what kernels produced; pixels shaded this pass are current, and the skipped half ((x + y + [parity]) odd) is
+// exactly one pass old. Where nothing nearby changed ([motion] flags from [shade_checkerboard_row], over the 3x3 block of segments around each
+// pixel) the skipped half is still correct, so it passes straight through and static content keeps full detail. Elsewhere skipped pixels are
+// clamped per-channel to the range of their four freshly-shaded neighbours, so anything that moved can't leave ghosts behind (worst case, a
+// pixel lands somewhere between its neighbours)
+// Reconstruction never feeds back into scratch, so motion flags compare real kernel output against real kernel output, and can't be tripped
+// by the previous pass' clamping
+// [span_cells] resolves span jobs' checkerboards (see [shade_span_checkerboard_row]); skipped cells have no shaded pixels either side within
+// the row, so moving pixels clamp to their vertical neighbours alone (which always belong to shaded cells)
+void resolve_checkerboard(const uint32_t* raw, uint32_t* resolved, const tile_region& region, uint32_t parity, const uint8_t* motion, bool span_cells)
+{
+	ZoneScoped;
+	const uint32_t w = region.maxX - region.minX;
+	const uint32_t h = region.maxY - region.minY;
+	const uint32_t stride = region_stride_px(region);
+	const uint32_t segments = region_segments(region);
+	const uint32_t segment_px = NUM_VECTOR_LANES * 2;
+	auto moving = [&](uint32_t ry, uint32_t x_first, uint32_t x_last)
+	{
+		const uint32_t s0 = (x_first > 0 ? x_first - 1 : 0) / segment_px;
+		const uint32_t s1 = std::min(x_last + 1, w - 1) / segment_px;
+		for (uint32_t y = (ry > 0 ? ry - 1 : 0); y <= std::min(ry + 1, h - 1); y++)
+		{
+			const uint8_t* motion_row = motion + (static_cast<uint64_t>(y) * segments);
+			for (uint32_t s = s0; s <= s1; s++)
+			{
+				if (motion_row[s] != 0)
+				{
+					return true;
+				}
+			}
+		}
+		return false;
+	};
+
+	const __m256i even_lanes = _mm256_setr_epi32(-1, 0, -1, 0, -1, 0, -1, 0);
+	for (uint32_t ry = 0; ry < h; ry++)
+	{
+		const uint32_t* row = raw + (static_cast<uint64_t>(ry) * stride);
+		uint32_t* out_row = resolved + (static_cast<uint64_t>(ry) * stride);
+		memcpy(out_row, row, sizeof(uint32_t) * w);
+
+		if (span_cells)
+		{
+			// First skipped cell in this row
+			for (uint32_t cx = ((region.minY + ry + parity) & 1) ^ 1; (cx * NUM_VECTOR_LANES) < w; cx += 2)
+			{
+				const uint32_t cell_x = cx * NUM_VECTOR_LANES;
+				const uint32_t valid_lanes = std::min(w - cell_x, static_cast<uint32_t>(NUM_VECTOR_LANES));
+				if (h == 1 || !moving(ry, cell_x, cell_x + valid_lanes - 1))
+				{
+					continue;
+				}
+
+				const __m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(valid_lanes)), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+				const int* cell = reinterpret_cast<const int*>(row + cell_x);
+				const __m256i up = _mm256_maskload_epi32((ry > 0) ? cell - stride : cell + stride, mask);
+				const __m256i down = _mm256_maskload_epi32(((ry + 1) < h) ? cell + stride : cell - stride, mask);
+				const __m256i history = _mm256_maskload_epi32(cell, mask);
+				const __m256i result = _mm256_min_epu8(_mm256_max_epu8(history, _mm256_min_epu8(up, down)), _mm256_max_epu8(up, down));
+				_mm256_maskstore_epi32(reinterpret_cast<int*>(out_row + cell_x), mask, result);
+			}
+			continue;
+		}
+
+		// First skipped pixel in this row
+		uint32_t rx = ((region.minX + region.minY + ry + parity) & 1) ^ 1;
+		if (ry > 0 && (ry + 1) < h)
+		{
+			// Interior rows; region edges fall back to the scalar path (they're missing neighbours), everything else runs eight pixels at a time
+			if (rx == 0)
+			{
+				if (moving(ry, 0, 0))
+				{
+					out_row[0] = reconstruct_pixel(raw, stride, w, h, 0, ry);
+				}
+				rx += 2;
+			}
+
+			for (; (rx + NUM_VECTOR_LANES) < w; rx += NUM_VECTOR_LANES)
+			{
+				if (!moving(ry, rx, rx + NUM_VECTOR_LANES - 1))
+				{
+					continue;
+				}
+
+				const __m256i left = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + rx - 1));
+				const __m256i right = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + rx + 1));
+				const __m256i up = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + rx - stride));
+				const __m256i down = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + rx + stride));
+				const __m256i lo = _mm256_min_epu8(_mm256_min_epu8(left, right), _mm256_min_epu8(up, down));
+				const __m256i hi = _mm256_max_epu8(_mm256_max_epu8(left, right), _mm256_max_epu8(up, down));
+				const __m256i history = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + rx));
+				const __m256i result = _mm256_min_epu8(_mm256_max_epu8(history, lo), hi);
+
+				// [rx] is always a skipped pixel, so skipped lanes are the even ones
+				_mm256_maskstore_epi32(reinterpret_cast<int*>(out_row + rx), even_lanes, result);
+			}
+		}
+
+		for (; rx < w; rx += 2)
+		{
+			if (moving(ry, rx, rx))
+			{
+				out_row[rx] = reconstruct_pixel(raw, stride, w, h, rx, ry);
+			}
+		}
+	}
+}
+
+// Rows [y0, y1) of a region shaded at full rate; nothing to reconstruct, so they resolve as-is
+void resolve_rows(const uint32_t* raw, uint32_t* resolved, const tile_region& region, uint32_t y0, uint32_t y1)
+{
+	const uint64_t stride = region_stride_px(region);
+	const uint64_t offs = (y0 - region.minY) * stride;
+	memcpy(resolved + offs, raw + offs, sizeof(uint32_t) * stride * (y1 - y0));
+}
+
+// Where a region's shaded pixels end up in tile-buffer mode, before any post-processing; the resolve buffer with interlacing, scratch otherwise
+const uint32_t* region_unprocessed(uint32_t tile_id, const tile_region& region)
+{
+	return (interlacing ? resolveBuffers[tile_id] : reinterpret_cast<const uint32_t*>(tileBuffers[tile_id])) + region.scratch_offset;
+}
+
+// Where hashing + copy-outs read a region's finished pixels from, in tile-buffer mode; the post-processed output while effects are set,
+// [region_unprocessed] otherwise
+const uint32_t* region_resolved(uint32_t tile_id, const tile_region& region)
+{
+	return (num_post_effects > 0) ? (post_buffers[tile_id] + region.scratch_offset) : region_unprocessed(tile_id, region);
+}
+
+// Dynamic resolution; full passes at [render_level] > 0 shade a coarse grid of samples over the whole canvas, and every region upscales its own
+// pixels from the samples around it (see [shade_upscaled])
+uint32_t render_scale_px(uint32_t native_px, uint32_t render_level)
+{
+	const uint32_t steps = simple_tiling_utils::render_scale_steps;
+	return std::max(static_cast<uint32_t>(((static_cast<uint64_t>(native_px) * (steps - render_level)) + steps - 1) / steps), 1u);
+}
+
+// Regions never need more than (w + 1) * (h + 1) samples below native resolution, plus a sample of halo per side when sharpening; rows have room
+// for a whole batch past the end, and for the extra sample the upscaler's gathers read at the right-hand edge of the canvas
+uint32_t upscale_stride_px(uint32_t region_w)
+{
+	return ((region_w + 5 + NUM_VECTOR_LANES - 1) / NUM_VECTOR_LANES) * NUM_VECTOR_LANES;
+}
+
+// Two cached rows (horizontally upscaled samples, or unsharpened samples while sharpening), padded for batches that straddle either end
+uint32_t upscale_cache_stride_px(uint32_t region_w)
+{
+	return ((region_w + 16 + NUM_VECTOR_LANES - 1) / NUM_VECTOR_LANES) * NUM_VECTOR_LANES;
+}
+
+// Upscaling working memory for one region; samples, then the row cache, then per-column sample offsets + weights
+uint64_t upscale_scratch_px(const tile_region& region)
+{
+	const uint32_t w = region.maxX - region.minX;
+	const uint32_t h = region.maxY - region.minY;
+	return (static_cast<uint64_t>(upscale_stride_px(w)) * (h + 4)) + (static_cast<uint64_t>(upscale_cache_stride_px(w)) * 2) + (static_cast<uint64_t>(region_stride_px(region)) * 2);
+}
+
+// Position of canvas pixel [px] on the sample grid, given [to_samples] = samples per pixel; samples sit at the centres of the pixels they
+// stand in for, so at native resolution this is just [px]
+float sample_coord(uint32_t px, float to_samples)
+{
+	return ((static_cast<float>(px) + 0.5f) * to_samples) - 0.5f;
+}
+
+// Nearest sample at or before [coord] (clamped to the grid), and the 7-bit fixed-point weight (0-128) of the sample after it
+void sample_lerp(float coord, uint32_t num_samples, uint32_t& sample, int32_t& weight)
+{
+	const float base = std::floor(coord);
+	if (base < 0.0f || base >= static_cast<float>(num_samples - 1))
+	{
+		sample = base < 0.0f ? 0 : num_samples - 1; // Past the outermost sample centres; clamp to the edge
+		weight = 0;
+		return;
+	}
+	sample = static_cast<uint32_t>(base);
+	weight = static_cast<int32_t>(std::lround((coord - base) * 128.0f));
+}
+
+// Even + odd 8bpc channels of a batch, split out into 16-bit lanes (so channel arithmetic has room to go negative/past 255)
+void split_channels(__m256i colors, __m256i& even, __m256i& odd)
+{
+	const __m256i channel_mask = _mm256_set1_epi32(0x00ff00ff);
+	even = _mm256_and_si256(colors, channel_mask);
+	odd = _mm256_and_si256(_mm256_srli_epi32(colors, 8), channel_mask);
+}
+
+// Per-channel lerp between two batches of 8bpc colors; [weight] holds 7-bit fixed-point weights, duplicated into both 16-bit halves of each lane
+__m256i lerp_8bpc(__m256i a, __m256i b, __m256i weight)
+{
+	__m256i a_even, a_odd, b_even, b_odd;
+	split_channels(a, a_even, a_odd);
+	split_channels(b, b_even, b_odd);
+	const __m256i even = _mm256_add_epi16(a_even, _mm256_srai_epi16(_mm256_mullo_epi16(_mm256_sub_epi16(b_even, a_even), weight), 7));
+	const __m256i odd = _mm256_add_epi16(a_odd, _mm256_srai_epi16(_mm256_mullo_epi16(_mm256_sub_epi16(b_odd, a_odd), weight), 7));
+	return _mm256_or_si256(even, _mm256_slli_epi16(odd, 8));
+}
+
+// Per-channel unsharp mask; [centre] plus [strength] (7-bit fixed-point, 0-32) times four times its difference from its neighbours' average
+__m256i sharpen_8bpc(__m256i centre, __m256i left, __m256i right, __m256i up, __m256i down, __m256i strength)
+{
+	__m256i c[2], l[2], r[2], u[2], d[2];
+	split_channels(centre, c[0], c[1]);
+	split_channels(left, l[0], l[1]);
+	split_channels(right, r[0], r[1]);
+	split_channels(up, u[0], u[1]);
+	split_channels(down, d[0], d[1]);
+
+	__m256i sharpened[2];
+	for (uint32_t i = 0; i < 2; i++)
+	{
+		const __m256i neighbours = _mm256_add_epi16(_mm256_add_epi16(l[i], r[i]), _mm256_add_epi16(u[i], d[i]));
+		const __m256i detail = _mm256_sub_epi16(_mm256_slli_epi16(c[i], 2), neighbours); // Within +-1020, so (detail * 32) still fits in 16 bits
+		const __m256i result = _mm256_add_epi16(c[i], _mm256_srai_epi16(_mm256_mullo_epi16(detail, strength), 7));
+		sharpened[i] = _mm256_min_epi16(_mm256_max_epi16(result, _mm256_setzero_si256()), _mm256_set1_epi16(255));
+	}
+	return _mm256_or_si256(sharpened[0], _mm256_slli_epi16(sharpened[1], 8));
+}
+
+// Sharpen sample rows [r0, r1] + columns [c0, c1] (relative to [samples]) in place; everything around them is halo, either shaded for us or (at the
+// edges of the canvas) missing, in which case samples stand in for their own neighbours. [tmp] holds two rows of [upscale_cache_stride_px]
+// Sharpening reads unsharpened neighbours, so each row is saved to [tmp] (padded by a sample on either side) before it's overwritten
+void sharpen_samples(uint32_t* samples, uint32_t stride, uint32_t num_cols, uint32_t num_rows, uint32_t r0, uint32_t r1, uint32_t c0, uint32_t c1,
+					 uint32_t* tmp, uint32_t tmp_stride, int32_t sharpening)
+{
+	ZoneScoped;
+	const __m256i strength = _mm256_set1_epi16(static_cast<int16_t>(sharpening));
+	const __m256i lane_ids = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+	for (uint32_t r = r0; r <= r1; r++)
+	{
+		uint32_t* row = samples + (static_cast<uint64_t>(r) * stride);
+		uint32_t* saved = tmp + (static_cast<uint64_t>(r & 1) * tmp_stride);
+		saved[0] = row[0];
+		memcpy(saved + 1, row, sizeof(uint32_t) * num_cols);
+		saved[num_cols + 1] = row[num_cols - 1];
+
+		const uint32_t* up = (r == 0) ? saved + 1 : (r > r0 ? tmp + (static_cast<uint64_t>((r - 1) & 1) * tmp_stride) + 1 : row - stride);
+		const uint32_t* down = (r + 1 < num_rows) ? row + stride : saved + 1;
+		for (uint32_t c = c0; c <= c1; c += NUM_VECTOR_LANES)
+		{
+			const __m256i result = sharpen_8bpc(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(saved + 1 + c)),
+												_mm256_loadu_si256(reinterpret_cast<const __m256i*>(saved + c)),
+												_mm256_loadu_si256(reinterpret_cast<const __m256i*>(saved + 2 + c)),
+												_mm256_loadu_si256(reinterpret_cast<const __m256i*>(up + c)),
+												_mm256_loadu_si256(reinterpret_cast<const __m256i*>(down + c)), strength);
+
+			// Mask off anything past [c1]; that's halo the next row still needs unsharpened
+			const __m256i lane_mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>((c1 - c) + 1)), lane_ids);
+			_mm256_maskstore_epi32(reinterpret_cast<int*>(row + c), lane_mask, result);
+		}
+	}
+}
+
+// Dynamic-resolution pass over one region; shade the samples covering it into [upscale_scratch], sharpen them (optionally), then upscale them
+// into the region's output with a bilinear filter
+// Samples are laid out over the whole canvas, and each region shades every sample it needs, including the ones just past its edges; neighbouring
+// regions shade those too, but they land on exactly the same pixels (so the same colors), which keeps tile boundaries seamless without any
+// cross-tile synchronization. Upscaling runs a row at a time; each sample row is filtered horizontally once (gathering the two samples either
+// side of every pixel), cached, then blended vertically into every output row between it and the next one
+// Returns the number of batches shaded, and adds the time spent upscaling (rather than shading) to [upscale_ns]
+uint64_t shade_upscaled(uint32_t tile_id, simple_tiling_utils::draw_job wrapped_job, const tile_region& region, uint32_t render_level,
+						uint32_t* out_origin, uint32_t out_stride, bool padded_output, uint64_t& upscale_ns)
+{
+	ZoneScoped;
+	const uint32_t w = region.maxX - region.minX;
+	const uint32_t h = region.maxY - region.minY;
+	const uint32_t samples_x = render_scale_px(canvas_width, render_level);
+	const uint32_t samples_y = render_scale_px(canvas_height, render_level);
+	const float to_samples_x = static_cast<float>(samples_x) / static_cast<float>(canvas_width);
+	const float to_samples_y = static_cast<float>(samples_y) / static_cast<float>(canvas_height);
+
+	// Samples covering the region; the last one past its right/bottom edges is always needed, since pixels blend towards it
+	uint32_t core_x0, core_x1, core_y0, core_y1;
+	int32_t unused_weight;
+	sample_lerp(sample_coord(region.minX, to_samples_x), samples_x, core_x0, unused_weight);
+	sample_lerp(sample_coord(region.maxX - 1, to_samples_x), samples_x, core_x1, unused_weight);
+	sample_lerp(sample_coord(region.minY, to_samples_y), samples_y, core_y0, unused_weight);
+	sample_lerp(sample_coord(region.maxY - 1, to_samples_y), samples_y, core_y1, unused_weight);
+	core_x1 = std::min(core_x1 + 1, samples_x - 1);
+	core_y1 = std::min(core_y1 + 1, samples_y - 1);
+
+	// Sharpening reads a sample past the core on every side
+	const int32_t sharpening = upscale_sharpening;
+	const uint32_t halo = (sharpening > 0) ? 1 : 0;
+	const uint32_t x0 = core_x0 - std::min(core_x0, halo);
+	const uint32_t x1 = std::min(core_x1 + halo, samples_x - 1);
+	const uint32_t y0 = core_y0 - std::min(core_y0, halo);
+	const uint32_t y1 = std::min(core_y1 + halo, samples_y - 1);
+	const uint32_t num_cols = (x1 - x0) + 1;
+	const uint32_t num_rows = (y1 - y0) + 1;
+
+	const uint32_t stride = upscale_stride_px(w);
+	const uint32_t cache_stride = upscale_cache_stride_px(w);
+	const uint32_t lut_stride = region_stride_px(region);
+	uint32_t* samples = upscale_scratch[tile_id];
+	uint32_t* row_cache = samples + (static_cast<uint64_t>(stride) * (h + 4));
+	int32_t* col_samples = reinterpret_cast<int32_t*>(row_cache + (static_cast<uint64_t>(cache_stride) * 2));
+	int32_t* col_weights = col_samples + lut_stride;
+
+	// Shade samples; lane [i] gets whichever pixel sample (x + i) sits on, so kernels still see canvas indices
+	const __m256 lane_offsets = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+	const __m256 to_pixels_x = _mm256_set1_ps(static_cast<float>(canvas_width) / static_cast<float>(samples_x));
+	const __m256 max_x = _mm256_set1_ps(static_cast<float>(canvas_width - 1));
+	const __m256 half = _mm256_set1_ps(0.5f);
+	const float to_pixels_y = static_cast<float>(canvas_height) / static_cast<float>(samples_y);
+	uint64_t num_batches = 0;
+	for (uint32_t sy = y0; sy <= y1; sy++)
+	{
+		const float pixel_y = std::clamp(std::nearbyint(((static_cast<float>(sy) + 0.5f) * to_pixels_y) - 0.5f), 0.0f, static_cast<float>(canvas_height - 1));
+		const __m256 row_px = _mm256_set1_ps(pixel_y * static_cast<float>(canvas_width));
+		simple_tiling_utils::color_batch* sample_row = reinterpret_cast<simple_tiling_utils::color_batch*>(samples + (static_cast<uint64_t>(sy - y0) * stride));
+		for (uint32_t sx = x0; sx <= x1; sx += NUM_VECTOR_LANES)
+		{
+			// Spare lanes in the last batch repeat its last sample, same as partial batches at native resolution
+			const __m256 lanes = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(sx)), _mm256_min_ps(lane_offsets, _mm256_set1_ps(static_cast<float>(x1 - sx))));
+			__m256 pixel_x = _mm256_sub_ps(_mm256_mul_ps(_mm256_add_ps(lanes, half), to_pixels_x), half);
+			pixel_x = _mm256_min_ps(_mm256_max_ps(_mm256_round_ps(pixel_x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC), _mm256_setzero_ps()), max_x);
+			wrapped_job(_mm256_add_ps(row_px, pixel_x), tile_id, reinterpret_cast<simple_tiling_utils::color_batch*>(reinterpret_cast<uint32_t*>(sample_row) + (sx - x0)));
+			num_batches++;
+		}
+	}
+
+	const auto upscale_start_t = std::chrono::steady_clock::now();
+	if (sharpening > 0)
+	{
+		sharpen_samples(samples, stride, num_cols, num_rows, core_y0 - y0, core_y1 - y0, core_x0 - x0, core_x1 - x0, row_cache, cache_stride, sharpening);
+	}
+
+	// Every row filters the same columns, so resolve each column's samples + weights once
+	for (uint32_t x = 0; x < lut_stride; x++)
+	{
+		uint32_t sample = 0;
+		int32_t weight = 0;
+		sample_lerp(sample_coord(region.minX + std::min(x, w - 1), to_samples_x), samples_x, sample, weight);
+		col_samples[x] = static_cast<int32_t>(sample - x0);
+		col_weights[x] = weight | (weight << 16);
+	}
+
+	// Horizontally filtered sample rows, cached by parity; vertically adjacent samples never share a slot
+	int64_t cached_rows[2] = { -1, -1 };
+	auto filtered_row = [&](uint32_t sy)
+	{
+		uint32_t* cached = row_cache + (static_cast<uint64_t>(sy & 1) * cache_stride);
+		if (cached_rows[sy & 1] != sy)
+		{
+			const int* sample_row = reinterpret_cast<const int*>(samples + (static_cast<uint64_t>(sy - y0) * stride));
+			for (uint32_t x = 0; x < w; x += NUM_VECTOR_LANES)
+			{
+				const __m256i offsets = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(col_samples + x));
+				const __m256i weights = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(col_weights + x));
+				const __m256i left = _mm256_i32gather_epi32(sample_row, offsets, 4);
+				const __m256i right = _mm256_i32gather_epi32(sample_row + 1, offsets, 4); // Zero-weighted (but still in bounds) at the canvas' right edge
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(cached + x), lerp_8bpc(left, right, weights));
+			}
+			cached_rows[sy & 1] = sy;
+		}
+		return cached;
+	};
+
+	const __m256i lane_ids = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+	for (uint32_t y = region.minY; y < region.maxY; y++)
+	{
+		uint32_t sy = 0;
+		int32_t weight = 0;
+		sample_lerp(sample_coord(y, to_samples_y), samples_y, sy, weight);
+		const uint32_t* upper = filtered_row(sy);
+		const uint32_t* lower = weight > 0 ? filtered_row(sy + 1) : upper;
+		const __m256i weights = _mm256_set1_epi32(weight | (weight << 16));
+		uint32_t* out_row = out_origin + (static_cast<uint64_t>(y - region.minY) * out_stride);
+		for (uint32_t x = 0; x < w; x += NUM_VECTOR_LANES)
+		{
+			const __m256i blended = lerp_8bpc(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(upper + x)),
+											  _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lower + x)), weights);
+			if (padded_output || (x + NUM_VECTOR_LANES) <= w)
+			{
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(out_row + x), blended);
+			}
+			else
+			{
+				const __m256i lane_mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(w - x)), lane_ids);
+				_mm256_maskstore_epi32(reinterpret_cast<int*>(out_row + x), lane_mask, blended);
+			}
+		}
+	}
+	upscale_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - upscale_start_t).count();
+	return num_batches;
+}
+
+// Largest per-channel (RGB) range over [w]x[h] pixels of output; see [shade_rated]
+uint32_t block_contrast(const uint32_t* out_row, uint32_t out_stride, uint32_t w, uint32_t h)
+{
+	uint32_t lo = 0xffffffff;
+	uint32_t hi = 0;
+	if (w == NUM_VECTOR_LANES)
+	{
+		// Whole block rows fit a vector; track channel bounds per-lane, then fold the lanes together
+		__m256i lo_px = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(out_row));
+		__m256i hi_px = lo_px;
+		for (uint32_t y = 1; y < h; y++)
+		{
+			const __m256i px = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(out_row + (static_cast<uint64_t>(y) * out_stride)));
+			lo_px = _mm256_min_epu8(lo_px, px);
+			hi_px = _mm256_max_epu8(hi_px, px);
+		}
+		__m128i lo_fold = _mm_min_epu8(_mm256_castsi256_si128(lo_px), _mm256_extracti128_si256(lo_px, 1));
+		__m128i hi_fold = _mm_max_epu8(_mm256_castsi256_si128(hi_px), _mm256_extracti128_si256(hi_px, 1));
+		lo_fold = _mm_min_epu8(lo_fold, _mm_srli_si128(lo_fold, 8));
+		hi_fold = _mm_max_epu8(hi_fold, _mm_srli_si128(hi_fold, 8));
+		lo_fold = _mm_min_epu8(lo_fold, _mm_srli_si128(lo_fold, 4));
+		hi_fold = _mm_max_epu8(hi_fold, _mm_srli_si128(hi_fold, 4));
+		lo = static_cast<uint32_t>(_mm_cvtsi128_si32(lo_fold));
+		hi = static_cast<uint32_t>(_mm_cvtsi128_si32(hi_fold));
+	}
+	else
+	{
+		// Partial blocks at region edges
+		for (uint32_t y = 0; y < h; y++)
+		{
+			for (uint32_t x = 0; x < w; x++)
+			{
+				const uint32_t px = out_row[(static_cast<uint64_t>(y) * out_stride) + x];
+				for (uint32_t c = 0; c < 24; c += 8)
+				{
+					const uint32_t channel_mask = 0xffu << c;
+					lo = (lo & ~channel_mask) | std::min(lo & channel_mask, px & channel_mask);
+					hi = (hi & ~channel_mask) | std::max(hi & channel_mask, px & channel_mask);
+				}
+			}
+		}
+	}
+
+	uint32_t contrast = 0;
+	for (uint32_t c = 0; c < 24; c += 8)
+	{
+		contrast = std::max(contrast, ((hi >> c) & 0xff) - ((lo >> c) & 0xff));
+	}
+	return contrast;
+}
+
+// Variable-rate pass over one region (see [simple_tiling::set_shading_rates]); works through a band of [shading_rate_block_px] rows at a time,
+// shading runs of full-rate blocks with [shade_block], and coarse blocks one sample per 2x2/4x4 cell (copied over the whole cell)
+// Adaptive rates are measured straight back out of the output once each band is shaded, and picked up by the next pass
+// [refresh_phase] picks which coarse blocks re-shade at full rate this pass; [rate_blocks] counts blocks shaded at each [SHADING_RATES]
+uint64_t shade_rated(uint32_t tile_id, simple_tiling_utils::draw_job wrapped_job, const tile_region& region, uint32_t* out_origin, uint32_t out_stride,
+					 bool padded_output, uint32_t refresh_phase, uint64_t* rate_blocks)
+{
+	ZoneScoped;
+	constexpr uint32_t block_px = simple_tiling_utils::shading_rate_block_px;
+	const bool adaptive = (shading_rate_mode == simple_tiling_utils::ADAPTIVE_RATE_SHADING);
+	const uint32_t cols = region_rate_cols(region);
+	const uint32_t rows = region_rate_rows(region);
+	const uint32_t map_cols = (canvas_width + block_px - 1) / block_px;
+	uint8_t* rates = shading_rates[tile_id] + region.rate_offset;
+	const __m256i lane_ids = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+	uint64_t num_batches = 0;
+
+	auto block_rate = [&](uint32_t bx, uint32_t by, uint32_t x0, uint32_t x1, uint32_t y0, uint32_t y1) -> uint32_t
+	{
+		if (adaptive)
+		{
+			// Coarse blocks never see detail between their samples, so they take turns re-shading in full (diagonally, one in eight per pass)
+			return (((bx + by + refresh_phase) % 8) == 0) ? static_cast<uint32_t>(simple_tiling_utils::RATE_1X1) : rates[(static_cast<uint64_t>(by) * cols) + bx];
+		}
+
+		// Host maps are laid out over the canvas instead, so blocks in regions off the canvas' block grid straddle up to four entries
+		uint32_t rate = simple_tiling_utils::RATE_4X4;
+		for (uint32_t my = y0 / block_px; my <= (y1 - 1) / block_px; my++)
+		{
+			for (uint32_t mx = x0 / block_px; mx <= (x1 - 1) / block_px; mx++)
+			{
+				rate = std::min(rate, static_cast<uint32_t>(shading_rate_map[(static_cast<uint64_t>(my) * map_cols) + mx]));
+			}
+		}
+		return rate;
+	};
+
+	// Shade one sample per cell, at (roughly) its centre, then copy each sample over its cell; cells cut off by the block's edges keep their
+	// samples inside the block. Spare lanes repeat the last sample, same as partial batches at full rate
+	auto shade_coarse = [&](uint32_t x0, uint32_t x1, uint32_t y0, uint32_t y1, uint32_t rate)
+	{
+		const uint32_t shift = rate; // RATE_2X2 -> 2px cells, RATE_4X4 -> 4px cells
+		const uint32_t cell_px = 1u << shift;
+		const uint32_t cells_x = ((x1 - x0) + cell_px - 1) >> shift;
+		const uint32_t num_cells = cells_x * (((y1 - y0) + cell_px - 1) >> shift);
+		alignas(32) uint32_t cell_colors[((block_px / 2) * (block_px / 2)) + NUM_VECTOR_LANES] = {};
+		alignas(32) float sample_px[NUM_VECTOR_LANES];
+		for (uint32_t c = 0; c < num_cells; c += NUM_VECTOR_LANES)
+		{
+			for (uint32_t i = 0; i < NUM_VECTOR_LANES; i++)
+			{
+				const uint32_t cell = std::min(c + i, num_cells - 1);
+				const uint32_t px_x = std::min(x0 + ((cell % cells_x) << shift) + (cell_px / 2), x1 - 1);
+				const uint32_t px_y = std::min(y0 + ((cell / cells_x) << shift) + (cell_px / 2), y1 - 1);
+				sample_px[i] = static_cast<float>((px_y * canvas_width) + px_x);
+			}
+			wrapped_job(_mm256_load_ps(sample_px), tile_id, reinterpret_cast<simple_tiling_utils::color_batch*>(cell_colors + c));
+			num_batches++;
+		}
+
+		const __m256i cell_lanes = _mm256_srli_epi32(lane_ids, static_cast<int>(shift));
+		const uint32_t w = x1 - x0;
+		const __m256i lane_mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(w)), lane_ids);
+		for (uint32_t y = y0; y < y1; y++)
+		{
+			const __m256i cells = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cell_colors + (((y - y0) >> shift) * cells_x)));
+			const __m256i px = _mm256_permutevar8x32_epi32(cells, cell_lanes);
+			uint32_t* out_px = out_origin + (static_cast<uint64_t>(y - region.minY) * out_stride) + (x0 - region.minX);
+			if (padded_output || w == NUM_VECTOR_LANES)
+			{
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(out_px), px);
+			}
+			else
+			{
+				_mm256_maskstore_epi32(reinterpret_cast<int*>(out_px), lane_mask, px);
+			}
+		}
+	};
+
+	for (uint32_t by = 0; by < rows; by++)
+	{
+		const uint32_t y0 = region.minY + (by * block_px);
+		const uint32_t y1 = std::min(y0 + block_px, region.maxY);
+
+		// Neighbouring full-rate blocks shade together, so mostly-full-rate bands still run through the plain batch loop
+		uint32_t run_x0 = region.maxX;
+		for (uint32_t bx = 0; bx < cols; bx++)
+		{
+			const uint32_t x0 = region.minX + (bx * block_px);
+			const uint32_t x1 = std::min(x0 + block_px, region.maxX);
+			const uint32_t rate = block_rate(bx, by, x0, x1, y0, y1);
+			rate_blocks[rate]++;
+			if (rate == simple_tiling_utils::RATE_1X1)
+			{
+				run_x0 = std::min(run_x0, x0);
+				continue;
+			}
+
+			if (run_x0 < x0)
+			{
+				num_batches += shade_block(tile_id, wrapped_job, out_origin, out_stride, region.minX, region.minY, run_x0, x0, y0, y1, nullptr, 0, padded_output);
+				run_x0 = region.maxX;
+			}
+			shade_coarse(x0, x1, y0, y1, rate);
+		}
+
+		if (run_x0 < region.maxX)
+		{
+			num_batches += shade_block(tile_id, wrapped_job, out_origin, out_stride, region.minX, region.minY, run_x0, region.maxX, y0, y1, nullptr, 0, padded_output);
+		}
+
+		// Flat blocks drop to 2x2 cells, very flat ones to 4x4
+		if (adaptive)
+		{
+			const uint32_t* out_row = out_origin + (static_cast<uint64_t>(y0 - region.minY) * out_stride);
+			for (uint32_t bx = 0; bx < cols; bx++)
+			{
+				const uint32_t x0 = bx * block_px;
+				const uint32_t contrast = block_contrast(out_row + x0, out_stride, std::min(block_px, (region.maxX - region.minX) - x0), y1 - y0);
+				rates[(static_cast<uint64_t>(by) * cols) + bx] = (contrast <= (coarse_contrast_limit / 2)) ? simple_tiling_utils::RATE_4X4 :
+																  (contrast <= coarse_contrast_limit) ? simple_tiling_utils::RATE_2X2 : simple_tiling_utils::RATE_1X1;
+			}
+		}
+	}
+	return num_batches;
+}
+
+// HDR output (see [simple_tiling::set_tonemapping]); exposure, tonemap + sRGB-encode one channel of a batch, from linear color to [0, 1]
+__m256 tonemap_channel(__m256 linear)
+{
+	const __m256 one = _mm256_set1_ps(1.0f);
+	__m256 c = _mm256_max_ps(_mm256_mul_ps(linear, _mm256_set1_ps(tonemap_exposure)), _mm256_setzero_ps()); // Negative (and NaN) channels go to black
+	switch (tonemap_operator)
+	{
+		// Curves divide by reciprocal approximation; 12 bits is a small fraction of an 8-bit step, and far cheaper than a real divide
+		case simple_tiling_utils::TONEMAP_REINHARD:
+			c = _mm256_mul_ps(c, _mm256_rcp_ps(_mm256_add_ps(c, one)));
+			break;
+		case simple_tiling_utils::TONEMAP_ACES:
+			// (x * (2.51x + 0.03)) / (x * (2.43x + 0.59) + 0.14); slightly past 1.0 for very bright input, so it still needs clamping below
+			c = _mm256_mul_ps(_mm256_mul_ps(c, _mm256_fmadd_ps(c, _mm256_set1_ps(2.51f), _mm256_set1_ps(0.03f))),
+							  _mm256_rcp_ps(_mm256_fmadd_ps(c, _mm256_fmadd_ps(c, _mm256_set1_ps(2.43f), _mm256_set1_ps(0.59f)), _mm256_set1_ps(0.14f))));
+			break;
+		default:
+			break;
+	}
+	c = _mm256_min_ps(c, one); // Also catches inf / inf from infinite input, since min returns its second operand for NaNs
+
+	if (tonemap_srgb)
+	{
+		// sRGB's power curve, fit from three square roots (within about a quarter of an 8-bit step everywhere), and its linear segment near
+		// black. Roots come from reciprocal square roots (x * rsqrt(x)), which barely move the error but skip three slow, dependent sqrts;
+		// they're NaN at zero, but zero sits on the linear segment anyway
+		const __m256 s1 = _mm256_mul_ps(c, _mm256_rsqrt_ps(c));
+		const __m256 s2 = _mm256_mul_ps(s1, _mm256_rsqrt_ps(s1));
+		const __m256 s3 = _mm256_mul_ps(s2, _mm256_rsqrt_ps(s2));
+		__m256 curve = _mm256_mul_ps(c, _mm256_set1_ps(-0.0225411470f));
+		curve = _mm256_fmadd_ps(s1, _mm256_set1_ps(0.662002687f), curve);
+		curve = _mm256_fmadd_ps(s2, _mm256_set1_ps(0.684122060f), curve);
+		curve = _mm256_fmadd_ps(s3, _mm256_set1_ps(-0.323583601f), curve);
+		const __m256 linear_segment = _mm256_cmp_ps(c, _mm256_set1_ps(0.0031308f), _CMP_LT_OQ);
+		c = _mm256_min_ps(_mm256_blendv_ps(curve, _mm256_mul_ps(c, _mm256_set1_ps(12.92f)), linear_segment), one);
+	}
+	return c;
+}
+
+// Tonemap + quantize a batch of HDR colors to 8bpc; [pixels] (the batch's pixel indices) seed the dither pattern
+__m256i tonemap_batch(__m256 red, __m256 green, __m256 blue, __m256 pixels)
+{
+	__m256 offset = _mm256_set1_ps(0.5f); // Round to nearest, without dithering
+	if (tonemap_dither)
+	{
+		// Hash each pixel's index, and take 24 bits of the result as an offset in [0, 1); white noise, but fixed per pixel
+		__m256i hash = _mm256_mullo_epi32(_mm256_cvttps_epi32(pixels), _mm256_set1_epi32(static_cast<int>(0x9e3779b1)));
+		hash = _mm256_xor_si256(hash, _mm256_srli_epi32(hash, 15));
+		hash = _mm256_mullo_epi32(hash, _mm256_set1_epi32(static_cast<int>(0x85ebca77)));
+		offset = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(hash, 8)), _mm256_set1_ps(1.0f / 16777216.0f));
+	}
+
+	// Offsets just under one can still round 255.x up to 256 in float, hence the clamp
+	const __m256 scale = _mm256_set1_ps(255.0f);
+	const __m256i max_channel = _mm256_set1_epi32(255);
+	const __m256i r = _mm256_min_epi32(_mm256_cvttps_epi32(_mm256_fmadd_ps(tonemap_channel(red), scale, offset)), max_channel);
+	const __m256i g = _mm256_min_epi32(_mm256_cvttps_epi32(_mm256_fmadd_ps(tonemap_channel(green), scale, offset)), max_channel);
+	const __m256i b = _mm256_min_epi32(_mm256_cvttps_epi32(_mm256_fmadd_ps(tonemap_channel(blue), scale, offset)), max_channel);
+	return _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(r, 16), _mm256_slli_epi32(g, 8)), b);
+}
+
+// Unbuffered HDR passes run this in place of their draw job, so every shading path handles them without knowing the difference
+void shade_tonemapped(__m256 pixels, uint32_t tile_id, simple_tiling_utils::color_batch* colors_out)
+{
+	simple_tiling_utils::hdr_color_batch hdr_colors;
+	tile_data[tile_id].threadData.hdr_job(pixels, tile_id, &hdr_colors);
+	const __m256i colors = tonemap_batch(_mm256_loadu_ps(hdr_colors.red), _mm256_loadu_ps(hdr_colors.green), _mm256_loadu_ps(hdr_colors.blue), pixels);
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(colors_out->colors8bpc), colors);
+}
+
+// Bytes per channel of [hdr_buffers]; zero without buffering
+uint32_t hdr_channel_bytes()
+{
+	switch (hdr_format)
+	{
+		case simple_tiling_utils::HDR_FLOAT16:
+			return sizeof(uint16_t);
+		case simple_tiling_utils::HDR_FLOAT32:
+			return sizeof(float);
+		default:
+			return 0;
+	}
+}
+
+// Run every stage of a fused chain over one batch (see [simple_tiling::submit_fused_draw_work]); colors only ever move between stages as
+// vectors, never through tile memory
+simple_tiling_utils::color_vectors run_fused_chain(const simple_tiling_utils::fused_chain& chain, __m256 pixels, uint32_t tile_id)
+{
+	simple_tiling_utils::color_vectors colors = { _mm256_setzero_ps(), _mm256_setzero_ps(), _mm256_setzero_ps() };
+	for (uint32_t s = 0; s < chain.num_stages; s++)
+	{
+		colors = chain.stages[s](pixels, tile_id, colors);
+	}
+	return colors;
+}
+
+// Trampoline for 8bpc fused chains, so they work anywhere a plain draw job does
+void shade_fused(__m256 pixels, uint32_t tile_id, simple_tiling_utils::color_batch* colors_out)
+{
+	simple_tiling_utils::store_display_colors(run_fused_chain(*tile_data[tile_id].threadData.fused_chain, pixels, tile_id), colors_out);
+}
+
+// Trampoline for HDR fused chains, so they tonemap, buffer + accumulate like any other HDR job
+void shade_fused_hdr(__m256 pixels, uint32_t tile_id, simple_tiling_utils::hdr_color_batch* colors_out)
+{
+	const simple_tiling_utils::color_vectors colors = run_fused_chain(*tile_data[tile_id].threadData.fused_chain, pixels, tile_id);
+	_mm256_storeu_ps(colors_out->red, colors.red);
+	_mm256_storeu_ps(colors_out->green, colors.green);
+	_mm256_storeu_ps(colors_out->blue, colors.blue);
+}
+
+// Buffered HDR pass over [x0, x1) * [y0, y1) of a region (see [simple_tiling::set_hdr_buffering]); shade each row into the tile's HDR buffer,
+// then resolve it into the output while it's still in cache. [x0]/[x1] need to sit on the region's batch grid
+// HDR buffers follow the tile-scratch batch layout, with each batch stored as three planes of eight half-floats or floats (red, green, blue);
+// scratch rows are padded out to whole batches, so partial batches store whole vectors as well
+uint64_t shade_hdr_block(uint32_t tile_id, simple_tiling_utils::hdr_draw_job hdr_job, const tile_region& region, uint32_t* out_origin, uint32_t out_stride,
+						 bool padded_output, uint32_t x0, uint32_t x1, uint32_t y0, uint32_t y1)
+{
+	ZoneScoped;
+	const __m256 lane_offsets = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+	const __m256i lane_ids = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+	const bool half_floats = (hdr_format == simple_tiling_utils::HDR_FLOAT16);
+	const uint32_t batch_bytes = NUM_VECTOR_LANES * 3 * hdr_channel_bytes();
+	const uint32_t plane_bytes = batch_bytes / 3;
+	const uint64_t row_bytes = static_cast<uint64_t>(region_stride_px(region) / NUM_VECTOR_LANES) * batch_bytes;
+	uint8_t* hdr_origin = hdr_buffers[tile_id] + ((region.scratch_offset / NUM_VECTOR_LANES) * batch_bytes);
+	uint64_t num_batches = 0;
+	for (uint32_t pixel_row = y0; pixel_row < y1; pixel_row++)
+	{
+		uint8_t* hdr_row = hdr_origin + ((pixel_row - region.minY) * row_bytes);
+		uint32_t* out_row = out_origin + (static_cast<uint64_t>(pixel_row - region.minY) * out_stride);
+		for (uint32_t pixel_batch = x0; pixel_batch < x1; pixel_batch += NUM_VECTOR_LANES)
+		{
+			// Spare lanes repeat the last real pixel, same as [shade_block]
+			const uint32_t valid_lanes = std::min(x1 - pixel_batch, static_cast<uint32_t>(NUM_VECTOR_LANES));
+			const float init_px = static_cast<float>((pixel_row * canvas_width) + pixel_batch);
+			simple_tiling_utils::hdr_color_batch colors;
+			hdr_job(_mm256_add_ps(_mm256_set1_ps(init_px), _mm256_min_ps(lane_offsets, _mm256_set1_ps(static_cast<float>(valid_lanes - 1)))), tile_id, &colors);
+
+			uint8_t* hdr_batch = hdr_row + (((pixel_batch - region.minX) / NUM_VECTOR_LANES) * batch_bytes);
+			if (half_floats)
+			{
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(hdr_batch), _mm256_cvtps_ph(_mm256_loadu_ps(colors.red), _MM_FROUND_TO_NEAREST_INT));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(hdr_batch + plane_bytes), _mm256_cvtps_ph(_mm256_loadu_ps(colors.green), _MM_FROUND_TO_NEAREST_INT));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(hdr_batch + (plane_bytes * 2)), _mm256_cvtps_ph(_mm256_loadu_ps(colors.blue), _MM_FROUND_TO_NEAREST_INT));
+			}
+			else
+			{
+				memcpy(hdr_batch, &colors, sizeof(colors));
+			}
+			num_batches++;
+		}
+
+		// Resolve the row we just shaded
+		for (uint32_t pixel_batch = x0; pixel_batch < x1; pixel_batch += NUM_VECTOR_LANES)
+		{
+			const uint32_t valid_lanes = std::min(x1 - pixel_batch, static_cast<uint32_t>(NUM_VECTOR_LANES));
+			const uint8_t* hdr_batch = hdr_row + (((pixel_batch - region.minX) / NUM_VECTOR_LANES) * batch_bytes);
+			__m256 red;
+			__m256 green;
+			__m256 blue;
+			if (half_floats)
+			{
+				red = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hdr_batch)));
+				green = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hdr_batch + plane_bytes)));
+				blue = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hdr_batch + (plane_bytes * 2))));
+			}
+			else
+			{
+				red = _mm256_loadu_ps(reinterpret_cast<const float*>(hdr_batch));
+				green = _mm256_loadu_ps(reinterpret_cast<const float*>(hdr_batch + plane_bytes));
+				blue = _mm256_loadu_ps(reinterpret_cast<const float*>(hdr_batch + (plane_bytes * 2)));
+			}
+
+			const float init_px = static_cast<float>((pixel_row * canvas_width) + pixel_batch);
+			const __m256i colors = tonemap_batch(red, green, blue, _mm256_add_ps(_mm256_set1_ps(init_px), lane_offsets));
+			uint32_t* out_px = out_row + (pixel_batch - region.minX);
+			if (padded_output || valid_lanes == NUM_VECTOR_LANES)
+			{
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(out_px), colors);
+			}
+			else
+			{
+				const __m256i lane_mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(valid_lanes)), lane_ids);
+				_mm256_maskstore_epi32(reinterpret_cast<int*>(out_px), lane_mask, colors);
+			}
+		}
+	}
+	return num_batches;
+}
+
+// Halton low-discrepancy sequence; spreads accumulated samples evenly over each pixel, however many of them there are
+float halton(uint32_t index, uint32_t base)
+{
+	float f = 1.0f;
+	float r = 0.0f;
+	while (index > 0)
+	{
+		f /= static_cast<float>(base);
+		r += f * static_cast<float>(index % base);
+		index /= base;
+	}
+	return r;
+}
+
+// Accumulation pass over one region (see [simple_tiling::set_accumulation]); shade one more sample for every pixel (unless [shade] is false),
+// fold it into the region's running sums in [accum], then write the average of [num_samples] samples (this one included) into the output
+// Sums follow the tile-scratch batch layout, with each batch stored as three planes of eight floats (red, green, blue)
+// Given [hdr_job], samples come from that instead, and sums hold linear HDR colors; averages are tonemapped on the way out
+uint64_t shade_accumulated(uint32_t tile_id, simple_tiling_utils::draw_job wrapped_job, simple_tiling_utils::hdr_draw_job hdr_job, const tile_region& region,
+						   uint32_t* out_origin, uint32_t out_stride, bool padded_output, float* accum, uint32_t num_samples, bool shade)
+{
+	ZoneScoped;
+	const __m256 lane_offsets = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+	const __m256i lane_ids = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+	const __m256i channel_mask = _mm256_set1_epi32(0xff);
+	const __m256 to_average = _mm256_set1_ps(1.0f / static_cast<float>(num_samples));
+	const uint32_t stride = region_stride_px(region);
+	uint64_t num_batches = 0;
+	for (uint32_t pixel_row = region.minY; pixel_row < region.maxY; pixel_row++)
+	{
+		uint32_t* out_row = out_origin + (static_cast<uint64_t>(pixel_row - region.minY) * out_stride);
+		float* sums = accum + (static_cast<uint64_t>(pixel_row - region.minY) * stride * 3);
+		for (uint32_t pixel_batch = region.minX; pixel_batch < region.maxX; pixel_batch += NUM_VECTOR_LANES, sums += NUM_VECTOR_LANES * 3)
+		{
+			const uint32_t valid_lanes = std::min(region.maxX - pixel_batch, static_cast<uint32_t>(NUM_VECTOR_LANES));
+			__m256 red = _mm256_loadu_ps(sums);
+			__m256 green = _mm256_loadu_ps(sums + NUM_VECTOR_LANES);
+			__m256 blue = _mm256_loadu_ps(sums + (NUM_VECTOR_LANES * 2));
+
+			// Spare lanes repeat the last real pixel, same as [shade_block]
+			const float init_px = static_cast<float>((pixel_row * canvas_width) + pixel_batch);
+			const __m256 px = _mm256_add_ps(_mm256_set1_ps(init_px), _mm256_min_ps(lane_offsets, _mm256_set1_ps(static_cast<float>(valid_lanes - 1))));
+			if (shade)
+			{
+				__m256 sample_red;
+				__m256 sample_green;
+				__m256 sample_blue;
+				if (hdr_job != nullptr)
+				{
+					simple_tiling_utils::hdr_color_batch sample;
+					hdr_job(px, tile_id, &sample);
+					sample_red = _mm256_loadu_ps(sample.red);
+					sample_green = _mm256_loadu_ps(sample.green);
+					sample_blue = _mm256_loadu_ps(sample.blue);
+				}
+				else
+				{
+					simple_tiling_utils::color_batch sample;
+					wrapped_job(px, tile_id, &sample);
+					const __m256i colors = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sample.colors8bpc));
+					sample_red = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(colors, 16), channel_mask));
+					sample_green = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(colors, 8), channel_mask));
+					sample_blue = _mm256_cvtepi32_ps(_mm256_and_si256(colors, channel_mask));
+				}
+				num_batches++;
+
+				// The first sample of a run overwrites whatever the sums held before
+				red = (num_samples > 1) ? _mm256_add_ps(red, sample_red) : sample_red;
+				green = (num_samples > 1) ? _mm256_add_ps(green, sample_green) : sample_green;
+				blue = (num_samples > 1) ? _mm256_add_ps(blue, sample_blue) : sample_blue;
+				_mm256_storeu_ps(sums, red);
+				_mm256_storeu_ps(sums + NUM_VECTOR_LANES, green);
+				_mm256_storeu_ps(sums + (NUM_VECTOR_LANES * 2), blue);
+			}
+
+			// Averages round to nearest, so a single sample comes back out exactly as it went in
+			__m256i average;
+			if (hdr_job != nullptr)
+			{
+				average = tonemap_batch(_mm256_mul_ps(red, to_average), _mm256_mul_ps(green, to_average), _mm256_mul_ps(blue, to_average), px);
+			}
+			else
+			{
+				average = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_cvtps_epi32(_mm256_mul_ps(red, to_average)), 16),
+														  _mm256_slli_epi32(_mm256_cvtps_epi32(_mm256_mul_ps(green, to_average)), 8)),
+										  _mm256_cvtps_epi32(_mm256_mul_ps(blue, to_average)));
+			}
+			uint32_t* out_px = out_row + (pixel_batch - region.minX);
+			if (padded_output || valid_lanes == NUM_VECTOR_LANES)
+			{
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(out_px), average);
+			}
+			else
+			{
+				const __m256i lane_mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(valid_lanes)), lane_ids);
+				_mm256_maskstore_epi32(reinterpret_cast<int*>(out_px), lane_mask, average);
+			}
+		}
+	}
+	return num_batches;
+}
+
+// Reprojected pass over one region (see [simple_tiling::set_reprojection]); ask [reprojection] where every batch of pixels was on the previous
+// frame, gather whatever's valid out of [history], and queue up the rest. Queued pixels are shaded eight at a time, however scattered they
+// are, so kernels still run full batches when only a few pixels per row are disoccluded
+// Returns the number of batches shaded, and adds the number of pixels copied from [history] to [reused]
+uint64_t shade_reprojected(uint32_t tile_id, simple_tiling_utils::draw_job wrapped_job, simple_tiling_utils::reprojection_job reprojection, const tile_region& region,
+						   uint32_t* out_origin, uint32_t out_stride, bool padded_output, const uint32_t* history, uint64_t& reused)
+{
+	ZoneScoped;
+	const __m256 lane_offsets = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+	const __m256i lane_ids = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+	const __m256i num_px = _mm256_set1_epi32(static_cast<int>(canvas_width * canvas_height));
+	const __m256i invalid_px = _mm256_set1_epi32(-1);
+	uint64_t num_batches = 0;
+
+	// Pixels waiting on the kernel, + where their colors go
+	alignas(32) float queued_px[NUM_VECTOR_LANES];
+	uint32_t* queued_out[NUM_VECTOR_LANES] = {};
+	uint32_t num_queued = 0;
+	auto shade_queue = [&]()
+	{
+		// Spare lanes repeat the last queued pixel, same as partial batches in [shade_block]
+		for (uint32_t i = num_queued; i < NUM_VECTOR_LANES; i++)
+		{
+			queued_px[i] = queued_px[num_queued - 1];
+		}
+		simple_tiling_utils::color_batch colors;
+		wrapped_job(_mm256_load_ps(queued_px), tile_id, &colors);
+		for (uint32_t i = 0; i < num_queued; i++)
+		{
+			*queued_out[i] = colors.colors8bpc[i];
+		}
+		num_batches++;
+		num_queued = 0;
+	};
+
+	for (uint32_t pixel_row = region.minY; pixel_row < region.maxY; pixel_row++)
+	{
+		uint32_t* out_row = out_origin + (static_cast<uint64_t>(pixel_row - region.minY) * out_stride);
+		for (uint32_t pixel_batch = region.minX; pixel_batch < region.maxX; pixel_batch += NUM_VECTOR_LANES)
+		{
+			const uint32_t valid_lanes = std::min(region.maxX - pixel_batch, static_cast<uint32_t>(NUM_VECTOR_LANES));
+			const uint32_t init_px = (pixel_row * canvas_width) + pixel_batch;
+			const __m256 batch_px = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(init_px)), _mm256_min_ps(lane_offsets, _mm256_set1_ps(static_cast<float>(valid_lanes - 1))));
+			simple_tiling_utils::reprojection_batch prev;
+			reprojection(batch_px, tile_id, &prev);
+
+			// Anything off the canvas counts as invalid too
+			const __m256i prev_px = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(prev.prev_pixels));
+			const __m256i hits = _mm256_and_si256(_mm256_cmpgt_epi32(prev_px, invalid_px), _mm256_cmpgt_epi32(num_px, prev_px));
+			const __m256i colors = _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), reinterpret_cast<const int*>(history), prev_px, hits, 4);
+			uint32_t* out_px = out_row + (pixel_batch - region.minX);
+			if (padded_output || valid_lanes == NUM_VECTOR_LANES)
+			{
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(out_px), colors);
+			}
+			else
+			{
+				const __m256i lane_mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(valid_lanes)), lane_ids);
+				_mm256_maskstore_epi32(reinterpret_cast<int*>(out_px), lane_mask, colors);
+			}
+
+			const uint32_t lanes = (1u << valid_lanes) - 1;
+			const uint32_t hit_lanes = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(hits))) & lanes;
+			reused += std::popcount(hit_lanes);
+			for (uint32_t misses = lanes & ~hit_lanes; misses != 0; misses &= misses - 1)
+			{
+				const uint32_t lane = std::countr_zero(misses);
+				queued_px[num_queued] = static_cast<float>(init_px + lane);
+				queued_out[num_queued] = out_px + lane;
+				if (++num_queued == NUM_VECTOR_LANES)
+				{
+					shade_queue();
+				}
+			}
+		}
+	}
+
+	if (num_queued > 0)
+	{
+		shade_queue();
+	}
+	return num_batches;
+}
+
+// Where a region's pixels live in whichever surface this pass writes to
+uint32_t* region_output(uint32_t tile_id, const tile_region& region, simple_tiling_utils::OUTPUT_MODES pass_output, uint32_t* write_buffer, uint32_t& out_stride)
+{
+	switch (pass_output)
+	{
+		case simple_tiling_utils::TILE_BUFFER_OUTPUT:
+			out_stride = region_stride_px(region);
+			return reinterpret_cast<uint32_t*>(tileBuffers[tile_id]) + region.scratch_offset;
+		case simple_tiling_utils::DIRECT_OUTPUT:
+			out_stride = canvas_width;
+			return write_buffer + ((static_cast<uint64_t>(region.minY) * canvas_width) + region.minX);
+		default:
+			out_stride = external_output_stride;
+			return external_output + ((static_cast<uint64_t>(region.minY) * external_output_stride) + region.minX);
+	}
+}
+
+// Rows of [region] touched by a pass; everything for full-tile work, or the union of the damage rects overlapping it
+// Returns false if the pass doesn't touch the region at all
+bool region_pass_rows(const tile_region& region, const simple_tiling_utils::damage_list* damage, uint32_t& y0, uint32_t& y1)
+{
+	if (damage == nullptr)
+	{
+		y0 = region.minY;
+		y1 = region.maxY;
+		return true;
+	}
+
+	y0 = region.maxY;
+	y1 = region.minY;
+	for (uint32_t i = 0; i < damage->num_rects; i++)
+	{
+		const simple_tiling_utils::damage_rect& rect = damage->rects[i];
+		if (rect.minX < region.maxX && rect.maxX > region.minX && rect.minY < region.maxY && rect.maxY > region.minY)
+		{
+			y0 = std::min(y0, std::max(rect.minY, region.minY));
+			y1 = std::max(y1, std::min(rect.maxY, region.maxY));
+		}
+	}
+	return y0 < y1;
+}
+
+// Direct output shades straight into a swap-chain buffer that's (usually) three frames old, so damage-driven passes need the rest of the tile
+// brought forward from the most recently published frame before they shade over it
+void carry_forward_region(uint32_t tile_id, const tile_region& region, uint32_t* write_buffer)
+{
+	ZoneScoped;
+
+	// The last published buffer can't be recycled for writing until this frame publishes, which needs us; safe to read without waiting
+	const uint32_t src_ndx = tile_swap_chain.last_published;
+	const uint32_t dst_ndx = tile_swap_chain.write_ndx;
+	if (src_ndx == dst_ndx)
+	{
+		return; // Nothing published yet
+	}
+
+	const uint32_t* src_versions = held_span_versions(src_ndx, tile_id) + region.span_offset;
+	uint32_t* dst_versions = held_span_versions(dst_ndx, tile_id) + region.span_offset;
+	const uint32_t* src = tile_swap_chain.buffers[src_ndx];
+	const uint32_t w = region.maxX - region.minX;
+	uint64_t copied_rows = 0;
+	for (uint32_t s = 0; s < region_num_spans(region); s++)
+	{
+		// With dirty tracking we know exactly which spans are stale; otherwise everything is
+		// (versions restart at zero whenever tiles move, and zero-vs-zero says nothing about what either buffer holds)
+		if (dirty_tracking && dst_versions[s] == src_versions[s] && src_versions[s] != 0)
+		{
+			continue;
+		}
+
+		const uint32_t span_minY = region.minY + (s * dirty_span_rows);
+		const uint32_t span_maxY = std::min(span_minY + dirty_span_rows, region.maxY);
+		for (uint32_t y = span_minY; y < span_maxY; y++)
+		{
+			const uint64_t row_offs = (static_cast<uint64_t>(y) * canvas_width) + region.minX;
+			memcpy(write_buffer + row_offs, src + row_offs, sizeof(uint32_t) * w);
+		}
+		dst_versions[s] = src_versions[s];
+		copied_rows += span_maxY - span_minY;
+	}
+	tile_data[tile_id].threadData.bytes_copied.fetch_add(copied_rows * w * sizeof(uint32_t) * 2, std::memory_order_relaxed); // Read + write
+}
+
+// Copy a region from tile scratch into the swap-chain's write buffer; with dirty tracking, only spans the write buffer doesn't already hold
+// (static content lands once per buffer, then never moves again)
+void copy_out_region(uint32_t tile_id, const tile_region& region, uint32_t* write_buffer)
+{
+	const uint32_t dest_w = region.maxX - region.minX;
+	const uint32_t src_stride = region_stride_px(region); // Scratch rows may be padded out past [dest_w]; only the real pixels land in the canvas
+	const uint32_t* src = region_resolved(tile_id, region);
+	const uint32_t* versions = span_versions + (static_cast<uint64_t>(tile_id) * spans_per_tile) + region.span_offset;
+	uint32_t* held_versions = held_span_versions(tile_swap_chain.write_ndx, tile_id) + region.span_offset;
+	uint64_t copied_rows = 0;
+	for (uint32_t s = 0; s < region_num_spans(region); s++)
+	{
+		if (dirty_tracking && held_versions[s] == versions[s])
+		{
+			continue;
+		}
+
+		const uint32_t span_minY = region.minY + (s * dirty_span_rows);
+		const uint32_t span_maxY = std::min(span_minY + dirty_span_rows, region.maxY);
+		const uint32_t* in_ptr = src + (static_cast<uint64_t>(span_minY - region.minY) * src_stride);
+		uint32_t* out_ptr = write_buffer + ((static_cast<uint64_t>(span_minY) * canvas_width) + region.minX);
+		for (uint32_t y = span_minY; y < span_maxY; y++)
+		{
+			memcpy(out_ptr, in_ptr, sizeof(uint32_t) * dest_w);
+			in_ptr += src_stride;
+			out_ptr += canvas_width;
+		}
+		held_versions[s] = versions[s];
+		copied_rows += span_maxY - span_minY;
+	}
+	tile_data[tile_id].threadData.bytes_copied.fetch_add(copied_rows * dest_w * sizeof(uint32_t) * 2, std::memory_order_relaxed); // Read + write
+}
+
+// Post canvases are padded by [post_padding] pixels on every side, so effects can read past the edges of the canvas without clamping
+uint32_t post_canvas_stride()
+{
+	return canvas_width + (post_padding * 2);
+}
+
+uint64_t post_canvas_px()
+{
+	return static_cast<uint64_t>(post_canvas_stride()) * (canvas_height + (post_padding * 2));
+}
+
+uint32_t* post_canvas_at(uint32_t* canvas, int64_t x, int64_t y)
+{
+	return canvas + ((y + post_padding) * post_canvas_stride()) + (x + post_padding);
+}
+
+// Copy a region's finished pixels into one of [history_frames], for later passes to reproject from
+// Reprojection works from unprocessed frames, so with post-processing we copy from [post_canvases] instead (direct output only holds processed
+// pixels outside damage by the time we get here)
+void store_history(uint32_t tile_id, const tile_region& region, simple_tiling_utils::OUTPUT_MODES pass_output, uint32_t* write_buffer, uint32_t* history)
+{
+	uint32_t src_stride = 0;
+	const uint32_t* src = region_output(tile_id, region, pass_output, write_buffer, src_stride);
+	if (num_post_effects > 0)
+	{
+		src = post_canvas_at(post_canvases[0], region.minX, region.minY);
+		src_stride = post_canvas_stride();
+	}
+	else if (pass_output == simple_tiling_utils::TILE_BUFFER_OUTPUT)
+	{
+		src = region_resolved(tile_id, region);
+	}
+
+	uint32_t* dst = history + ((static_cast<uint64_t>(region.minY) * canvas_width) + region.minX);
+	for (uint32_t y = region.minY; y < region.maxY; y++)
+	{
+		memcpy(dst, src, sizeof(uint32_t) * (region.maxX - region.minX));
+		src += src_stride;
+		dst += canvas_width;
+	}
+}
+
+// Clip a damage rect against a region, widening it out to whole batches; returns false if they don't overlap
+bool clip_damage_rect(const tile_region& region, const simple_tiling_utils::damage_rect& rect, uint32_t& x0, uint32_t& x1, uint32_t& y0, uint32_t& y1)
+{
+	const uint32_t clip_x0 = std::max(rect.minX, region.minX);
+	const uint32_t clip_x1 = std::min(rect.maxX, region.maxX);
+	y0 = std::max(rect.minY, region.minY);
+	y1 = std::min(rect.maxY, region.maxY);
+	if (clip_x0 >= clip_x1 || y0 >= y1)
+	{
+		return false;
+	}
+
+	x0 = region.minX + (((clip_x0 - region.minX) / NUM_VECTOR_LANES) * NUM_VECTOR_LANES);
+	x1 = std::min(region.minX + ((((clip_x1 - region.minX) + NUM_VECTOR_LANES - 1) / NUM_VECTOR_LANES) * NUM_VECTOR_LANES), region.maxX);
+	return true;
+}
+
+// Post-processing barrier; tiles wait here until every tile has arrived, since the next stage reads pixels the others just wrote
+// The last tile in resets the count before releasing everyone, so tiles racing ahead into the next barrier always find it empty
+void post_barrier(XThreadWrapper::data& tileInfo)
+{
+	ZoneScoped;
+	const uint32_t generation = post_generation.load(std::memory_order_acquire);
+	if ((post_arrivals.fetch_add(1, std::memory_order_acq_rel) + 1) == numTiles)
+	{
+		post_arrivals.store(0, std::memory_order_relaxed);
+		post_generation.fetch_add(1, std::memory_order_release);
+		post_generation.notify_all();
+		return;
+	}
+
+	// Shutdown bumps the generation as well (see [stop_tiles]), so stopped tiles never wait on tiles that already exited
+	while (post_generation.load(std::memory_order_acquire) == generation && tileInfo.tile_running)
+	{
+		post_generation.wait(generation, std::memory_order_acquire);
+	}
+}
+
+// Repeat a region's edge pixels out into [canvas]' border, wherever the region touches the edge of the canvas; corners come from whichever
+// region holds the corner pixel
+void pad_post_region(uint32_t* canvas, const tile_region& region)
+{
+	const int64_t pad = post_padding;
+	const int64_t x0 = (region.minX == 0) ? -pad : region.minX;
+	const int64_t x1 = (region.maxX == canvas_width) ? (canvas_width + pad) : region.maxX;
+	const int64_t y0 = (region.minY == 0) ? -pad : region.minY;
+	const int64_t y1 = (region.maxY == canvas_height) ? (canvas_height + pad) : region.maxY;
+	if (x0 == region.minX && x1 == region.maxX && y0 == region.minY && y1 == region.maxY)
+	{
+		return; // Interior region
+	}
+
+	for (int64_t y = y0; y < y1; y++)
+	{
+		uint32_t* row = post_canvas_at(canvas, 0, y);
+		const uint32_t* src_row = post_canvas_at(canvas, 0, std::clamp<int64_t>(y, 0, canvas_height - 1));
+		if (row != src_row)
+		{
+			memcpy(row + region.minX, src_row + region.minX, sizeof(uint32_t) * (region.maxX - region.minX));
+		}
+		std::fill(row + x0, row + region.minX, src_row[0]);
+		std::fill(row + region.maxX, row + x1, src_row[canvas_width - 1]);
+	}
+}
+
+// Store rows [y0, y1) * [x0, x1) of a region's shaded pixels into the unprocessed-frame canvas, for post-processing to read (+ pad) from
+void store_post_source(const uint32_t* src, uint32_t src_stride, const tile_region& region, uint32_t x0, uint32_t x1, uint32_t y0, uint32_t y1)
+{
+	src += (static_cast<uint64_t>(y0 - region.minY) * src_stride) + (x0 - region.minX);
+	uint32_t* dst = post_canvas_at(post_canvases[0], x0, y0);
+	for (uint32_t y = y0; y < y1; y++)
+	{
+		memcpy(dst, src, sizeof(uint32_t) * (x1 - x0));
+		src += src_stride;
+		dst += post_canvas_stride();
+	}
+}
+
+// Store a batch of filtered channels as packed 8bpc colors; rounded, then clamped, since weights (and kernels) can overshoot
+void store_post_batch(__m256 red, __m256 green, __m256 blue, uint32_t* dst, uint32_t valid_lanes, bool padded_output)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i max_channel = _mm256_set1_epi32(255);
+	const __m256i r = _mm256_min_epi32(_mm256_max_epi32(_mm256_cvtps_epi32(red), zero), max_channel);
+	const __m256i g = _mm256_min_epi32(_mm256_max_epi32(_mm256_cvtps_epi32(green), zero), max_channel);
+	const __m256i b = _mm256_min_epi32(_mm256_max_epi32(_mm256_cvtps_epi32(blue), zero), max_channel);
+	const __m256i colors = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(r, 16), _mm256_slli_epi32(g, 8)), b);
+	if (padded_output || valid_lanes == NUM_VECTOR_LANES)
+	{
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), colors);
+	}
+	else
+	{
+		const __m256i lane_mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(valid_lanes)), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+		_mm256_maskstore_epi32(reinterpret_cast<int*>(dst), lane_mask, colors);
+	}
+}
+
+// Working memory for [post_separable] over one region; split source rows, then every horizontally-filtered row (halo included)
+uint64_t post_scratch_floats(const tile_region& region)
+{
+	const uint64_t stride = region_stride_px(region);
+	return ((stride + (post_halo * 2) + NUM_VECTOR_LANES) * 3) + ((static_cast<uint64_t>(region.maxY - region.minY) + (post_halo * 2)) * stride * 3);
+}
+
+// Separable effect over one region; the horizontal pass filters rows [minY - halo, maxY + halo) of [src] (a padded post canvas) into float
+// scratch, three planes per batch like the accumulation buffers, then the vertical pass filters those into [dst]
+// Source rows are split into float channels once up-front, so every tap is an unaligned load + an FMA per channel
+void post_separable(uint32_t tile_id, const simple_tiling_utils::post_effect& effect, const float* weights_x, const float* weights_y, const tile_region& region,
+					uint32_t* src, uint32_t* dst, uint32_t dst_stride, bool padded_output)
+{
+	ZoneScoped;
+	const int64_t halo = effect.halo;
+	const uint32_t taps = (effect.halo * 2) + 1;
+	const uint32_t stride = region_stride_px(region);
+	const uint32_t region_w = region.maxX - region.minX;
+	const uint32_t split_px = ((stride + (effect.halo * 2) + NUM_VECTOR_LANES - 1) / NUM_VECTOR_LANES) * NUM_VECTOR_LANES;
+	const uint32_t split_plane = stride + (post_halo * 2) + NUM_VECTOR_LANES; // Matches [post_scratch_floats]
+	float* split = post_scratch[tile_id];
+	float* filtered = split + (split_plane * 3);
+	const uint64_t filtered_row = static_cast<uint64_t>(stride) * 3;
+	const __m256i channel_mask = _mm256_set1_epi32(0xff);
+
+	for (int64_t y = static_cast<int64_t>(region.minY) - halo; y < static_cast<int64_t>(region.maxY) + halo; y++)
+	{
+		// Reads run up to [split_px] pixels from (minX - halo); at most a batch + halo past the end of the region's last batch, which the
+		// canvas border covers
+		const uint32_t* src_row = post_canvas_at(src, static_cast<int64_t>(region.minX) - halo, y);
+		for (uint32_t x = 0; x < split_px; x += NUM_VECTOR_LANES)
+		{
+			const __m256i px = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src_row + x));
+			_mm256_storeu_ps(split + x, _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(px, 16), channel_mask)));
+			_mm256_storeu_ps(split + split_plane + x, _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(px, 8), channel_mask)));
+			_mm256_storeu_ps(split + (split_plane * 2) + x, _mm256_cvtepi32_ps(_mm256_and_si256(px, channel_mask)));
+		}
+
+		float* out_row = filtered + (static_cast<uint64_t>(y - (static_cast<int64_t>(region.minY) - halo)) * filtered_row);
+		for (uint32_t x = 0; x < stride; x += NUM_VECTOR_LANES)
+		{
+			__m256 red = _mm256_setzero_ps();
+			__m256 green = _mm256_setzero_ps();
+			__m256 blue = _mm256_setzero_ps();
+			for (uint32_t t = 0; t < taps; t++)
+			{
+				const __m256 w = _mm256_set1_ps(weights_x[t]);
+				red = _mm256_fmadd_ps(_mm256_loadu_ps(split + x + t), w, red);
+				green = _mm256_fmadd_ps(_mm256_loadu_ps(split + split_plane + x + t), w, green);
+				blue = _mm256_fmadd_ps(_mm256_loadu_ps(split + (split_plane * 2) + x + t), w, blue);
+			}
+			_mm256_storeu_ps(out_row + (x * 3), red);
+			_mm256_storeu_ps(out_row + (x * 3) + NUM_VECTOR_LANES, green);
+			_mm256_storeu_ps(out_row + (x * 3) + (NUM_VECTOR_LANES * 2), blue);
+		}
+	}
+
+	for (uint32_t y = region.minY; y < region.maxY; y++)
+	{
+		const float* in_rows = filtered + (static_cast<uint64_t>(y - region.minY) * filtered_row);
+		uint32_t* out_row = dst + (static_cast<uint64_t>(y - region.minY) * dst_stride);
+		for (uint32_t x = 0; x < stride; x += NUM_VECTOR_LANES)
+		{
+			__m256 red = _mm256_setzero_ps();
+			__m256 green = _mm256_setzero_ps();
+			__m256 blue = _mm256_setzero_ps();
+			const float* in_batch = in_rows + (x * 3);
+			for (uint32_t t = 0; t < taps; t++)
+			{
+				const __m256 w = _mm256_set1_ps(weights_y[t]);
+				red = _mm256_fmadd_ps(_mm256_loadu_ps(in_batch), w, red);
+				green = _mm256_fmadd_ps(_mm256_loadu_ps(in_batch + NUM_VECTOR_LANES), w, green);
+				blue = _mm256_fmadd_ps(_mm256_loadu_ps(in_batch + (NUM_VECTOR_LANES * 2)), w, blue);
+				in_batch += filtered_row;
+			}
+			store_post_batch(red, green, blue, out_row + x, std::min(region_w - x, static_cast<uint32_t>(NUM_VECTOR_LANES)), padded_output);
+		}
+	}
+}
+
+// Kernel effect over one region; same batch layout as [shade_block], with each batch handed a pointer into [src] (a padded post canvas)
+void post_kernel(uint32_t tile_id, const simple_tiling_utils::post_effect& effect, const tile_region& region, uint32_t* src, uint32_t* dst, uint32_t dst_stride,
+				 bool padded_output)
+{
+	ZoneScoped;
+	const __m256 lane_offsets = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+	const __m256i lane_ids = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+	for (uint32_t y = region.minY; y < region.maxY; y++)
+	{
+		uint32_t* out_row = dst + (static_cast<uint64_t>(y - region.minY) * dst_stride);
+		for (uint32_t x = region.minX; x < region.maxX; x += NUM_VECTOR_LANES)
+		{
+			// Spare lanes in partial batches repeat the last real pixel, like [shade_block]; their source pixels are still border, so kernels
+			// reading lane-by-lane from [src] stay in bounds either way
+			const uint32_t valid_lanes = std::min(region.maxX - x, static_cast<uint32_t>(NUM_VECTOR_LANES));
+			const __m256 px = _mm256_add_ps(_mm256_set1_ps(static_cast<float>((static_cast<uint64_t>(y) * canvas_width) + x)),
+											_mm256_min_ps(lane_offsets, _mm256_set1_ps(static_cast<float>(valid_lanes - 1))));
+			simple_tiling_utils::color_batch* out_colors = reinterpret_cast<simple_tiling_utils::color_batch*>(out_row + (x - region.minX));
+			if (padded_output || valid_lanes == NUM_VECTOR_LANES)
+			{
+				effect.job(post_canvas_at(src, x, y), post_canvas_stride(), px, tile_id, out_colors);
+			}
+			else
+			{
+				simple_tiling_utils::color_batch tail_colors;
+				effect.job(post_canvas_at(src, x, y), post_canvas_stride(), px, tile_id, &tail_colors);
+				const __m256i lane_mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(valid_lanes)), lane_ids);
+				_mm256_maskstore_epi32(reinterpret_cast<int*>(out_colors), lane_mask, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(tail_colors.colors8bpc)));
+			}
+		}
+	}
+}
+
+// Run the post-processing chain over every region of a tile (see [simple_tiling::set_post_processing]), once the unprocessed frame is in
+// [post_canvases][0]; intermediate effects alternate between the other two canvases, and the last one writes wherever this pass outputs to
+// (post buffers for tile-buffer output, so scratch keeps the unprocessed pixels checkerboarding needs)
+void run_post_effects(uint32_t tile_id, simple_tiling_utils::OUTPUT_MODES pass_output, uint32_t* write_buffer)
+{
+	ZoneScoped;
+	XThreadWrapper::data& tileInfo = tile_data[tile_id].threadData;
+	const tile_region* regions = tile_regions + tileInfo.first_region;
+	post_barrier(tileInfo); // Every tile's unprocessed pixels (+ borders) are in place
+	for (uint32_t e = 0; e < num_post_effects; e++)
+	{
+		const simple_tiling_utils::post_effect& effect = post_effects[e];
+		uint32_t* src = (e == 0) ? post_canvases[0] : post_canvases[1 + ((e - 1) % 2)];
+		const bool last = (e + 1) == num_post_effects;
+		for (uint32_t r = 0; r < tileInfo.num_regions; r++)
+		{
+			const tile_region& region = regions[r];
+			uint32_t dst_stride = post_canvas_stride();
+			uint32_t* dst = nullptr;
+			bool padded = false;
+			if (!last)
+			{
+				dst = post_canvas_at(post_canvases[1 + (e % 2)], region.minX, region.minY);
+			}
+			else if (pass_output == simple_tiling_utils::TILE_BUFFER_OUTPUT)
+			{
+				dst = post_buffers[tile_id] + region.scratch_offset;
+				dst_stride = region_stride_px(region);
+				padded = true;
+			}
+			else
+			{
+				dst = region_output(tile_id, region, pass_output, write_buffer, dst_stride);
+			}
+
+			if (effect.type == simple_tiling_utils::SEPARABLE_POST_EFFECT)
+			{
+				post_separable(tile_id, effect, post_weights[e][0], post_weights[e][1], region, src, dst, dst_stride, padded);
+			}
+			else
+			{
+				post_kernel(tile_id, effect, region, src, dst, dst_stride, padded);
+			}
+
+			if (!last)
+			{
+				pad_post_region(post_canvases[1 + (e % 2)], region);
+			}
+		}
+
+		// Later effects read what everyone just wrote; the first effect is also the only one reading the unprocessed frame, so once everyone's
+		// past it the next pass is free to overwrite that. Later canvases only get overwritten after the next pass' first barrier
+		if (!last || e == 0)
+		{
+			post_barrier(tileInfo);
+		}
+	}
+}
+
+// Region of [tileInfo]'s tile holding canvas pixel ([x], [y]), or nullptr if the tile doesn't own it (kernels can mark anything)
+const tile_region* pixel_region(const XThreadWrapper::data& tileInfo, uint32_t x, uint32_t y)
+{
+	if (x >= canvas_width || y >= canvas_height)
+	{
+		return nullptr;
+	}
+
+	// Only Morton layouts hand tiles more than one region, and those sit on the micro-tile grid
+	uint32_t r = tileInfo.first_region;
+	if (tileInfo.num_regions > 1)
+	{
+		r = micro_tile_regions[((y / micro_tile_px) * micro_tile_cols) + (x / micro_tile_px)];
+		if (r < tileInfo.first_region || r >= (tileInfo.first_region + tileInfo.num_regions))
+		{
+			return nullptr;
+		}
+	}
+
+	const tile_region& region = tile_regions[r];
+	return (x >= region.minX && x < region.maxX && y >= region.minY && y < region.maxY) ? &region : nullptr;
+}
+
+// Stream-compaction shuffles for [simple_tiling::mark_pixels] + [find_edges]; entry [mask] lists the lanes set in [mask], lowest first, one byte each
+// (widened into a [_mm256_permutevar8x32_epi32] index on use), so marked lanes pack down into the bottom of the vector
+struct compaction_table
+{
+	uint64_t lanes[1u << NUM_VECTOR_LANES] = {};
+
+	constexpr compaction_table()
+	{
+		for (uint32_t mask = 0; mask < (1u << NUM_VECTOR_LANES); mask++)
+		{
+			uint32_t num_packed = 0;
+			for (uint32_t i = 0; i < NUM_VECTOR_LANES; i++)
+			{
+				if (mask & (1u << i))
+				{
+					lanes[mask] |= static_cast<uint64_t>(i) << (num_packed * 8);
+					num_packed++;
+				}
+			}
+		}
+	}
+};
+static constexpr compaction_table compaction_lanes;
+
+// Pack the lanes of [values] set in [mask] down to the bottom of the vector, then store the whole vector at [list]; returns how many lanes
+// were packed. Lanes past those land beyond the end of the list, so lists need a vector's worth of room past their last entry
+uint32_t compact_lanes(uint32_t* list, __m256i values, uint32_t mask)
+{
+	const __m256i shuffle = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(&compaction_lanes.lanes[mask])));
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(list), _mm256_permutevar8x32_epi32(values, shuffle));
+	return static_cast<uint32_t>(std::popcount(mask));
+}
+
+// Sparse pass (see [simple_tiling::submit_sparse_draw_work]); shade [count] listed pixels eight at a time, then scatter every lane back to its
+// own pixel in whichever surface this pass writes to. Resolving tiles write the resolve buffer as well, so reconstructed checkerboard pixels
+// everywhere else survive (and scratch keeps real kernel output for the next checkerboard to compare against); with post-processing on, every
+// pixel lands in the unprocessed-frame canvas too, since direct/external output already holds last pass' processed pixels everywhere else
+// Lists follow shading order, so runs of batches fall in the same region; we keep the last region's output around, and only look regions up
+// again for batches that leave it. Given [touched_spans] (the tile's dirty-tracking spans), flag every span a listed pixel lands in
+uint64_t shade_sparse(uint32_t tile_id, simple_tiling_utils::draw_job wrapped_job, const uint32_t* list, uint32_t count, simple_tiling_utils::OUTPUT_MODES pass_output,
+					  uint32_t* write_buffer, bool resolving, uint32_t* post_source, uint8_t* touched_spans)
+{
+	ZoneScoped;
+	const XThreadWrapper::data& tileInfo = tile_data[tile_id].threadData;
+	const __m256i lane_ids = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+	const __m256 width_ps = _mm256_set1_ps(static_cast<float>(canvas_width));
+	const __m256i width_epi32 = _mm256_set1_epi32(static_cast<int>(canvas_width));
+
+	// Output for the region the last batch landed in
+	const tile_region* region = nullptr;
+	uint32_t* out_origin = nullptr;
+	uint32_t* resolve_origin = nullptr;
+	uint32_t out_stride = 0;
+	__m256i region_min_x = _mm256_setzero_si256();
+	__m256i region_min_y = _mm256_setzero_si256();
+	__m256i region_max_x = _mm256_setzero_si256(); // Exclusive bounds, so empty until we have a region
+	__m256i region_max_y = _mm256_setzero_si256();
+	auto enter_region = [&](const tile_region* r)
+	{
+		region = r;
+		out_origin = region_output(tile_id, *region, pass_output, write_buffer, out_stride);
+		resolve_origin = resolving ? resolveBuffers[tile_id] + region->scratch_offset : nullptr;
+		region_min_x = _mm256_set1_epi32(static_cast<int>(region->minX));
+		region_min_y = _mm256_set1_epi32(static_cast<int>(region->minY));
+		region_max_x = _mm256_set1_epi32(static_cast<int>(region->maxX));
+		region_max_y = _mm256_set1_epi32(static_cast<int>(region->maxY));
+	};
+
+	uint64_t num_batches = 0;
+	for (uint32_t i = 0; i < count; i += NUM_VECTOR_LANES)
+	{
+		// Lists always have a vector's worth of room past their last entry, so the last batch loads whole and repeats its last pixel from there
+		const uint32_t valid_lanes = std::min(count - i, static_cast<uint32_t>(NUM_VECTOR_LANES));
+		const __m256i listed = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(list + i));
+		const __m256i px = _mm256_permutevar8x32_epi32(listed, _mm256_min_epi32(lane_ids, _mm256_set1_epi32(static_cast<int>(valid_lanes - 1))));
+
+		simple_tiling_utils::color_batch colors;
+		wrapped_job(_mm256_cvtepi32_ps(px), tile_id, &colors);
+
+		// Split indices into columns + rows eight at a time; float division can land a row out at either end of a row, so nudge those back
+		__m256i y = _mm256_cvttps_epi32(_mm256_div_ps(_mm256_cvtepi32_ps(px), width_ps));
+		__m256i x = _mm256_sub_epi32(px, _mm256_mullo_epi32(y, width_epi32));
+		const __m256i under = _mm256_cmpgt_epi32(_mm256_setzero_si256(), x);
+		const __m256i over = _mm256_cmpgt_epi32(x, _mm256_sub_epi32(width_epi32, _mm256_set1_epi32(1)));
+		y = _mm256_sub_epi32(_mm256_add_epi32(y, under), over);
+		x = _mm256_sub_epi32(_mm256_add_epi32(x, _mm256_and_si256(under, width_epi32)), _mm256_and_si256(over, width_epi32));
+
+		alignas(32) uint32_t lane_x[NUM_VECTOR_LANES];
+		alignas(32) uint32_t lane_y[NUM_VECTOR_LANES];
+		_mm256_store_si256(reinterpret_cast<__m256i*>(lane_x), x);
+		_mm256_store_si256(reinterpret_cast<__m256i*>(lane_y), y);
+
+		// Whole batches inside the last region skip per-lane bounds checks; lanes past [valid_lanes] repeat the last real one, so a whole-vector
+		// test covers them as well
+		const __m256i below_min = _mm256_or_si256(_mm256_cmpgt_epi32(region_min_x, x), _mm256_cmpgt_epi32(region_min_y, y));
+		const __m256i below_max = _mm256_and_si256(_mm256_cmpgt_epi32(region_max_x, x), _mm256_cmpgt_epi32(region_max_y, y));
+		const bool batch_inside = _mm256_movemask_epi8(_mm256_andnot_si256(below_min, below_max)) == -1;
+		for (uint32_t j = 0; j < valid_lanes; j++)
+		{
+			if (!batch_inside && (region == nullptr || lane_x[j] < region->minX || lane_x[j] >= region->maxX || lane_y[j] < region->minY || lane_y[j] >= region->maxY))
+			{
+				const tile_region* lane_region = pixel_region(tileInfo, lane_x[j], lane_y[j]);
+				if (lane_region == nullptr)
+				{
+					continue;
+				}
+				enter_region(lane_region);
+			}
+
+			const uint64_t ry = lane_y[j] - region->minY;
+			const uint64_t out_px = (ry * out_stride) + (lane_x[j] - region->minX);
+			out_origin[out_px] = colors.colors8bpc[j];
+			if (resolve_origin != nullptr)
+			{
+				resolve_origin[out_px] = colors.colors8bpc[j];
+			}
+			if (post_source != nullptr)
+			{
+				*post_canvas_at(post_source, lane_x[j], lane_y[j]) = colors.colors8bpc[j];
+			}
+			if (touched_spans != nullptr)
+			{
+				touched_spans[region->span_offset + (ry / dirty_span_rows)] = 1;
+			}
+		}
+		num_batches++;
+	}
+	return num_batches;
+}
+
+// Largest per-channel (RGB) range over one pixel of a region + whichever of its four neighbours are inside it; see [find_edges]
+uint32_t pixel_contrast(const uint32_t* raw, uint32_t stride, uint32_t w, uint32_t h, uint32_t rx, uint32_t ry)
+{
+	const uint32_t* px = raw + (static_cast<uint64_t>(ry) * stride) + rx;
+	uint32_t lo = *px;
+	uint32_t hi = *px;
+	auto widen = [&](uint32_t neighbour)
+	{
+		for (uint32_t c = 0; c < 24; c += 8)
+		{
+			const uint32_t channel_mask = 0xffu << c;
+			lo = (lo & ~channel_mask) | std::min(lo & channel_mask, neighbour & channel_mask);
+			hi = (hi & ~channel_mask) | std::max(hi & channel_mask, neighbour & channel_mask);
+		}
+	};
+	if (rx > 0) widen(px[-1]);
+	if (rx + 1 < w) widen(px[1]);
+	if (ry > 0) widen(*(px - stride));
+	if (ry + 1 < h) widen(*(px + stride));
+
+	uint32_t contrast = 0;
+	for (uint32_t c = 0; c < 24; c += 8)
+	{
+		contrast = std::max(contrast, ((hi >> c) & 0xff) - ((lo >> c) & 0xff));
+	}
+	return contrast;
+}
+
+// Anti-aliasing (see [simple_tiling::set_anti_aliasing]); list every pixel of a freshly shaded region whose neighbourhood spans more than
+// [aa_edge_contrast] in any channel, as ((y << 16) | x) from the region's top-left corner, and return how many there were
+// Interior pixels run eight at a time, packed onto [list] with [compact_lanes]; region edges fall back to [pixel_contrast] (they're missing
+// neighbours), like [resolve_checkerboard]
+uint32_t find_edges(const uint32_t* out_origin, uint32_t out_stride, const tile_region& region, uint32_t* list)
+{
+	ZoneScoped;
+	const uint32_t w = region.maxX - region.minX;
+	const uint32_t h = region.maxY - region.minY;
+	const __m256i lane_ids = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+	const __m256i color_mask = _mm256_set1_epi32(0x00ffffff);
+	const __m256i threshold = _mm256_set1_epi8(static_cast<char>(aa_edge_contrast));
+	uint32_t count = 0;
+	for (uint32_t ry = 0; ry < h; ry++)
+	{
+		const uint32_t* row = out_origin + (static_cast<uint64_t>(ry) * out_stride);
+		uint32_t rx = 0;
+		if (ry > 0 && (ry + 1) < h)
+		{
+			if (w > 0 && pixel_contrast(out_origin, out_stride, w, h, 0, ry) > aa_edge_contrast)
+			{
+				list[count++] = ry << 16;
+			}
+			rx = 1;
+
+			for (; (rx + NUM_VECTOR_LANES) < w; rx += NUM_VECTOR_LANES)
+			{
+				const __m256i centre = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + rx));
+				const __m256i left = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + rx - 1));
+				const __m256i right = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + rx + 1));
+				const __m256i up = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + rx - out_stride));
+				const __m256i down = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + rx + out_stride));
+				const __m256i lo = _mm256_min_epu8(centre, _mm256_min_epu8(_mm256_min_epu8(left, right), _mm256_min_epu8(up, down)));
+				const __m256i hi = _mm256_max_epu8(centre, _mm256_max_epu8(_mm256_max_epu8(left, right), _mm256_max_epu8(up, down)));
+
+				// Channels past the threshold leave something behind after saturating subtraction; any of them makes the pixel an edge
+				const __m256i excess = _mm256_and_si256(_mm256_subs_epu8(_mm256_subs_epu8(hi, lo), threshold), color_mask);
+				const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(excess, _mm256_setzero_si256())))) ^ 0xffu;
+				if (mask != 0)
+				{
+					const __m256i coords = _mm256_or_si256(_mm256_set1_epi32(static_cast<int>(ry << 16)), _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(rx)), lane_ids));
+					count += compact_lanes(list + count, coords, mask);
+				}
+			}
+		}
+
+		for (; rx < w; rx++)
+		{
+			if (pixel_contrast(out_origin, out_stride, w, h, rx, ry) > aa_edge_contrast)
+			{
+				list[count++] = (ry << 16) | rx;
+			}
+		}
+	}
+	return count;
+}
+
+// Anti-aliasing sample patterns, as offsets from each pixel's centre; rotated grid for 4x, the standard 8x pattern (in 1/16ths) for 8x
+struct aa_offset
+{
+	float x;
+	float y;
+};
+static constexpr aa_offset aa_pattern_4x[] = { { -0.125f, -0.375f }, { 0.375f, -0.125f }, { 0.125f, 0.375f }, { -0.375f, 0.125f } };
+static constexpr aa_offset aa_pattern_8x[] = { { 0.0625f, -0.1875f }, { -0.0625f, 0.1875f }, { 0.3125f, 0.0625f }, { -0.1875f, -0.3125f },
+											   { -0.3125f, 0.3125f }, { -0.4375f, -0.0625f }, { 0.1875f, 0.4375f }, { 0.4375f, -0.4375f } };
+
+// Re-shade the [count] edge pixels on [list] (see [find_edges]) at every offset of [aa_mode]'s pattern, handing each offset to the kernel
+// through [simple_tiling_utils::sample_jitter], then resolve them in place
+// Pixels' first samples (whatever the pass already wrote) always weigh 1; box-filtered samples weigh 1 as well, while tent-filtered ones
+// spread out to twice the pixel's width and weigh (1 - |x|)(1 - |y|). Channels are summed as floats, eight pixels at a time
+uint64_t shade_edges(uint32_t tile_id, simple_tiling_utils::draw_job wrapped_job, const tile_region& region, uint32_t* out_origin, uint32_t out_stride,
+					 const uint32_t* list, uint32_t count)
+{
+	ZoneScoped;
+	XThreadWrapper::data& tileInfo = tile_data[tile_id].threadData;
+	const bool eight_samples = (aa_mode == simple_tiling_utils::AA_ADAPTIVE_8X);
+	const aa_offset* pattern = eight_samples ? aa_pattern_8x : aa_pattern_4x;
+	const uint32_t num_offsets = eight_samples ? 8 : 4;
+	const float spread = (aa_filter == simple_tiling_utils::AA_TENT_FILTER) ? 2.0f : 1.0f;
+	float weights[8] = {};
+	float total_weight = 1.0f;
+	for (uint32_t s = 0; s < num_offsets; s++)
+	{
+		weights[s] = (spread > 1.0f) ? (1.0f - std::abs(pattern[s].x * spread)) * (1.0f - std::abs(pattern[s].y * spread)) : 1.0f;
+		total_weight += weights[s];
+	}
+	const __m256 inv_weight = _mm256_set1_ps(1.0f / total_weight);
+
+	const __m256i lane_ids = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+	const __m256i channel_mask = _mm256_set1_epi32(0xff);
+	const __m256i coord_mask = _mm256_set1_epi32(0xffff);
+	auto channel = [&](__m256i colors, int shift)
+	{
+		return _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(colors, shift), channel_mask));
+	};
+
+	uint64_t num_batches = 0;
+	for (uint32_t i = 0; i < count; i += NUM_VECTOR_LANES)
+	{
+		// Lists have a vector's worth of room past their last entry, so the last batch loads whole and repeats its last pixel from there
+		const uint32_t valid_lanes = std::min(count - i, static_cast<uint32_t>(NUM_VECTOR_LANES));
+		const __m256i listed = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(list + i));
+		const __m256i coords = _mm256_permutevar8x32_epi32(listed, _mm256_min_epi32(lane_ids, _mm256_set1_epi32(static_cast<int>(valid_lanes - 1))));
+		const __m256i rx = _mm256_and_si256(coords, coord_mask);
+		const __m256i ry = _mm256_srli_epi32(coords, 16);
+		const __m256i offsets = _mm256_add_epi32(_mm256_mullo_epi32(ry, _mm256_set1_epi32(static_cast<int>(out_stride))), rx);
+		const __m256 pixels = _mm256_cvtepi32_ps(_mm256_add_epi32(_mm256_mullo_epi32(_mm256_add_epi32(ry, _mm256_set1_epi32(static_cast<int>(region.minY))),
+																					  _mm256_set1_epi32(static_cast<int>(canvas_width))),
+																	_mm256_add_epi32(rx, _mm256_set1_epi32(static_cast<int>(region.minX)))));
+
+		const __m256i first = _mm256_i32gather_epi32(reinterpret_cast<const int*>(out_origin), offsets, sizeof(uint32_t));
+		__m256 r = channel(first, 16);
+		__m256 g = channel(first, 8);
+		__m256 b = channel(first, 0);
+		for (uint32_t s = 0; s < num_offsets; s++)
+		{
+			tileInfo.jitter.x = pattern[s].x * spread;
+			tileInfo.jitter.y = pattern[s].y * spread;
+			tileInfo.jitter.sample_index = s + 1;
+
+			simple_tiling_utils::color_batch colors;
+			wrapped_job(pixels, tile_id, &colors);
+			const __m256i sample = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(colors.colors8bpc));
+			const __m256 weight = _mm256_set1_ps(weights[s]);
+			r = _mm256_fmadd_ps(channel(sample, 16), weight, r);
+			g = _mm256_fmadd_ps(channel(sample, 8), weight, g);
+			b = _mm256_fmadd_ps(channel(sample, 0), weight, b);
+		}
+
+		// Alpha comes from the first sample
+		const __m256i resolved = _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(first, _mm256_set1_epi32(static_cast<int>(0xff000000))),
+																 _mm256_slli_epi32(_mm256_cvtps_epi32(_mm256_mul_ps(r, inv_weight)), 16)),
+												 _mm256_or_si256(_mm256_slli_epi32(_mm256_cvtps_epi32(_mm256_mul_ps(g, inv_weight)), 8),
+																 _mm256_cvtps_epi32(_mm256_mul_ps(b, inv_weight))));
+		alignas(32) uint32_t lane_offsets[NUM_VECTOR_LANES];
+		alignas(32) uint32_t lane_colors[NUM_VECTOR_LANES];
+		_mm256_store_si256(reinterpret_cast<__m256i*>(lane_offsets), offsets);
+		_mm256_store_si256(reinterpret_cast<__m256i*>(lane_colors), resolved);
+		for (uint32_t j = 0; j < valid_lanes; j++)
+		{
+			out_origin[lane_offsets[j]] = lane_colors[j];
+		}
+		num_batches += num_offsets;
+	}
+	tileInfo.jitter = {};
+	return num_batches;
+}
+
+void draw_wrapper(uint32_t tile_id, simple_tiling_utils::draw_job wrapped_job, const simple_tiling_utils::damage_list* damage, uint32_t render_level,
+				  simple_tiling_utils::DRAW_JOB_TYPES draw_type)
+{
+	ZoneScoped;
+	XThreadWrapper::data& tileInfo = tile_data[tile_id].threadData;
+	const tile_region* regions = tile_regions + tileInfo.first_region;
+	const uint32_t num_regions = tileInfo.num_regions;
+	const uint32_t parity = tileInfo.checker_parity;
+
+	tileInfo.tile_state = simple_tiling_utils::PROCESSING;
+
+	// Fused chains run through [shade_fused] (8bpc) or [shade_fused_hdr] (HDR); from here on they're just another plain/HDR job
+	if (draw_type == simple_tiling_utils::FUSED_DRAW_JOB)
+	{
+		const simple_tiling_utils::fused_chain* chain = reinterpret_cast<const simple_tiling_utils::fused_chain*>(wrapped_job);
+		tileInfo.fused_chain = chain;
+		wrapped_job = chain->hdr ? reinterpret_cast<simple_tiling_utils::draw_job>(shade_fused_hdr) : shade_fused;
+		draw_type = chain->hdr ? simple_tiling_utils::HDR_DRAW_JOB : simple_tiling_utils::PLAIN_DRAW_JOB;
+	}
+
+	// Same for inlined jobs, through [shade_inlined]; [shade_block] spots that, and runs the job's own block loop instead
+	if (draw_type == simple_tiling_utils::INLINED_DRAW_JOB)
+	{
+		tileInfo.inlined_job = reinterpret_cast<const simple_tiling_utils::inlined_draw_job*>(wrapped_job);
+		wrapped_job = shade_inlined;
+		draw_type = simple_tiling_utils::PLAIN_DRAW_JOB;
+	}
+
+	// Span jobs as well, through [shade_span]
+	// Their signature has nothing in common with [draw_job]'s, so they go back through void(*)() (the generic function pointer type) on the way out
+	const bool span = (draw_type == simple_tiling_utils::SPAN_DRAW_JOB);
+	if (span)
+	{
+		tileInfo.span_job = reinterpret_cast<simple_tiling_utils::span_draw_job>(reinterpret_cast<void(*)()>(wrapped_job));
+		wrapped_job = shade_span;
+		draw_type = simple_tiling_utils::PLAIN_DRAW_JOB;
+	}
+	const bool hdr = (draw_type == simple_tiling_utils::HDR_DRAW_JOB);
+
+	// HDR jobs go through [shade_tonemapped] wherever something needs a plain draw job; buffered + accumulated passes call them directly
+	const simple_tiling_utils::hdr_draw_job hdr_job = hdr ? reinterpret_cast<simple_tiling_utils::hdr_draw_job>(wrapped_job) : nullptr;
+	if (hdr)
+	{
+		tileInfo.hdr_job = hdr_job;
+		wrapped_job = shade_tonemapped;
+	}
+
+	// Every pass marks pixels into one of our lists from scratch (see [simple_tiling::mark_pixels]), and sparse passes shade the other one
+	// (whatever the previous pass marked); from here on, sparse passes are damage-driven passes that happen to have no rects
+	const uint32_t marked_list = tileInfo.marked_list;
+	const uint32_t* sparse_list = pixel_lists[tile_id][marked_list ^ 1];
+	const uint32_t sparse_count = tileInfo.list_counts[marked_list ^ 1];
+	tileInfo.list_counts[marked_list] = 0;
+	bool sparse = (damage != nullptr) && damage->sparse;
+
+	// Resolve the destination for this pass
+	// Tile-buffer output renders into scratch and copies out at the end; direct/external output renders in place, so we need our swap-chain
+	// slot up-front (and that's also where we wait if we're a whole frame ahead of the other tiles)
+	const simple_tiling_utils::OUTPUT_MODES pass_output = output_mode;
+	const bool padded_output = (pass_output == simple_tiling_utils::TILE_BUFFER_OUTPUT);
+	uint32_t* write_buffer = nullptr;
+	if (pass_output != simple_tiling_utils::TILE_BUFFER_OUTPUT)
+	{
+		write_buffer = tile_swap_chain.begin_copy(tileInfo.swap_generation, tileInfo.tile_running);
+		if (write_buffer == nullptr)
+		{
+			return; // Shutting down
+		}
+	}
+
+	// Accumulating tiles average a new sample into every pixel each full pass (see [shade_accumulated]); scene changes, reduced-resolution
+	// passes + damage touching the tile all invalidate the average, and new averages need every pixel, so damage-driven passes turn into
+	// full ones whenever we're starting over. So does switching between HDR + 8bpc jobs, since their sums aren't in the same units
+	bool accumulate = false;
+	if (accumulating)
+	{
+		const uint32_t epoch = accumulation_epoch.load(std::memory_order_acquire);
+		bool restart = (render_level > 0) || (tileInfo.accum_epoch != epoch) || (tileInfo.accum_hdr != hdr);
+		for (uint32_t r = 0; (r < num_regions) && (damage != nullptr); r++)
+		{
+			uint32_t y0 = 0;
+			uint32_t y1 = 0;
+			restart = restart || region_pass_rows(regions[r], damage, y0, y1);
+		}
+		restart = restart || (sparse && sparse_count > 0);
+
+		if (restart)
+		{
+			tileInfo.accum_samples.store(0, std::memory_order_relaxed);
+			tileInfo.accum_epoch = epoch;
+			tileInfo.accum_hdr = hdr;
+		}
+		accumulate = (render_level == 0) && ((damage == nullptr) || (tileInfo.accum_samples.load(std::memory_order_relaxed) == 0));
+		damage = accumulate ? nullptr : damage;
+		sparse = sparse && !accumulate;
+	}
+
+	// Accumulated samples jitter across the pixel (apart from the first one), following a 2D Halton sequence; past [accumulation_max_samples]
+	// we stop shading, and just write the average out again
+	const uint32_t prev_samples = tileInfo.accum_samples.load(std::memory_order_relaxed);
+	const bool accumulate_sample = accumulate && (prev_samples < accumulation_max_samples);
+	const uint32_t num_samples = accumulate_sample ? (prev_samples + 1) : prev_samples;
+	tileInfo.jitter = {};
+	if (accumulate_sample && prev_samples > 0)
+	{
+		tileInfo.jitter.x = halton(prev_samples, 2) - 0.5f;
+		tileInfo.jitter.y = halton(prev_samples, 3) - 0.5f;
+		tileInfo.jitter.sample_index = prev_samples;
+	}
+
+	// Reprojected passes (see [shade_reprojected]) read the previous frame from every tile, so they need every tile to have stored its part
+	// of it first. Tiles never get more than a frame apart (the swap-chain holds them back), so once that's true, the frame stays put until
+	// we're done; otherwise, we just shade everything this time
+	const simple_tiling_utils::reprojection_job pass_reprojection = reprojection;
+	const uint32_t history_pass = tileInfo.history_passes.load(std::memory_order_relaxed);
+	bool reproject = (pass_reprojection != nullptr) && !accumulate && (damage == nullptr) && (render_level == 0) && (history_pass > 0);
+	for (uint32_t i = 0; (i < numTiles) && reproject; i++)
+	{
+		reproject = tile_data[i].threadData.history_passes.load(std::memory_order_acquire) >= history_pass;
+	}
+
+	// Interlacing renders a checkerboard; half the pixels per pass, alternating every pass, with the other half reconstructed from their
+	// neighbours + the previous frame (see [resolve_checkerboard])
+	// That needs the previous frame's kernel output, which only tile scratch keeps around (direct/external output overwrite it in place), and
+	// freshly carved scratch holds nothing at all, so those passes render everything instead
+	// Reduced-resolution passes shade few enough pixels already, so they always render a full (coarse) frame
+	// Variable-rate passes already cut most of their shading in flat areas, and checkerboards would smear their coarse blocks further, so
+	// those render a full frame as well; damage-driven + reduced-resolution passes always shade at full rate (see [simple_tiling::set_shading_rates])
+	// Accumulation wants every sample of every pixel, and reprojection already skips most of them, so they skip both
+	// Span jobs shade whole runs of pixels, so half of every run would cost as much as all of it; their checkerboards alternate eight-pixel
+	// cells instead (see [shade_span_checkerboard_row])
+	// Anti-aliasing re-shades edges out of every freshly shaded region (see [find_edges]), so it needs real kernel output at every pixel; it
+	// takes priority over both as well
+	const bool resolving = interlacing && (pass_output == simple_tiling_utils::TILE_BUFFER_OUTPUT);
+	const bool antialias = (aa_mode != simple_tiling_utils::AA_OFF) && !accumulate && !reproject && (damage == nullptr) && (render_level == 0);
+	const bool rated = !accumulate && !reproject && !antialias && (shading_rate_mode != simple_tiling_utils::FULL_RATE_SHADING) && (damage == nullptr) &&
+					   (render_level == 0);
+	const bool interlaced = resolving && !accumulate && !reproject && !rated && !antialias && (damage == nullptr) && tileInfo.history_valid &&
+							(render_level == 0);
+
+	// Buffered HDR output only covers plain full-rate shading (see [shade_hdr_block]); everything else tonemaps per batch
+	const bool hdr_buffered = hdr && (hdr_format != simple_tiling_utils::HDR_UNBUFFERED);
+
+	// Full passes are timed for adaptive tiling; damage-driven passes cover arbitrary subsets of the tile, so they'd only skew its cost
+	const auto shade_start_t = std::chrono::steady_clock::now();
+	uint64_t num_batches = 0;
+	uint64_t upscale_ns = 0;
+	uint64_t rate_blocks[3] = {};
+	uint64_t pixels_reused = 0;
+	uint64_t aa_pixels = 0;
+	for (uint32_t r = 0; r < num_regions; r++)
+	{
+		const tile_region& region = regions[r];
+		uint32_t out_stride = 0;
+		uint32_t* out_origin = region_output(tile_id, region, pass_output, write_buffer, out_stride);
+		if (render_level > 0)
+		{
+			// Damage-driven work is always submitted at native resolution, so this is a full pass
+			num_batches += shade_upscaled(tile_id, wrapped_job, region, render_level, out_origin, out_stride, padded_output, upscale_ns);
+			if (resolving)
+			{
+				resolve_rows(out_origin, resolveBuffers[tile_id] + region.scratch_offset, region, region.minY, region.maxY);
+			}
+			continue;
+		}
+
+		if (damage == nullptr)
+		{
+			uint8_t* motion = interlaced ? checker_motion[tile_id] + region.motion_offset : nullptr;
+			if (accumulate)
+			{
+				num_batches += shade_accumulated(tile_id, wrapped_job, hdr_job, region, out_origin, out_stride, padded_output, accum_buffers[tile_id] + (region.scratch_offset * 3),
+												 num_samples, accumulate_sample);
+			}
+			else if (reproject)
+			{
+				num_batches += shade_reprojected(tile_id, wrapped_job, pass_reprojection, region, out_origin, out_stride, padded_output,
+												 history_frames[(history_pass - 1) % num_history_frames], pixels_reused);
+			}
+			else if (rated)
+			{
+				num_batches += shade_rated(tile_id, wrapped_job, region, out_origin, out_stride, padded_output, tileInfo.rate_refresh_phase, rate_blocks);
+			}
+			else if (hdr_buffered && !interlaced)
+			{
+				num_batches += shade_hdr_block(tile_id, hdr_job, region, out_origin, out_stride, padded_output, region.minX, region.maxX, region.minY, region.maxY);
+			}
+			else
+			{
+				num_batches += shade_block(tile_id, wrapped_job, out_origin, out_stride, region.minX, region.minY, region.minX, region.maxX, region.minY, region.maxY,
+										   motion, parity, padded_output);
+			}
+			if (antialias)
+			{
+				const uint32_t num_edges = find_edges(out_origin, out_stride, region, edge_lists[tile_id]);
+				num_batches += shade_edges(tile_id, wrapped_job, region, out_origin, out_stride, edge_lists[tile_id], num_edges);
+				aa_pixels += num_edges;
+			}
+			if (interlaced)
+			{
+				resolve_checkerboard(out_origin, resolveBuffers[tile_id] + region.scratch_offset, region, parity, motion, span);
+			}
+			else if (resolving)
+			{
+				resolve_rows(out_origin, resolveBuffers[tile_id] + region.scratch_offset, region, region.minY, region.maxY);
+			}
+			continue;
+		}
+
+		// Damage-driven pass; bring direct output up to date first (see [carry_forward_region])
+		if (pass_output == simple_tiling_utils::DIRECT_OUTPUT)
+		{
+			carry_forward_region(tile_id, region, write_buffer);
+		}
+
+		// Clip damage against the region, widening each rect out to whole batches
+		// Regions outside the damage set shade nothing, but their tiles still copy out below; the swap-chain can't publish a frame with pieces missing
+		// Damaged pixels are shaded in full; half-refreshing an area the host explicitly asked for would just leave it stale for another frame
+		for (uint32_t i = 0; i < damage->num_rects; i++)
+		{
+			uint32_t clip_x0 = 0;
+			uint32_t clip_x1 = 0;
+			uint32_t y0 = 0;
+			uint32_t y1 = 0;
+			if (clip_damage_rect(region, damage->rects[i], clip_x0, clip_x1, y0, y1))
+			{
+				if (hdr_buffered)
+				{
+					num_batches += shade_hdr_block(tile_id, hdr_job, region, out_origin, out_stride, padded_output, clip_x0, clip_x1, y0, y1);
+				}
+				else
+				{
+					num_batches += shade_block(tile_id, wrapped_job, out_origin, out_stride, region.minX, region.minY, clip_x0, clip_x1, y0, y1, nullptr, 0, padded_output);
+				}
+			}
+		}
+
+		uint32_t y0 = 0;
+		uint32_t y1 = 0;
+		if (resolving && region_pass_rows(region, damage, y0, y1))
+		{
+			resolve_rows(out_origin, resolveBuffers[tile_id] + region.scratch_offset, region, y0, y1);
+		}
+	}
+
+	// Listed pixels can come from any region, so sparse passes shade once every region is ready for them
+	if (sparse)
+	{
+		const bool track_spans = dirty_tracking && (pass_output != simple_tiling_utils::EXTERNAL_OUTPUT) && (num_post_effects == 0);
+		num_batches += shade_sparse(tile_id, wrapped_job, sparse_list, sparse_count, pass_output, write_buffer, resolving,
+									(num_post_effects > 0 && tileInfo.post_source_valid) ? post_canvases[0] : nullptr,
+									track_spans ? sparse_spans + (static_cast<uint64_t>(tile_id) * spans_per_tile) : nullptr);
+		tileInfo.sparse_pixels.fetch_add(sparse_count, std::memory_order_relaxed);
+	}
+
+	// Whatever this pass marked is what the next sparse pass shades
+	tileInfo.listed_pixels.store(tileInfo.list_counts[marked_list], std::memory_order_relaxed);
+	tileInfo.marked_list = static_cast<uint8_t>(marked_list ^ 1);
+	tileInfo.bytes_shaded.fetch_add(num_batches * sizeof(simple_tiling_utils::color_batch), std::memory_order_relaxed);
+	if (accumulate)
+	{
+		tileInfo.accum_samples.store(num_samples, std::memory_order_relaxed);
+	}
+
+	// Post-processing reads the unprocessed frame from [post_canvases], so store whatever this pass shaded there (everything, for full passes +
+	// tiles that haven't stored a whole frame yet; sparse passes store their own pixels, see [shade_sparse])
+	if (num_post_effects > 0)
+	{
+		for (uint32_t r = 0; r < num_regions; r++)
+		{
+			const tile_region& region = regions[r];
+			uint32_t src_stride = 0;
+			const uint32_t* src = region_output(tile_id, region, pass_output, write_buffer, src_stride);
+			if (pass_output == simple_tiling_utils::TILE_BUFFER_OUTPUT)
+			{
+				src = region_unprocessed(tile_id, region);
+			}
+
+			if (damage == nullptr || !tileInfo.post_source_valid)
+			{
+				store_post_source(src, src_stride, region, region.minX, region.maxX, region.minY, region.maxY);
+			}
+			else
+			{
+				for (uint32_t i = 0; i < damage->num_rects; i++)
+				{
+					uint32_t x0 = 0;
+					uint32_t x1 = 0;
+					uint32_t y0 = 0;
+					uint32_t y1 = 0;
+					if (clip_damage_rect(region, damage->rects[i], x0, x1, y0, y1))
+					{
+						store_post_source(src, src_stride, region, x0, x1, y0, y1);
+					}
+				}
+			}
+			pad_post_region(post_canvases[0], region);
+		}
+		tileInfo.post_source_valid = true;
+	}
+
+	if (pass_reprojection != nullptr)
+	{
+		// Every pass lands in history (whatever kind it was), so the next one always has a whole frame to reproject from
+		uint64_t tile_px = 0;
+		for (uint32_t r = 0; r < num_regions; r++)
+		{
+			store_history(tile_id, regions[r], pass_output, write_buffer, history_frames[history_pass % num_history_frames]);
+			tile_px += static_cast<uint64_t>(regions[r].maxX - regions[r].minX) * (regions[r].maxY - regions[r].minY);
+		}
+		tileInfo.history_passes.store(history_pass + 1, std::memory_order_release);
+
+		if (damage == nullptr && render_level == 0 && !accumulate)
+		{
+			tileInfo.pixels_reused.fetch_add(pixels_reused, std::memory_order_relaxed);
+			tileInfo.pixels_reshaded.fetch_add(tile_px - pixels_reused, std::memory_order_relaxed);
+			tileInfo.last_pixels_reused.store(pixels_reused, std::memory_order_relaxed);
+			tileInfo.last_pixels_reshaded.store(tile_px - pixels_reused, std::memory_order_relaxed);
+		}
+	}
+	if (antialias)
+	{
+		tileInfo.aa_pixels.fetch_add(aa_pixels, std::memory_order_relaxed);
+	}
+	if (rated)
+	{
+		for (uint32_t i = 0; i < 3; i++)
+		{
+			tileInfo.rate_blocks[i].fetch_add(rate_blocks[i], std::memory_order_relaxed);
+		}
+	}
+	if (damage == nullptr)
+	{
+		tileInfo.history_valid = (pass_output == simple_tiling_utils::TILE_BUFFER_OUTPUT);
+		const auto shade_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - shade_start_t).count();
+		tileInfo.draw_ns.fetch_add(shade_ns, std::memory_order_relaxed);
+		tileInfo.draw_passes.fetch_add(1, std::memory_order_relaxed);
+		tileInfo.last_draw_level.store(render_level, std::memory_order_relaxed);
+		tileInfo.last_upscale_ns.store(upscale_ns, std::memory_order_relaxed);
+		tileInfo.last_draw_ns.store(shade_ns, std::memory_order_release);
+	}
+
+	// Effects wait on every other tile between stages, so they stay out of the timings above (adaptive tiling would see perfectly even tiles)
+	if (num_post_effects > 0)
+	{
+		run_post_effects(tile_id, pass_output, write_buffer);
+	}
+
+	// No reason to execute copy-outs if tiling has been stopped anyway
+	if (tileInfo.tile_running)
+	{
+		// Signal the main thread that this tile is uploading
+		tileInfo.tile_state = simple_tiling_utils::UPLOADING;
+
+		// Hash whatever this pass touched; for tile-buffer output that's before waiting on the swap-chain, since scratch is ours alone
+		// (direct output has nothing to copy, but the presenter still benefits from knowing which spans changed)
+		// Post-processing rewrites whole regions, and halos spread damage past its rects, so those passes hash everything; sparse passes only
+		// hash the spans their listed pixels landed in (see [shade_sparse]), so untouched spans keep their versions and skip the copy-out below
+		if (dirty_tracking && pass_output != simple_tiling_utils::EXTERNAL_OUTPUT)
+		{
+			uint8_t* touched_spans = sparse_spans + (static_cast<uint64_t>(tile_id) * spans_per_tile);
+			for (uint32_t r = 0; r < num_regions; r++)
+			{
+				const tile_region& region = regions[r];
+				uint32_t out_stride = 0;
+				const uint32_t* out_origin = region_output(tile_id, region, pass_output, write_buffer, out_stride);
+				if (pass_output == simple_tiling_utils::TILE_BUFFER_OUTPUT)
+				{
+					out_origin = region_resolved(tile_id, region);
+				}
+
+				if (sparse && num_post_effects == 0)
+				{
+					// Hash runs of touched spans at a time
+					uint8_t* region_spans = touched_spans + region.span_offset;
+					const uint32_t num_spans = region_num_spans(region);
+					uint32_t s = 0;
+					while (s < num_spans)
+					{
+						if (region_spans[s] == 0)
+						{
+							s++;
+							continue;
+						}
+
+						const uint32_t run_start = s;
+						while (s < num_spans && region_spans[s] != 0)
+						{
+							region_spans[s++] = 0;
+						}
+						update_span_versions(tile_id, region, out_origin, out_stride, run_start, s);
+					}
+					continue;
+				}
+
+				uint32_t y0 = 0;
+				uint32_t y1 = 0;
+				if (region_pass_rows(region, ((num_post_effects > 0) || sparse) ? nullptr : damage, y0, y1))
+				{
+					update_span_versions(tile_id, region, out_origin, out_stride, (y0 - region.minY) / dirty_span_rows,
+										 ((y1 - region.minY) + dirty_span_rows - 1) / dirty_span_rows);
+				}
+			}
+
+			if (pass_output == simple_tiling_utils::DIRECT_OUTPUT)
+			{
+				memcpy(held_span_versions(tile_swap_chain.write_ndx, tile_id), span_versions + (static_cast<uint64_t>(tile_id) * spans_per_tile), sizeof(uint32_t) * spans_per_tile);
+			}
+		}
+
+		// Run back-buffer copies on source threads to prevent them stumbling over each other
+		// Every pass copies out (in tile-buffer mode); the swap chain decides which buffer we land in, and holds us back if we're a whole frame ahead
+		if (pass_output == simple_tiling_utils::TILE_BUFFER_OUTPUT)
+		{
+			write_buffer = tile_swap_chain.begin_copy(tileInfo.swap_generation, tileInfo.tile_running);
+			if (write_buffer != nullptr)
+			{
+				for (uint32_t r = 0; r < num_regions; r++)
+				{
+					copy_out_region(tile_id, regions[r], write_buffer);
+				}
+			}
+		}
+
+		if (write_buffer != nullptr)
+		{
+			tile_swap_chain.end_copy(tileInfo.swap_generation, numTiles);
+			tileInfo.copy_outs++;
+			tileInfo.copy_outs.notify_all();
+		}
+
+		// Signal the main thread that we've finished copying-out this tile
+		tileInfo.tile_state = simple_tiling_utils::IDLE;
+		tileInfo.tile_state.notify_one();
+	}
+}
+
+void update_wrapper(uint32_t tile_id, simple_tiling_utils::update_job wrapped_job)
+{
+	ZoneScoped;
+	XThreadWrapper::data& tileInfo = tile_data[tile_id].threadData;
+	if (tileInfo.tile_running) // Avoid starting new jobs on terminated tiles
+	{
+		tileInfo.tile_state = simple_tiling_utils::PROCESSING; // No loops or swapchains - totes safe to enter PROCESSING on job start and return to IDLE on job resolve ( / wrapper return)
+		wrapped_job(tile_id); // Updates are expected to take their tile index, but nothing else/
+		tileInfo.tile_state = simple_tiling_utils::IDLE; // No loops or swapchains, so tiles go straight back to IDLE after completing
+	}
+}
+
+// Post-processing tiles wait on each other mid-pass (see [post_barrier]), so every draw pass needs every tile while effects are set; masked
+// submissions go to every tile instead, since tiles that got the job would otherwise wait forever on the ones that didn't
+uint64_t draw_tile_mask(uint64_t tile_mask)
+{
+	return (num_post_effects > 0) ? UINT64_MAX : tile_mask;
+}
+
+void simple_tiling::submit_draw_work(simple_tiling_utils::draw_job work, simple_tiling_utils::TASK_SYNC_TYPE sync_mode, uint64_t tile_mask)
+{
+	ZoneScoped;
+	tile_mask = draw_tile_mask(tile_mask);
+	tile_jobs.append_job(work, numTiles, simple_tiling_utils::DRAW_WORK, sync_mode, tile_mask, 0, render_level);
+}
+
+void simple_tiling::submit_draw_work_damaged(simple_tiling_utils::draw_job work, const simple_tiling_utils::damage_rect* rects, uint32_t num_rects,
+											 simple_tiling_utils::TASK_SYNC_TYPE sync_mode, uint64_t tile_mask)
+{
+	ZoneScoped;
+	tile_mask = draw_tile_mask(tile_mask);
+	if (num_rects == 0)
+	{
+		return; // Nothing damaged, nothing to draw
+	}
+	const uint32_t damage_slot = tile_jobs.push_damage(rects, num_rects, numTiles);
+	tile_jobs.append_job(work, numTiles, simple_tiling_utils::DRAW_WORK, sync_mode, tile_mask, damage_slot);
+}
+
+void simple_tiling::submit_hdr_draw_work(simple_tiling_utils::hdr_draw_job work, simple_tiling_utils::TASK_SYNC_TYPE sync_mode, uint64_t tile_mask)
+{
+	ZoneScoped;
+	tile_mask = draw_tile_mask(tile_mask);
+	tile_jobs.append_job(work, numTiles, simple_tiling_utils::DRAW_WORK, sync_mode, tile_mask, 0, render_level);
+}
+
+void simple_tiling::submit_hdr_draw_work_damaged(simple_tiling_utils::hdr_draw_job work, const simple_tiling_utils::damage_rect* rects, uint32_t num_rects,
+												 simple_tiling_utils::TASK_SYNC_TYPE sync_mode, uint64_t tile_mask)
+{
+	ZoneScoped;
+	tile_mask = draw_tile_mask(tile_mask);
+	if (num_rects == 0)
+	{
+		return;
+	}
+	const uint32_t damage_slot = tile_jobs.push_damage(rects, num_rects, numTiles);
+	tile_jobs.append_job(work, numTiles, simple_tiling_utils::DRAW_WORK, sync_mode, tile_mask, damage_slot);
+}
+
+void simple_tiling::submit_fused_draw_work(const simple_tiling_utils::fused_chain& chain, simple_tiling_utils::TASK_SYNC_TYPE sync_mode, uint64_t tile_mask)
+{
+	ZoneScoped;
+	tile_mask = draw_tile_mask(tile_mask);
+	assert(chain.num_stages > 0 && chain.num_stages <= simple_tiling_utils::max_fused_stages);
+	tile_jobs.append_job(tile_jobs.push_chain(chain, numTiles), numTiles, simple_tiling_utils::DRAW_WORK, sync_mode, tile_mask, 0, render_level);
+}
+
+void simple_tiling::submit_fused_draw_work_damaged(const simple_tiling_utils::fused_chain& chain, const simple_tiling_utils::damage_rect* rects, uint32_t num_rects,
+												   simple_tiling_utils::TASK_SYNC_TYPE sync_mode, uint64_t tile_mask)
+{
+	ZoneScoped;
+	tile_mask = draw_tile_mask(tile_mask);
+	assert(chain.num_stages > 0 && chain.num_stages <= simple_tiling_utils::max_fused_stages);
+	if (num_rects == 0)
+	{
+		return; // Nothing damaged, nothing to draw
+	}
+	const uint32_t damage_slot = tile_jobs.push_damage(rects, num_rects, numTiles);
+	tile_jobs.append_job(tile_jobs.push_chain(chain, numTiles), numTiles, simple_tiling_utils::DRAW_WORK, sync_mode, tile_mask, damage_slot);
+}
+
+void simple_tiling::submit_span_draw_work(simple_tiling_utils::span_draw_job work, simple_tiling_utils::TASK_SYNC_TYPE sync_mode, uint64_t tile_mask)
+{
+	ZoneScoped;
+	tile_mask = draw_tile_mask(tile_mask);
+	tile_jobs.append_job(work, numTiles, simple_tiling_utils::DRAW_WORK, sync_mode, tile_mask, 0, render_level);
+}
+
+void simple_tiling::submit_span_draw_work_damaged(simple_tiling_utils::span_draw_job work, const simple_tiling_utils::damage_rect* rects, uint32_t num_rects,
+												  simple_tiling_utils::TASK_SYNC_TYPE sync_mode, uint64_t tile_mask)
+{
+	ZoneScoped;
+	tile_mask = draw_tile_mask(tile_mask);
+	if (num_rects == 0)
+	{
+		return; // Nothing damaged, nothing to draw
+	}
+	const uint32_t damage_slot = tile_jobs.push_damage(rects, num_rects, numTiles);
+	tile_jobs.append_job(work, numTiles, simple_tiling_utils::DRAW_WORK, sync_mode, tile_mask, damage_slot);
+}
+
+void simple_tiling::submit_inlined_draw_job(const simple_tiling_utils::inlined_draw_job& job, const simple_tiling_utils::damage_rect* rects, uint32_t num_rects,
+											simple_tiling_utils::TASK_SYNC_TYPE sync_mode, uint64_t tile_mask)
+{
+	ZoneScoped;
+	tile_mask = draw_tile_mask(tile_mask);
+	if (rects == nullptr)
+	{
+		tile_jobs.append_job(tile_jobs.push_inlined(job, numTiles), numTiles, simple_tiling_utils::DRAW_WORK, sync_mode, tile_mask, 0, render_level);
+		return;
+	}
+
+	if (num_rects == 0)
+	{
+		return; // Nothing damaged, nothing to draw
+	}
+	const uint32_t damage_slot = tile_jobs.push_damage(rects, num_rects, numTiles);
+	tile_jobs.append_job(tile_jobs.push_inlined(job, numTiles), numTiles, simple_tiling_utils::DRAW_WORK, sync_mode, tile_mask, damage_slot);
+}
+
+void simple_tiling::submit_sparse_draw_work(simple_tiling_utils::draw_job work, simple_tiling_utils::TASK_SYNC_TYPE sync_mode, uint64_t tile_mask)
+{
+	ZoneScoped;
+	tile_mask = draw_tile_mask(tile_mask);
+	tile_jobs.append_job(work, numTiles, simple_tiling_utils::DRAW_WORK, sync_mode, tile_mask, tile_jobs.push_sparse(numTiles));
+}
+
+void simple_tiling::mark_pixels(uint32_t tile_id, __m256 pixels, __m256i lane_mask)
+{
+	XThreadWrapper::data& tileInfo = tile_data[tile_id].threadData;
+	uint32_t* list = pixel_lists[tile_id][tileInfo.marked_list];
+	if (list == nullptr)
+	{
+		return; // Pixel lists are switched off
+	}
+
+	// Partial batches repeat their last pixel in every spare lane; only the first copy makes the list
+	const __m256i px = _mm256_cvtps_epi32(pixels);
+	const __m256i prev_px = _mm256_permutevar8x32_epi32(px, _mm256_setr_epi32(0, 0, 1, 2, 3, 4, 5, 6));
+	const __m256i repeats = _mm256_andnot_si256(_mm256_setr_epi32(-1, 0, 0, 0, 0, 0, 0, 0), _mm256_cmpeq_epi32(px, prev_px));
+	const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_andnot_si256(repeats, lane_mask))));
+	if (mask == 0)
+	{
+		return;
+	}
+
+	// Lists have room for every pixel in the tile, so they only fill up when kernels mark the same pixels more than once
+	const uint32_t num_marked = static_cast<uint32_t>(std::popcount(mask));
+	uint32_t& count = tileInfo.list_counts[tileInfo.marked_list];
+	if ((count + NUM_VECTOR_LANES) > pixel_list_capacity[tile_id])
+	{
+		tileInfo.marks_dropped.fetch_add(num_marked, std::memory_order_relaxed);
+		return;
+	}
+
+	// Whatever lands past [num_marked] gets overwritten by the next call
+	count += compact_lanes(list + count, px, mask);
+}
+
+void simple_tiling::submit_update_work(simple_tiling_utils::update_job work, simple_tiling_utils::TASK_SYNC_TYPE sync_mode, uint64_t tile_mask)
+{
+	ZoneScoped;
+	tile_jobs.append_job(work, numTiles, simple_tiling_utils::UPDATE_WORK, sync_mode, tile_mask);
+}
+
+void simple_tiling::publish_frame_constants(const simple_tiling_utils::frame_constants& constants)
+{
+	tile_jobs.publish_frame(constants, numTiles);
+}
+
+const simple_tiling_utils::frame_constants& simple_tiling::GetFrameConstants(uint32_t tile_id)
+{
+	return tile_jobs.frame_snapshots[tile_jobs.running_frames[tile_id] % simple_tiling_utils::job_q::max_frame_snapshots];
+}
+
+void thread_main(uint32_t tile_ndx)
+{
+	uint32_t tick_ctr = 0;
+	XThreadWrapper::data& tile_info = tile_data[tile_ndx].threadData;
+	while (tile_info.tile_running)
+	{
+		// Consume draw jobs, then consume update jobs
+		// I don't *think* that should cause any issues
+		// (no reason updates drawing during an upload would be a problem, unless the user is intentionally trying to make the main/tile threads interfere with each other)
+		const uint32_t job_count = tile_jobs.front[tile_ndx];
+		if (job_count > 0)
+		{
+			simple_tiling_utils::WORK_TYPES last_job_type = simple_tiling_utils::UPDATE_WORK; // [consume_job] leaves this alone when there was nothing to run
+			tile_jobs.consume_job(tile_ndx, numTiles, &last_job_type);
+
+			// Only iterate interlacing for draw tasks - ignore for update work
+			if (last_job_type == simple_tiling_utils::DRAW_WORK)
+			{
+				tick_ctr++;
+				tile_info.checker_parity = tick_ctr % 2;
+				tile_info.rate_refresh_phase = tick_ctr % 8;
+			}
+		}
+		else
+		{
+			// Nothing queued; let whichever thread has work run instead (with more threads than cores, spinning here would hold up the
+			// tiles + host every pass is waiting on for a whole timeslice)
+			std::this_thread::yield();
+		}
+	}
+	tile_info.tile_shutdown_success = true;
+}
+
+uint32_t simple_tiling::GetNumTilesTotal()
+{
+	return numTiles;
+}
+
+uint32_t simple_tiling::GetNumTilesX()
+{
+	return numTilesX;
+}
+
+uint32_t simple_tiling::GetNumTilesY()
+{
+	return numTilesY;
+}
+
+static constexpr uint64_t mem_budget = 100000000;
+uint8_t* tiling_pool = nullptr;
+uint8_t* alloc_front = tiling_pool;
+template<typename t>
+t* alloc()
+{
+	t* ptr = reinterpret_cast<t*>(alloc_front);
+	alloc_front += sizeof(t);
+	return ptr;
+}
+
+template<typename t>
+t* alloc_array(uint64_t num_elts)
+{
+	t* ptr = reinterpret_cast<t*>(alloc_front);
+	alloc_front += sizeof(t) * num_elts;
+	return ptr;
+}
+
+// Forget every span's contents; the next pass copies everything, and the next present blits everything
+void reset_dirty_state()
+{
+	const uint64_t num_spans = static_cast<uint64_t>(spans_per_tile) * simple_tiling_utils::max_tiles;
+	memset(span_hashes, 0, sizeof(uint64_t) * num_spans);
+	memset(span_versions, 0, sizeof(uint32_t) * num_spans);
+	memset(buffer_span_versions, 0, sizeof(uint32_t) * num_spans * simple_tiling_utils::swap_chain::num_buffers);
+	std::fill(screen_span_versions, screen_span_versions + num_spans, unknown_screen_version);
+	memset(sparse_spans, 0, num_spans);
+}
+
+// Resolve the tile grid, each tile's canvas regions + its bounding rectangle for the current canvas + [tile_layout]
+// Square layouts try every factorization of [num_tiles] into columns * rows, and keep whichever gives the squarest tiles for the canvas' aspect
+// ratio (so 8 tiles on a 16:9 canvas become 4x2 rather than 2x4, and primes fall back to strips); strip layouts are always 1 x [num_tiles]. Tiles
+// cover every pixel; column boundaries sit on the batch grid, remainder batches/rows are spread across the grid, and only the right-most column
+// can end in a partial batch. Morton layouts deal out micro-tiles instead, see [layout_morton]
+void layout_grid(uint32_t num_tiles)
+{
+	const uint32_t canvas_batches = (canvas_width + NUM_VECTOR_LANES - 1) / NUM_VECTOR_LANES;
+	if (tile_layout == simple_tiling_utils::STRIP_TILES)
+	{
+		assert(num_tiles <= canvas_height); // Canvas too small for the requested tile count
+		numTilesX = 1;
+		numTilesY = num_tiles;
+	}
+	else
+	{
+		double best_score = DBL_MAX;
+		for (uint32_t cols = 1; cols <= num_tiles; cols++)
+		{
+			if ((num_tiles % cols) != 0)
+			{
+				continue;
+			}
+
+			// Every tile needs at least one batch + one row
+			const uint32_t rows = num_tiles / cols;
+			if (cols > canvas_batches || rows > canvas_height)
+			{
+				continue;
+			}
+
+			// Distance from square, in log-space so 2:1 and 1:2 score the same
+			const double tile_aspect = (static_cast<double>(canvas_width) / cols) / (static_cast<double>(canvas_height) / rows);
+			const double score = fabs(log(tile_aspect));
+			if (score < best_score)
+			{
+				best_score = score;
+				numTilesX = cols;
+				numTilesY = rows;
+			}
+		}
+		assert(best_score != DBL_MAX); // Canvas too small for the requested tile count
+	}
+
+	// Tiles are numbered column-by-column (tile [x * numTilesY + y]), same as always
+	uint32_t tileCtr = 0;
+	for (uint32_t x = 0; x < numTilesX; x++)
+	{
+		const uint32_t minBatch = (x * canvas_batches) / numTilesX;
+		const uint32_t maxBatch = ((x + 1) * canvas_batches) / numTilesX;
+		for (uint32_t y = 0; y < numTilesY; y++)
+		{
+			tile_region& region = tile_regions[tileCtr];
+			region.minX = minBatch * NUM_VECTOR_LANES;
+			region.maxX = std::min(maxBatch * NUM_VECTOR_LANES, canvas_width);
+			region.minY = (y * canvas_height) / numTilesY;
+			region.maxY = ((y + 1) * canvas_height) / numTilesY;
+
+			XThreadWrapper::data& tileInfo = tile_data[tileCtr].threadData;
+			tileInfo.first_region = tileCtr;
+			tileInfo.num_regions = 1;
+			tileCtr++;
+		}
+	}
+}
+
+// Morton layouts; cut the canvas into micro-tiles (32x32 where possible; larger on huge canvases so we stay under [max_regions], smaller on tiny
+// ones so every tile gets at least one), walk them along a Z-curve, and deal them round-robin to tiles
+// Neighbouring micro-tiles land on different tiles, so no single worker gets stuck with all of a scene's expensive pixels
+void layout_morton(uint32_t num_tiles)
+{
+	uint32_t micro_size = 32;
+	auto num_micro = [](uint32_t size) { return ((canvas_width + size - 1) / size) * ((canvas_height + size - 1) / size); };
+	while (num_micro(micro_size) > max_regions)
+	{
+		micro_size *= 2;
+	}
+
+	while (num_micro(micro_size) < num_tiles && micro_size > NUM_VECTOR_LANES)
+	{
+		micro_size /= 2; // Micro-tiles stay whole batches wide, so columns keep sitting on the batch grid
+	}
+	assert(num_micro(micro_size) >= num_tiles); // Canvas too small for the requested tile count
+
+	// Decode Morton indices over the smallest power-of-two grid covering the canvas, skipping anything off the edge
+	const uint32_t micro_cols = (canvas_width + micro_size - 1) / micro_size;
+	const uint32_t micro_rows = (canvas_height + micro_size - 1) / micro_size;
+	uint32_t grid_pow2 = 1;
+	while (grid_pow2 < std::max(micro_cols, micro_rows))
+	{
+		grid_pow2 *= 2;
+	}
+
+	std::vector<tile_region> micro_tiles;
+	micro_tiles.reserve(static_cast<size_t>(micro_cols) * micro_rows);
+	for (uint64_t m = 0; m < static_cast<uint64_t>(grid_pow2) * grid_pow2; m++)
+	{
+		uint32_t mx = 0;
+		uint32_t my = 0;
+		for (uint32_t b = 0; b < 16; b++)
+		{
+			mx |= static_cast<uint32_t>((m >> (2 * b)) & 1) << b;
+			my |= static_cast<uint32_t>((m >> ((2 * b) + 1)) & 1) << b;
+		}
+
+		if (mx < micro_cols && my < micro_rows)
+		{
+			tile_region micro = {};
+			micro.minX = mx * micro_size;
+			micro.maxX = std::min(micro.minX + micro_size, canvas_width);
+			micro.minY = my * micro_size;
+			micro.maxY = std::min(micro.minY + micro_size, canvas_height);
+			micro_tiles.push_back(micro);
+		}
+	}
+
+	// Deal micro-tiles out round-robin, then group them by tile so every tile's regions are contiguous
+	uint32_t region_ctr = 0;
+	for (uint32_t t = 0; t < num_tiles; t++)
+	{
+		XThreadWrapper::data& tileInfo = tile_data[t].threadData;
+		tileInfo.first_region = region_ctr;
+		for (uint32_t k = t; k < micro_tiles.size(); k += num_tiles)
+		{
+			micro_tile_regions[((micro_tiles[k].minY / micro_size) * micro_cols) + (micro_tiles[k].minX / micro_size)] = static_cast<uint16_t>(region_ctr);
+			tile_regions[region_ctr++] = micro_tiles[k];
+		}
+		tileInfo.num_regions = region_ctr - tileInfo.first_region;
+	}
+
+	micro_tile_px = micro_size;
+	micro_tile_cols = micro_cols;
+
+	// Tiles are scattered over the whole canvas, so there's no meaningful grid; report a single row of [num_tiles] tiles
+	numTilesX = num_tiles;
+	numTilesY = 1;
+}
+
+// Tile rectangles are the bounding boxes of their regions (the full canvas, more or less, for Morton layouts)
+void update_tile_bounds()
+{
+	for (uint32_t i = 0; i < numTiles; i++)
+	{
+		XThreadWrapper::data& tileInfo = tile_data[i].threadData;
+		tileInfo.tileMinX = UINT32_MAX;
+		tileInfo.tileMinY = UINT32_MAX;
+		tileInfo.tileMaxX = 0;
+		tileInfo.tileMaxY = 0;
+		for (uint32_t r = tileInfo.first_region; r < tileInfo.first_region + tileInfo.num_regions; r++)
+		{
+			tileInfo.tileMinX = std::min(tileInfo.tileMinX, tile_regions[r].minX);
+			tileInfo.tileMinY = std::min(tileInfo.tileMinY, tile_regions[r].minY);
+			tileInfo.tileMaxX = std::max(tileInfo.tileMaxX, tile_regions[r].maxX);
+			tileInfo.tileMaxY = std::max(tileInfo.tileMaxY, tile_regions[r].maxY);
+		}
+	}
+}
+
+void layout_tiles(uint32_t num_tiles)
+{
+	numTiles = num_tiles;
+	if (tile_layout == simple_tiling_utils::MORTON_TILES)
+	{
+		layout_morton(num_tiles);
+	}
+	else
+	{
+		layout_grid(num_tiles);
+	}
+	update_tile_bounds();
+}
+
+uint64_t tiling_pool_size = 0;
+void* presenter_backend_target = nullptr; // Kept around so [reconfigure] can re-create backend resources
+
+// Adaptive tiling (see [simple_tiling::set_adaptive_tiling]); measured costs live in a coarse map over the canvas, one cell per batch-wide
+// square of pixels, so re-partitioned column boundaries still sit on the batch grid
+static constexpr uint32_t cost_cell_px = NUM_VECTOR_LANES;
+bool adaptive_tiling = false;
+uint32_t adaptive_interval_frames = 60;
+float adaptive_threshold = 1.2f;
+uint32_t adaptive_frame_ctr = 0;
+bool awaiting_post_rebalance = false; // Next window's timings go into [max/mean_tile_us_after]
+uint32_t unbalanced_windows = 0; // Consecutive windows over [adaptive_threshold]; one slow window on its own is usually just noise
+float* cost_map = nullptr; // [cost_rows][cost_cols]; estimated draw time per cell, in microseconds
+bool cost_map_fresh = true; // No measurements yet; the next window overwrites instead of blending
+uint32_t cost_cols = 0;
+uint32_t cost_rows = 0;
+simple_tiling_utils::balance_stats balance_stats = {};
+
+// Motion flags + shading rates are bytes; keep whatever we carve after them cache-line aligned
+uint64_t tile_flag_bytes(uint64_t num_flags)
+{
+	return (num_flags + 63) & ~63ull;
+}
+
+// Entries in a pixel/edge list holding up to [tile_px] pixels; one vector spare for whole-vector stores (see [compact_lanes]), rounded up
+// to a cache line so whatever we carve after them stays aligned
+uint64_t pixel_list_entries(uint64_t tile_px)
+{
+	return (tile_px + NUM_VECTOR_LANES + 15) & ~15ull;
+}
+
+// Lay out per-region scratch, span, motion-flag + shading-rate offsets for the current regions; returns the tile memory they need
+uint64_t size_tile_memory()
+{
+	// Region dimensions vary by a batch/row or so across the grid (remainders are spread out), so size scratch + spans per-region
+	uint64_t tile_bytes = 0;
+	spans_per_tile = 0;
+	for (uint32_t i = 0; i < numTiles; i++)
+	{
+		XThreadWrapper::data& tileInfo = tile_data[i].threadData;
+		uint64_t scratch_px = 0;
+		uint64_t motion_flags = 0;
+		uint64_t rate_blocks = 0;
+		uint64_t upscale_px = 0;
+		uint64_t post_floats = 0;
+		uint64_t tile_px = 0;
+		uint64_t edge_px = 0;
+		tileInfo.num_spans = 0;
+		for (uint32_t r = tileInfo.first_region; r < tileInfo.first_region + tileInfo.num_regions; r++)
+		{
+			tile_region& region = tile_regions[r];
+			region.scratch_offset = scratch_px;
+			region.span_offset = tileInfo.num_spans;
+			region.motion_offset = motion_flags;
+			region.rate_offset = rate_blocks;
+			scratch_px += static_cast<uint64_t>(region_stride_px(region)) * (region.maxY - region.minY);
+			motion_flags += static_cast<uint64_t>(region_segments(region)) * (region.maxY - region.minY);
+			rate_blocks += static_cast<uint64_t>(region_rate_cols(region)) * region_rate_rows(region);
+			upscale_px = std::max(upscale_px, dynamic_resolution ? upscale_scratch_px(region) : 0);
+			post_floats = std::max(post_floats, (num_post_effects > 0) ? post_scratch_floats(region) : 0);
+			tile_px += static_cast<uint64_t>(region.maxX - region.minX) * (region.maxY - region.minY);
+			edge_px = std::max(edge_px, static_cast<uint64_t>(region.maxX - region.minX) * (region.maxY - region.minY));
+			tileInfo.num_spans += region_num_spans(region);
+		}
+		tile_bytes += (scratch_px * sizeof(uint32_t) * (interlacing ? 2 : 1)) + tile_flag_bytes(motion_flags) + tile_flag_bytes(rate_blocks) + (upscale_px * sizeof(uint32_t)) +
+					  (accumulating ? (scratch_px * sizeof(float) * 3) : 0) + (scratch_px * hdr_channel_bytes() * 3) +
+					  ((num_post_effects > 0) ? (scratch_px * sizeof(uint32_t)) : 0) + (post_floats * sizeof(float)) +
+					  (pixel_lists_enabled ? (pixel_list_entries(tile_px) * sizeof(uint32_t) * 2) : 0) +
+					  ((aa_mode != simple_tiling_utils::AA_OFF) ? (pixel_list_entries(edge_px) * sizeof(uint32_t)) : 0);
+		spans_per_tile = std::max(spans_per_tile, tileInfo.num_spans);
+	}
+	return tile_bytes;
+}
+
+uint64_t span_bytes(uint32_t num_spans_per_tile)
+{
+	return static_cast<uint64_t>(num_spans_per_tile) * simple_tiling_utils::max_tiles * (sizeof(uint64_t) + (sizeof(uint32_t) * (2 + simple_tiling_utils::swap_chain::num_buffers)) + sizeof(uint8_t));
+}
+
+// Carve tile scratch + dirty-tracking state out of [tiling_pool], from [tile_memory_front] onwards; call [size_tile_memory] first
+// Split from [prepare_tiling_memory] so adaptive tiling can move tile boundaries without touching the swap-chain
+uint8_t* tile_memory_front = nullptr;
+void carve_tile_memory()
+{
+	// Reprojection history + post-processing canvases are canvas-sized, so they go first; that way they stay put (along with their contents)
+	// whenever tiles move
+	alloc_front = tile_memory_front;
+	for (uint32_t i = 0; i < num_history_frames; i++)
+	{
+		history_frames[i] = (reprojection != nullptr) ? alloc_array<uint32_t>(static_cast<uint64_t>(canvas_width) * canvas_height) : nullptr;
+	}
+	for (uint32_t i = 0; i < num_post_canvases; i++)
+	{
+		post_canvases[i] = (i < num_post_effects) ? alloc_array<uint32_t>(post_canvas_px()) : nullptr; // One effect only needs the unprocessed frame, two need one more canvas
+	}
+	post_arrivals = 0; // Tiles stopped mid-barrier (see [stop_tiles]) can leave stale arrivals behind
+
+	for (uint32_t i = 0; i < numTiles; i++)
+	{
+		XThreadWrapper::data& tileInfo = tile_data[i].threadData;
+		tileInfo.history_valid = false; // Scratch just moved; nothing to reconstruct checkerboards from until the next full pass
+		tileInfo.accum_samples = 0; // Same for accumulated samples
+		uint64_t tile_area_vectors = 0;
+		uint64_t motion_flags = 0;
+		uint64_t rate_blocks = 0;
+		uint64_t upscale_px = 0;
+		uint64_t post_floats = 0;
+		uint64_t tile_px = 0;
+		uint64_t edge_px = 0;
+		for (uint32_t r = tileInfo.first_region; r < tileInfo.first_region + tileInfo.num_regions; r++)
+		{
+			tile_px += static_cast<uint64_t>(tile_regions[r].maxX - tile_regions[r].minX) * (tile_regions[r].maxY - tile_regions[r].minY);
+			edge_px = std::max(edge_px, static_cast<uint64_t>(tile_regions[r].maxX - tile_regions[r].minX) * (tile_regions[r].maxY - tile_regions[r].minY));
+			tile_area_vectors += (static_cast<uint64_t>(region_stride_px(tile_regions[r])) / NUM_VECTOR_LANES) * (tile_regions[r].maxY - tile_regions[r].minY);
+			post_floats = std::max(post_floats, post_scratch_floats(tile_regions[r]));
+			motion_flags += static_cast<uint64_t>(region_segments(tile_regions[r])) * (tile_regions[r].maxY - tile_regions[r].minY);
+			rate_blocks += static_cast<uint64_t>(region_rate_cols(tile_regions[r])) * region_rate_rows(tile_regions[r]);
+			upscale_px = std::max(upscale_px, upscale_scratch_px(tile_regions[r]));
+		}
+		tileBuffers[i] = alloc_array<simple_tiling_utils::color_batch>(tile_area_vectors);
+		resolveBuffers[i] = interlacing ? alloc_array<uint32_t>(tile_area_vectors * NUM_VECTOR_LANES) : nullptr;
+		checker_motion[i] = alloc_array<uint8_t>(tile_flag_bytes(motion_flags));
+		shading_rates[i] = alloc_array<uint8_t>(tile_flag_bytes(rate_blocks));
+		memset(shading_rates[i], simple_tiling_utils::RATE_1X1, rate_blocks); // Regions just moved, so measured rates no longer line up with them
+		upscale_scratch[i] = dynamic_resolution ? alloc_array<uint32_t>(upscale_px) : nullptr;
+		accum_buffers[i] = accumulating ? alloc_array<float>(tile_area_vectors * NUM_VECTOR_LANES * 3) : nullptr;
+		hdr_buffers[i] = (hdr_format != simple_tiling_utils::HDR_UNBUFFERED) ? alloc_array<uint8_t>(tile_area_vectors * NUM_VECTOR_LANES * 3 * hdr_channel_bytes()) : nullptr;
+		post_buffers[i] = (num_post_effects > 0) ? alloc_array<uint32_t>(tile_area_vectors * NUM_VECTOR_LANES) : nullptr;
+		post_scratch[i] = (num_post_effects > 0) ? alloc_array<float>(post_floats) : nullptr;
+		edge_lists[i] = (aa_mode != simple_tiling_utils::AA_OFF) ? alloc_array<uint32_t>(pixel_list_entries(edge_px)) : nullptr;
+
+		// Listed pixels may not belong to us any more, so both lists start empty
+		pixel_list_capacity[i] = pixel_lists_enabled ? static_cast<uint32_t>(pixel_list_entries(tile_px)) : 0;
+		for (uint32_t l = 0; l < 2; l++)
+		{
+			pixel_lists[i][l] = pixel_lists_enabled ? alloc_array<uint32_t>(pixel_list_capacity[i]) : nullptr;
+			tileInfo.list_counts[l] = 0;
+		}
+		tileInfo.listed_pixels = 0;
+	}
+
+	// Dirty-tracking book-keeping is tiny (a few hundred bytes per tile at 4K), so we always allocate it, even with tracking switched off
+	span_hashes = alloc_array<uint64_t>(static_cast<uint64_t>(spans_per_tile) * simple_tiling_utils::max_tiles);
+	span_versions = alloc_array<uint32_t>(static_cast<uint64_t>(spans_per_tile) * simple_tiling_utils::max_tiles);
+	buffer_span_versions = alloc_array<uint32_t>(static_cast<uint64_t>(spans_per_tile) * simple_tiling_utils::max_tiles * simple_tiling_utils::swap_chain::num_buffers);
+	screen_span_versions = alloc_array<uint32_t>(static_cast<uint64_t>(spans_per_tile) * simple_tiling_utils::max_tiles);
+	sparse_spans = alloc_array<uint8_t>(static_cast<uint64_t>(spans_per_tile) * simple_tiling_utils::max_tiles);
+	assert(alloc_front <= tiling_pool + tiling_pool_size); // [tile_pool_bytes] out of step with the carve above; callers already checked it fits
+	reset_dirty_state();
+}
+
+// Forget measured costs; every cell starts out equally expensive
+void reset_cost_map()
+{
+	std::fill(cost_map, cost_map + (static_cast<uint64_t>(cost_cols) * cost_rows), 1.0f);
+	cost_map_fresh = true;
+	adaptive_frame_ctr = 0;
+	unbalanced_windows = 0;
+	awaiting_post_rebalance = false;
+}
+
+// Pool space needed past [tile_memory_front], given the current regions need [tile_bytes] (see [size_tile_memory])
+uint64_t tile_pool_bytes(uint64_t tile_bytes)
+{
+	// Adaptive tiling re-carves tile memory in place, so while it's on, reserve enough for any single-region partition; that's the canvas plus
+	// at most a batch of padding on every row of every tile (+ a motion flag per sixteen pixels, plus one per row of every tile, and a shading
+	// rate per 8x8 block, plus a row + column of partial blocks per tile), and at most a canvas' height of spans per tile
+	// Dynamic resolution adds at most a canvas' worth of samples to that, plus a few rows + columns of padding and two rows of cache + column
+	// lookups per tile; it's only reserved while it's on too, so hosts only pay for either once they ask for it
+	const uint64_t canvas_bytes = static_cast<uint64_t>(canvas_width) * canvas_height * sizeof(uint32_t);
+	const uint64_t upscale_bytes = canvas_bytes +
+								   (static_cast<uint64_t>(numTiles) * ((8 * canvas_width) + (13 * canvas_height) + 128) * sizeof(uint32_t));
+	// Accumulation needs three floats per pixel of scratch on top of that, HDR buffering three half-floats/floats, post-processing an output
+	// pixel plus three floats of filtered rows (halos included) and split source rows, pixel lists two entries per pixel (+ a little slack
+	// per tile), and anti-aliasing one more, but they only reserve them while they're switched on
+	const uint64_t rebalance_scratch_bytes = canvas_bytes + (static_cast<uint64_t>(NUM_VECTOR_LANES - 1) * canvas_height * numTiles * sizeof(uint32_t));
+	const uint64_t post_halo_bytes = static_cast<uint64_t>(numTiles) * ((post_halo * 2 * (canvas_width + NUM_VECTOR_LANES)) + canvas_width + (post_halo * 2) +
+																		 (NUM_VECTOR_LANES * 2)) * 3 * sizeof(float);
+	const uint64_t pixel_list_bytes = ((static_cast<uint64_t>(canvas_width) * canvas_height) + (static_cast<uint64_t>(numTiles) * (NUM_VECTOR_LANES + 16))) * sizeof(uint32_t);
+	const uint64_t rebalance_tile_bytes = (rebalance_scratch_bytes * ((interlacing ? 2 : 1) + (accumulating ? 3 : 0) + ((num_post_effects > 0) ? 4 : 0))) +
+										  ((num_post_effects > 0) ? post_halo_bytes : 0) + (pixel_lists_enabled ? (pixel_list_bytes * 2) : 0) +
+										  ((aa_mode != simple_tiling_utils::AA_OFF) ? pixel_list_bytes : 0) +
+										  ((rebalance_scratch_bytes / sizeof(uint32_t)) * hdr_channel_bytes() * 3) +
+										  tile_flag_bytes((static_cast<uint64_t>(canvas_width / (NUM_VECTOR_LANES * 2)) + 1 + numTiles) * canvas_height) + (64 * numTiles) +
+										  (static_cast<uint64_t>(canvas_width / simple_tiling_utils::shading_rate_block_px) + 1 + numTiles) *
+										  ((canvas_height / simple_tiling_utils::shading_rate_block_px) + 1 + numTiles) + (64 * numTiles) + (dynamic_resolution ? upscale_bytes : 0);
+	const uint32_t rebalance_spans = (canvas_height + dirty_span_rows - 1) / dirty_span_rows;
+	const uint64_t history_bytes = (reprojection != nullptr) ? (canvas_bytes * num_history_frames) : 0;
+	const uint64_t post_canvas_bytes = post_canvas_px() * sizeof(uint32_t) * std::min(num_post_effects, num_post_canvases);
+	if (!adaptive_tiling)
+	{
+		return history_bytes + post_canvas_bytes + tile_bytes + span_bytes(spans_per_tile);
+	}
+	return history_bytes + post_canvas_bytes + std::max(tile_bytes, rebalance_tile_bytes) + std::max(span_bytes(spans_per_tile), span_bytes(rebalance_spans));
+}
+
+// Carve the swap-chain (unless the backend owns it), the adaptive-tiling cost map, tile scratch and dirty-tracking state out of [tiling_pool],
+// then hand the swap-chain its buffers; tiles need to be laid out first. Re-uses the existing pool when it's big enough, so reconfiguring to a
+// smaller canvas never touches the heap
+void prepare_tiling_memory()
+{
+	const uint64_t tile_bytes = size_tile_memory();
+	const uint64_t canvas_bytes = static_cast<uint64_t>(canvas_width) * canvas_height * sizeof(uint32_t);
+	cost_cols = (canvas_width + cost_cell_px - 1) / cost_cell_px;
+	cost_rows = (canvas_height + cost_cell_px - 1) / cost_cell_px;
+	const uint64_t cost_bytes = static_cast<uint64_t>(cost_cols) * cost_rows * sizeof(float);
+
+	// Allocate working memory
+	// 100MB to start with, more if the swap-chain + tile buffers won't fit (three 4K canvases are ~100MB on their own)
+	const uint64_t pool_bytes = std::max(mem_budget, (canvas_bytes * simple_tiling_utils::swap_chain::num_buffers) + cost_bytes + tile_pool_bytes(tile_bytes));
+	if (pool_bytes > tiling_pool_size)
+	{
+		free(tiling_pool);
+		tiling_pool = (uint8_t*)malloc(pool_bytes);
+		tiling_pool_size = pool_bytes;
+	}
+	alloc_front = tiling_pool;
+
+	// Allocate the swap-chain, unless the backend wants tiles to copy straight into memory it owns
+	// (BITMAPINFO for GDI, shared-memory images for X11, nothing at all for headless)
+	uint32_t* swap_buffers[simple_tiling_utils::swap_chain::num_buffers] = {};
+	if (!presenter->init(canvas_width, canvas_height, presenter_backend_target, swap_buffers, simple_tiling_utils::swap_chain::num_buffers))
+	{
+		for (uint32_t i = 0; i < simple_tiling_utils::swap_chain::num_buffers; i++)
+		{
+			swap_buffers[i] = alloc_array<uint32_t>(canvas_width * canvas_height);
+			memset(swap_buffers[i], 0, canvas_bytes);
+		}
+	}
+	tile_swap_chain.init(swap_buffers);
+
+	cost_map = alloc_array<float>(static_cast<uint64_t>(cost_cols) * cost_rows);
+	reset_cost_map();
+
+	tile_memory_front = alloc_front;
+	carve_tile_memory();
+}
+
+// Reset per-tile controls + counters for tiles [first_tile, end_tile)
+void reset_tile_data(uint32_t first_tile, uint32_t end_tile)
+{
+	for (uint32_t i = first_tile; i < end_tile; i++)
+	{
+		tile_data[i].threadData.tile_running = true;
+		tile_data[i].threadData.tile_shutdown_success = false;
+		tile_data[i].threadData.tile_state = simple_tiling_utils::IDLE;
+		tile_data[i].threadData.swap_generation = 0;
+		tile_data[i].threadData.copy_outs = 0;
+		tile_data[i].threadData.bytes_shaded = 0;
+		tile_data[i].threadData.bytes_copied = 0;
+		tile_data[i].threadData.spans_hashed = 0;
+		tile_data[i].threadData.spans_dirty = 0;
+		for (std::atomic_uint64_t& rate_blocks : tile_data[i].threadData.rate_blocks)
+		{
+			rate_blocks = 0;
+		}
+		tile_data[i].threadData.draw_ns = 0;
+		tile_data[i].threadData.draw_passes = 0;
+		tile_data[i].threadData.last_draw_ns = 0;
+		tile_data[i].threadData.last_draw_level = 0;
+		tile_data[i].threadData.last_upscale_ns = 0;
+		tile_data[i].threadData.checker_parity = 0;
+		tile_data[i].threadData.rate_refresh_phase = 0;
+		tile_data[i].threadData.history_valid = false;
+		tile_data[i].threadData.accum_samples = 0;
+		tile_data[i].threadData.accum_epoch = accumulation_epoch;
+		tile_data[i].threadData.accum_hdr = false;
+		tile_data[i].threadData.hdr_job = nullptr;
+		tile_data[i].threadData.fused_chain = nullptr;
+		tile_data[i].threadData.inlined_job = nullptr;
+		tile_data[i].threadData.span_job = nullptr;
+		tile_data[i].threadData.history_passes = 0;
+		tile_data[i].threadData.pixels_reused = 0;
+		tile_data[i].threadData.post_source_valid = false;
+		tile_data[i].threadData.pixels_reshaded = 0;
+		tile_data[i].threadData.last_pixels_reused = 0;
+		tile_data[i].threadData.last_pixels_reshaded = 0;
+		tile_data[i].threadData.marked_list = 0;
+		tile_data[i].threadData.list_counts[0] = 0;
+		tile_data[i].threadData.list_counts[1] = 0;
+		tile_data[i].threadData.listed_pixels = 0;
+		tile_data[i].threadData.sparse_pixels = 0;
+		tile_data[i].threadData.marks_dropped = 0;
+		tile_data[i].threadData.aa_pixels = 0;
+	}
+}
+
+// Presentation book-keeping is per-tile, so it restarts whenever the layout changes
+void reset_presentation_state()
+{
+	presentation_stats = {};
+	present_complete = false;
+	present_cursor = 0;
+
+	// Tiles count as "presented" at setup, so ages measure time-on-screen-since-startup until their first real blit
+	const uint64_t setup_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	for (uint32_t i = 0; i < simple_tiling_utils::max_tiles; i++)
+	{
+		tile_last_presented_us[i].store(setup_us, std::memory_order_relaxed);
+	}
+}
+
+// Re-carve tile memory after switching optional buffers on/off or moving tiles; in place when they fit in the pool, otherwise rebuild (+ grow)
+// the pool like [simple_tiling::reconfigure] does. Tiles need to be idle (and the presenter stopped)
+// Everything that changes what tiles carve comes through here (or [prepare_tiling_memory], which sizes the pool itself), so this is where
+// the pool bound is checked
+void resize_tile_memory()
+{
+	// Post canvases can move (or change size) here, so tiles need to store whole frames into them again
+	for (uint32_t i = 0; i < numTiles; i++)
+	{
+		tile_data[i].threadData.post_source_valid = false;
+	}
+
+	if ((static_cast<uint64_t>(tile_memory_front - tiling_pool) + tile_pool_bytes(size_tile_memory())) <= tiling_pool_size)
+	{
+		carve_tile_memory();
+	}
+	else
+	{
+		presenter->shutdown();
+		tile_jobs.init_q(draw_wrapper, update_wrapper);
+		reset_tile_data(0, numTiles);
+		prepare_tiling_memory();
+		reset_presentation_state();
+	}
+}
+
+// Stop tiles [first_tile, end_tile) and wait for their threads to exit
+void stop_tiles(uint32_t first_tile, uint32_t end_tile)
+{
+	for (uint32_t i = first_tile; i < end_tile; i++)
+	{
+		XThreadWrapper::data& tileInfo = tile_data[i].threadData;
+		tileInfo.tile_running = false;
+		while (!tileInfo.tile_shutdown_success)
+		{
+			// Repeatedly notify blocked threads until they unblock
+			tileInfo.tile_state.store(simple_tiling_utils::IDLE);
+			tileInfo.tile_state.notify_one();
+			tile_swap_chain.release_waiters();
+			post_generation.fetch_add(1, std::memory_order_release);
+			post_generation.notify_all();
+		}
+	}
+
+	// Separate loops so that calls to [join] are delayed enough for tile states to be well-defined
+	for (uint32_t i = first_tile; i < end_tile; i++)
+	{
+		XThreadWrapper::data& tileInfo = tile_data[i].threadData;
+		tileInfo.tile.join();
+	}
+}
+
+// Wait for every tile to finish its queued work; tiles only release their queue slot after copying out, so once every queue is empty,
+// every tile is idle
+void drain_tiles()
+{
+	ZoneScoped;
+	for (uint32_t i = 0; i < numTiles; i++)
+	{
+		while (tile_jobs.front[i] > 0)
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+// Stops the presenter thread (if there is one) for as long as the guard lives, then restarts it with the same target + interval
+// The presenter reads tile rects, tile settings + swap-chain buffers on every present, so anything changing those holds one of these
+struct presenter_pause
+{
+	const bool restart = presenter_running;
+
+	presenter_pause()
+	{
+		simple_tiling::stop_presenter();
+	}
+
+	~presenter_pause()
+	{
+		if (restart)
+		{
+			simple_tiling::start_presenter(presenter_target, presenter_interval_us);
+		}
+	}
+
+	presenter_pause(const presenter_pause&) = delete;
+	presenter_pause& operator=(const presenter_pause&) = delete;
+};
+
+// Call after your application's window setup
+void simple_tiling::setup(uint32_t num_tiles, uint32_t window_width, uint32_t window_height, bool using_interlacing, simple_tiling_utils::PRESENT_BACKENDS backend, void* backend_target,
+						  simple_tiling_utils::TILE_LAYOUTS layout)
+{
+	// Resolve canvas dimensions
+	canvas_width = window_width;
+	canvas_height = window_height;
+
+	// Resolve tile dimensions
+	tile_layout = layout;
+	layout_tiles(num_tiles);
+
+	tile_jobs.init_q(draw_wrapper, update_wrapper);
+	tile_jobs.init_frames();
+
+	interlacing = using_interlacing;
+	output_mode = simple_tiling_utils::TILE_BUFFER_OUTPUT;
+	external_output = nullptr;
+	external_output_stride = 0;
+	dirty_tracking = false;
+	adaptive_tiling = false;
+	balance_stats = {};
+	dynamic_resolution = false;
+	upscale_sharpening = 0;
+	render_level = 0;
+	resolution_stats = {};
+	shading_rate_mode = simple_tiling_utils::FULL_RATE_SHADING;
+	shading_rate_map = nullptr;
+	accumulating = false;
+	reprojection = nullptr;
+	tonemap_operator = simple_tiling_utils::TONEMAP_ACES;
+	tonemap_exposure = 1.0f;
+	tonemap_srgb = true;
+	tonemap_dither = true;
+	hdr_format = simple_tiling_utils::HDR_UNBUFFERED;
+	num_post_effects = 0;
+	pixel_lists_enabled = false;
+	aa_mode = simple_tiling_utils::AA_OFF;
+	aa_filter = simple_tiling_utils::AA_BOX_FILTER;
+	aa_edge_contrast = 32;
+	post_halo = 0;
+	post_padding = 0;
+	reset_tile_data(0, numTiles);
+
+	// Prepare the presentation backend + working memory
+	presenter = simple_tiling_backends::select(backend);
+	presenter_backend_target = backend_target;
+	prepare_tiling_memory();
+	reset_presentation_state();
+
+	// Launch tiles after the swap-chain is ready for them
+	for (uint32_t i = 0; i < numTiles; i++)
+	{
+		tile_data[i].threadData.tile = std::thread(thread_main, i);
+	}
+}
+
+// Live re-tiling; drain, re-layout, re-allocate, and resume with the same threads wherever possible
+uint64_t simple_tiling::reconfigure(uint32_t window_width, uint32_t window_height, uint32_t num_tiles)
+{
+	ZoneScoped;
+	const auto start_t = std::chrono::steady_clock::now();
+
+	// Pause the presenter; it reads tile rects + swap-chain buffers, and both are about to move
+	const presenter_pause paused;
+
+	// Drain in-flight work; tiles only release their queue slot after copying out, so once every queue is empty, every tile is idle
+	// (work submitted to only some tiles can leave the others a frame behind; that partial frame is dropped along with the old swap-chain)
+	drain_tiles();
+
+	// Retire tiles we no longer need; everyone else stays parked on their (empty) queue, and never notices the layout change
+	const uint32_t prev_num_tiles = numTiles;
+	canvas_width = window_width;
+	canvas_height = window_height;
+	layout_tiles(num_tiles);
+	if (numTiles < prev_num_tiles)
+	{
+		stop_tiles(numTiles, prev_num_tiles);
+	}
+
+	// External output covers a fixed-size host allocation, so it can't survive a resize; fall back to the default mode
+	if (output_mode == simple_tiling_utils::EXTERNAL_OUTPUT)
+	{
+		output_mode = simple_tiling_utils::TILE_BUFFER_OUTPUT;
+		external_output = nullptr;
+		external_output_stride = 0;
+	}
+
+	// Re-create backend resources (X11 images, BITMAPINFO) at the new size, then rebuild tile memory in-place
+	presenter->shutdown();
+	tile_jobs.init_q(draw_wrapper, update_wrapper);
+	reset_tile_data(0, numTiles);
+	prepare_tiling_memory();
+	reset_presentation_state();
+
+	// Spawn any tiles we didn't have before
+	for (uint32_t i = prev_num_tiles; i < numTiles; i++)
+	{
+		tile_data[i].threadData.tile = std::thread(thread_main, i);
+	}
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_t).count();
+}
+
+// Layout changes move every tile's regions, so they're just a reconfigure at the current size
+uint64_t simple_tiling::set_tile_layout(simple_tiling_utils::TILE_LAYOUTS layout)
+{
+	// Drained inside [reconfigure] before anything reads the new layout; tiles only look at their regions while processing work
+	tile_layout = layout;
+	return reconfigure(canvas_width, canvas_height, numTiles);
+}
+
+// Total estimated cost over cost-map cells [x0, x1) * [y0, y1)
+double cell_cost(uint32_t x0, uint32_t x1, uint32_t y0, uint32_t y1)
+{
+	double cost = 0.0;
+	for (uint32_t y = y0; y < y1; y++)
+	{
+		const float* row = cost_map + (static_cast<uint64_t>(y) * cost_cols);
+		for (uint32_t x = x0; x < x1; x++)
+		{
+			cost += row[x];
+		}
+	}
+	return cost;
+}
+
+// Cost-weighted recursive bisection over cost-map cells [x0, x1) * [y0, y1); split the longer side wherever the cost on either side best
+// matches its share of tiles, then recurse until every tile has its own rectangle
+// Returns false if the area runs out of cells before it runs out of tiles
+bool bisect_tiles(uint32_t x0, uint32_t x1, uint32_t y0, uint32_t y1, uint32_t first_tile, uint32_t num_tiles, tile_region* partition)
+{
+	if (num_tiles == 1)
+	{
+		tile_region& region = partition[first_tile];
+		region = {};
+		region.minX = x0 * cost_cell_px;
+		region.maxX = std::min(x1 * cost_cell_px, canvas_width);
+		region.minY = y0 * cost_cell_px;
+		region.maxY = std::min(y1 * cost_cell_px, canvas_height);
+		return true;
+	}
+
+	const bool split_x = ((x1 - x0) >= (y1 - y0));
+	const uint32_t len = split_x ? (x1 - x0) : (y1 - y0);
+	if (len < 2)
+	{
+		return false;
+	}
+
+	const uint32_t lo_tiles = num_tiles / 2;
+	const double target = cell_cost(x0, x1, y0, y1) * lo_tiles / num_tiles;
+	double prev_cost = 0.0;
+	double cost = 0.0;
+	uint32_t split = 1;
+	for (; split < len; split++)
+	{
+		prev_cost = cost;
+		cost += split_x ? cell_cost(x0 + split - 1, x0 + split, y0, y1) : cell_cost(x0, x1, y0 + split - 1, y0 + split);
+		if (cost >= target)
+		{
+			// Whichever side of the target is closer
+			if (split > 1 && (target - prev_cost) < (cost - target))
+			{
+				split--;
+			}
+			break;
+		}
+	}
+	split = std::min(split, len - 1);
+
+	if (split_x)
+	{
+		return bisect_tiles(x0, x0 + split, y0, y1, first_tile, lo_tiles, partition) &&
+			   bisect_tiles(x0 + split, x1, y0, y1, first_tile + lo_tiles, num_tiles - lo_tiles, partition);
+	}
+	return bisect_tiles(x0, x1, y0, y0 + split, first_tile, lo_tiles, partition) &&
+		   bisect_tiles(x0, x1, y0 + split, y1, first_tile + lo_tiles, num_tiles - lo_tiles, partition);
+}
+
+// Estimated balance (max/mean cost) of a single-region-per-tile partition
+double predicted_balance(const tile_region* partition)
+{
+	double max_cost = 0.0;
+	double sum_cost = 0.0;
+	for (uint32_t i = 0; i < numTiles; i++)
+	{
+		const tile_region& region = partition[i];
+		const double cost = cell_cost(region.minX / cost_cell_px, (region.maxX + cost_cell_px - 1) / cost_cell_px,
+									  region.minY / cost_cell_px, (region.maxY + cost_cell_px - 1) / cost_cell_px);
+		max_cost = std::max(max_cost, cost);
+		sum_cost += cost;
+	}
+	return sum_cost > 0.0 ? max_cost / (sum_cost / numTiles) : 1.0;
+}
+
+// Spread each tile's measured time evenly over the cells it covers (by cell centre, so cells straddling two tiles belong to one of them),
+// and blend that into the cost map
+void update_cost_map(const double* tile_us)
+{
+	const float blend = cost_map_fresh ? 1.0f : 0.5f;
+	for (uint32_t i = 0; i < numTiles; i++)
+	{
+		const XThreadWrapper::data& tileInfo = tile_data[i].threadData;
+		uint64_t tile_px = 0;
+		for (uint32_t r = tileInfo.first_region; r < tileInfo.first_region + tileInfo.num_regions; r++)
+		{
+			tile_px += static_cast<uint64_t>(tile_regions[r].maxX - tile_regions[r].minX) * (tile_regions[r].maxY - tile_regions[r].minY);
+		}
+
+		const float cell_us = static_cast<float>((tile_us[i] / tile_px) * (cost_cell_px * cost_cell_px));
+		for (uint32_t r = tileInfo.first_region; r < tileInfo.first_region + tileInfo.num_regions; r++)
+		{
+			const tile_region& region = tile_regions[r];
+			const uint32_t cx0 = (region.minX + (cost_cell_px / 2) - 1) / cost_cell_px;
+			const uint32_t cx1 = region.maxX == canvas_width ? cost_cols : (region.maxX + (cost_cell_px / 2) - 1) / cost_cell_px;
+			const uint32_t cy0 = (region.minY + (cost_cell_px / 2) - 1) / cost_cell_px;
+			const uint32_t cy1 = region.maxY == canvas_height ? cost_rows : (region.maxY + (cost_cell_px / 2) - 1) / cost_cell_px;
+			for (uint32_t y = cy0; y < cy1; y++)
+			{
+				float* row = cost_map + (static_cast<uint64_t>(y) * cost_cols);
+				for (uint32_t x = cx0; x < cx1; x++)
+				{
+					row[x] += (cell_us - row[x]) * blend;
+				}
+			}
+		}
+	}
+	cost_map_fresh = false;
+}
+
+// Move every tile onto its rectangle in [partition]; drains work + pauses the presenter around the change, like [reconfigure]
+// Threads, the swap-chain and whatever's on-screen all stay as they are; only tile scratch + dirty-tracking state are rebuilt (the pool reserves
+// room for any partition while adaptive tiling is on, so [resize_tile_memory] only falls back to rebuilding it if that reserve comes up short)
+void apply_partition(const tile_region* partition)
+{
+	ZoneScoped;
+	const presenter_pause paused;
+	drain_tiles();
+
+	for (uint32_t i = 0; i < numTiles; i++)
+	{
+		XThreadWrapper::data& tileInfo = tile_data[i].threadData;
+		tile_regions[i] = partition[i];
+		tileInfo.first_region = i;
+		tileInfo.num_regions = 1;
+	}
+	update_tile_bounds();
+	resize_tile_memory();
+}
+
+void simple_tiling::set_adaptive_tiling(bool enabled, uint32_t interval_frames, float imbalance_threshold)
+{
+	ZoneScoped;
+	assert(interval_frames > 0);
+
+	// Switching on reserves room to re-partition into (see [tile_pool_bytes]), which can move tile memory, so let in-flight work finish first
+	const presenter_pause paused;
+	drain_tiles();
+
+	if (enabled != adaptive_tiling)
+	{
+		adaptive_tiling = enabled;
+		resize_tile_memory();
+	}
+	adaptive_interval_frames = interval_frames;
+	adaptive_threshold = imbalance_threshold;
+	adaptive_frame_ctr = 0;
+	unbalanced_windows = 0;
+
+	// Timings from before now were never going to be used
+	for (uint32_t i = 0; i < numTiles; i++)
+	{
+		tile_data[i].threadData.draw_ns = 0;
+		tile_data[i].threadData.draw_passes = 0;
+	}
+}
+
+bool simple_tiling::rebalance_tiles()
+{
+	ZoneScoped;
+	if (!adaptive_tiling || tile_layout == simple_tiling_utils::MORTON_TILES || numTiles < 2)
+	{
+		return false;
+	}
+
+	adaptive_frame_ctr++;
+	if (adaptive_frame_ctr < adaptive_interval_frames)
+	{
+		return false;
+	}
+	adaptive_frame_ctr = 0;
+
+	// Close the measurement window; tiles might still be shading, which just shifts a pass into the next window
+	double tile_us[simple_tiling_utils::max_tiles] = {};
+	double max_us = 0.0;
+	double sum_us = 0.0;
+	bool all_measured = true;
+	for (uint32_t i = 0; i < numTiles; i++)
+	{
+		XThreadWrapper::data& tileInfo = tile_data[i].threadData;
+		const uint64_t ns = tileInfo.draw_ns.exchange(0, std::memory_order_relaxed);
+		const uint32_t passes = tileInfo.draw_passes.exchange(0, std::memory_order_relaxed);
+		all_measured &= (passes > 0);
+		tile_us[i] = passes > 0 ? (static_cast<double>(ns) / passes) / 1000.0 : 0.0;
+		max_us = std::max(max_us, tile_us[i]);
+		sum_us += tile_us[i];
+	}
+
+	// Only whole-frame windows are useful (damage-driven frames aren't timed, and masked submissions skip tiles entirely)
+	if (!all_measured || sum_us <= 0.0)
+	{
+		return false;
+	}
+
+	const double mean_us = sum_us / numTiles;
+	balance_stats.max_tile_us = max_us;
+	balance_stats.mean_tile_us = mean_us;
+	if (awaiting_post_rebalance)
+	{
+		balance_stats.max_tile_us_after = max_us;
+		balance_stats.mean_tile_us_after = mean_us;
+		awaiting_post_rebalance = false;
+	}
+	update_cost_map(tile_us);
+
+	// Hysteresis; stay put unless tiles have been clearly out of balance for a couple of windows running, *and* the cost map expects a clear
+	// improvement from moving them
+	const double balance = max_us / mean_us;
+	unbalanced_windows = (balance >= adaptive_threshold) ? (unbalanced_windows + 1) : 0;
+	if (unbalanced_windows < 2)
+	{
+		return false;
+	}
+
+	tile_region partition[simple_tiling_utils::max_tiles] = {};
+	if (!bisect_tiles(0, cost_cols, 0, cost_rows, 0, numTiles, partition))
+	{
+		return false;
+	}
+
+	const double expected = predicted_balance(partition);
+	if (expected > (balance * 0.9))
+	{
+		return false;
+	}
+
+	apply_partition(partition);
+	unbalanced_windows = 0;
+	balance_stats.num_rebalances++;
+	balance_stats.max_tile_us_before = max_us;
+	balance_stats.mean_tile_us_before = mean_us;
+	balance_stats.predicted_balance = expected;
+	awaiting_post_rebalance = true;
+	return true;
+}
+
+simple_tiling_utils::balance_stats simple_tiling::GetBalanceStats()
+{
+	return balance_stats;
+}
+
+// Fraction of the canvas' pixels shaded at the given render-scale level
+double render_area(uint32_t level)
+{
+	return (static_cast<double>(render_scale_px(canvas_width, level)) * render_scale_px(canvas_height, level)) / (static_cast<double>(canvas_width) * canvas_height);
+}
+
+void simple_tiling::set_dynamic_resolution(bool enabled, float frame_budget_ms, float min_scale, float sharpening)
+{
+	ZoneScoped;
+	assert(frame_budget_ms > 0.0f && min_scale > 0.0f && min_scale <= 1.0f && sharpening >= 0.0f && sharpening <= 1.0f);
+
+	// Tiles read the sharpening strength (and their share of upscaling memory) mid-pass, so let in-flight work finish first
+	const presenter_pause paused;
+	drain_tiles();
+
+	resolution_budget_ms = frame_budget_ms;
+	max_render_level = std::min(static_cast<uint32_t>(std::floor(((1.0f - min_scale) * simple_tiling_utils::render_scale_steps) + 0.001f)),
+								simple_tiling_utils::render_scale_steps - 1);
+	upscale_sharpening = static_cast<int32_t>(std::lround(sharpening * 32.0f));
+	if (enabled != dynamic_resolution)
+	{
+		// Upscaling memory is only reserved while it's on (see [tile_pool_bytes]), so switching on can grow the pool
+		dynamic_resolution = enabled;
+		resize_tile_memory();
+	}
+
+	// Start over from native resolution
+	render_level = 0;
+	native_shading_ms = 0.0;
+	upscale_ms = 0.0;
+	resolution_stats = {};
+	resolution_stats.render_width = canvas_width;
+	resolution_stats.render_height = canvas_height;
+	for (uint32_t i = 0; i < numTiles; i++)
+	{
+		tile_data[i].threadData.last_draw_ns = 0;
+	}
+}
+
+bool simple_tiling::update_dynamic_resolution()
+{
+	ZoneScoped;
+	if (!dynamic_resolution)
+	{
+		return false;
+	}
+
+	// Frame cost is the slowest tile's latest full pass (tiles run in parallel, so that's when the frame can publish); tiles still shading just
+	// report next time
+	uint64_t frame_ns = 0;
+	uint64_t frame_upscale_ns = 0;
+	uint32_t frame_level = 0;
+	for (uint32_t i = 0; i < numTiles; i++)
+	{
+		XThreadWrapper::data& tileInfo = tile_data[i].threadData;
+		const uint64_t ns = tileInfo.last_draw_ns.exchange(0, std::memory_order_acquire);
+		if (ns > frame_ns)
+		{
+			frame_ns = ns;
+			frame_level = tileInfo.last_draw_level.load(std::memory_order_relaxed);
+			frame_upscale_ns = tileInfo.last_upscale_ns.load(std::memory_order_relaxed);
+		}
+	}
+
+	if (frame_ns == 0)
+	{
+		return false; // Nothing new since the last call
+	}
+
+	// Frames cost (upscaling) + (shading, which scales with the samples we shade), so normalize shading to native resolution before smoothing
+	// it; rises are taken straight away, falls blend in over a few frames, so a spike gets handled the frame it's measured but one cheap frame
+	// can't drag the resolution back up
+	const double frame_ms = static_cast<double>(frame_ns) / 1000000.0;
+	if (frame_level > 0)
+	{
+		upscale_ms = static_cast<double>(frame_upscale_ns) / 1000000.0;
+	}
+	const double native_ms = std::max(frame_ms - (frame_level > 0 ? upscale_ms : 0.0), 0.0) / render_area(frame_level);
+	native_shading_ms = (resolution_stats.frames == 0 || native_ms > native_shading_ms) ? native_ms : (native_shading_ms * 0.9) + (native_ms * 0.1);
+	auto predicted_ms = [](uint32_t level)
+	{
+		return (native_shading_ms * render_area(level)) + (level > 0 ? upscale_ms : 0.0);
+	};
+
+	// Over budget; drop to the first level with some headroom. Under budget; only climb a step at a time, and only when the next step up should
+	// still leave plenty of room (the gap between the two thresholds keeps us from bouncing between levels)
+	uint32_t level = render_level;
+	if (predicted_ms(level) > resolution_budget_ms)
+	{
+		while (level < max_render_level && predicted_ms(level) > (resolution_budget_ms * 0.9))
+		{
+			level++;
+		}
+	}
+	else if (level > 0 && predicted_ms(level - 1) <= (resolution_budget_ms * 0.85))
+	{
+		level--;
+	}
+
+	const bool changed = (level != render_level);
+	render_level = level;
+
+	resolution_stats.frames++;
+	resolution_stats.scale_changes += changed ? 1 : 0;
+	resolution_stats.frames_over_budget += (frame_ms > resolution_budget_ms) ? 1 : 0;
+	resolution_stats.render_scale = static_cast<float>(simple_tiling_utils::render_scale_steps - level) / simple_tiling_utils::render_scale_steps;
+	resolution_stats.render_width = render_scale_px(canvas_width, level);
+	resolution_stats.render_height = render_scale_px(canvas_height, level);
+	resolution_stats.min_render_scale = std::min(resolution_stats.min_render_scale, resolution_stats.render_scale);
+	resolution_stats.avg_render_scale += (resolution_stats.render_scale - resolution_stats.avg_render_scale) / resolution_stats.frames;
+	resolution_stats.last_frame_ms = frame_ms;
+	resolution_stats.predicted_frame_ms = predicted_ms(level);
+	return changed;
+}
+
+simple_tiling_utils::resolution_stats simple_tiling::GetResolutionStats()
+{
+	return resolution_stats;
+}
+
+void simple_tiling::set_accumulation(bool enabled, uint32_t max_samples)
+{
+	ZoneScoped;
+	assert(max_samples > 0);
+
+	// Tiles read the sample limit (and their accumulation buffers) mid-pass, so let in-flight work finish first
+	const presenter_pause paused;
+	drain_tiles();
+
+	accumulation_max_samples = max_samples;
+	if (enabled != accumulating)
+	{
+		// Accumulation buffers are big enough (three floats per pixel) that we only reserve room for them while they're in use
+		accumulating = enabled;
+		resize_tile_memory();
+	}
+	restart_accumulation();
+}
+
+void simple_tiling::set_reprojection(simple_tiling_utils::reprojection_job reprojection_callback)
+{
+	ZoneScoped;
+
+	// Tiles read the callback (and history) mid-pass, so let in-flight work finish first
+	const presenter_pause paused;
+	drain_tiles();
+
+	const bool toggled = (reprojection_callback != nullptr) != (reprojection != nullptr);
+	reprojection = reprojection_callback;
+	if (toggled)
+	{
+		// History takes three canvases, so it's only reserved while reprojection is on; whatever it held before is meaningless now
+		resize_tile_memory();
+		for (uint32_t i = 0; i < numTiles; i++)
+		{
+			tile_data[i].threadData.history_passes = 0;
+		}
+	}
+}
+
+void simple_tiling::set_tonemapping(simple_tiling_utils::TONEMAP_OPERATORS tonemap, float exposure, bool srgb_encode, bool dither)
+{
+	ZoneScoped;
+
+	// Tiles read these all through their passes, so let in-flight work finish first
+	const presenter_pause paused;
+	drain_tiles();
+
+	tonemap_operator = tonemap;
+	tonemap_exposure = exposure;
+	tonemap_srgb = srgb_encode;
+	tonemap_dither = dither;
+}
+
+void simple_tiling::set_hdr_buffering(simple_tiling_utils::HDR_FORMATS format)
+{
+	ZoneScoped;
+
+	// Tiles shade into (and resolve from) their HDR buffers mid-pass, so let in-flight work finish first
+	const presenter_pause paused;
+	drain_tiles();
+
+	if (format != hdr_format)
+	{
+		hdr_format = format;
+		resize_tile_memory();
+	}
+}
+
+void simple_tiling::set_post_processing(const simple_tiling_utils::post_effect* effects, uint32_t num_effects)
+{
+	ZoneScoped;
+	assert(num_effects <= simple_tiling_utils::max_post_effects);
+	assert(effects != nullptr || num_effects == 0);
+
+	// Tiles run effects (+ wait on each other) mid-pass, so let in-flight work finish first
+	const presenter_pause paused;
+	drain_tiles();
+
+	num_post_effects = (effects != nullptr) ? num_effects : 0;
+	post_halo = 0;
+	for (uint32_t e = 0; e < num_post_effects; e++)
+	{
+		const simple_tiling_utils::post_effect& effect = effects[e];
+		assert(effect.halo <= simple_tiling_utils::max_post_halo);
+		assert((effect.type == simple_tiling_utils::SEPARABLE_POST_EFFECT) ? (effect.weights != nullptr) : (effect.job != nullptr));
+		post_effects[e] = effect;
+		post_halo = std::max(post_halo, effect.halo);
+		if (effect.type == simple_tiling_utils::SEPARABLE_POST_EFFECT)
+		{
+			// Tiles read our copies, so hosts don't need to keep weights around
+			const uint32_t taps = (effect.halo * 2) + 1;
+			const float* weights_y = (effect.weights_y != nullptr) ? effect.weights_y : effect.weights;
+			std::copy(effect.weights, effect.weights + taps, post_weights[e][0]);
+			std::copy(weights_y, weights_y + taps, post_weights[e][1]);
+			post_effects[e].weights = post_weights[e][0];
+			post_effects[e].weights_y = post_weights[e][1];
+		}
+	}
+	post_padding = (num_post_effects > 0) ? (post_halo + (NUM_VECTOR_LANES * 2)) : 0;
+	resize_tile_memory();
+}
+
+void simple_tiling::set_pixel_lists(bool enabled)
+{
+	ZoneScoped;
+
+	// Tiles mark into (and shade from) their lists mid-pass, so let in-flight work finish first
+	const presenter_pause paused;
+	drain_tiles();
+
+	if (enabled != pixel_lists_enabled)
+	{
+		pixel_lists_enabled = enabled;
+		resize_tile_memory();
+	}
+}
+
+void simple_tiling::restart_accumulation()
+{
+	accumulation_epoch.fetch_add(1, std::memory_order_release);
+}
+
+simple_tiling_utils::sample_jitter simple_tiling::GetSampleJitter(uint32_t tile_id)
+{
+	return tile_data[tile_id].threadData.jitter;
+}
+
+void simple_tiling::set_anti_aliasing(simple_tiling_utils::ANTI_ALIASING_MODES mode, simple_tiling_utils::AA_FILTERS filter, uint8_t edge_contrast)
+{
+	ZoneScoped;
+
+	// Tiles read every setting all through their passes (and find edges in their lists), so let in-flight work finish first
+	const presenter_pause paused;
+	drain_tiles();
+
+	const bool resize = (mode != simple_tiling_utils::AA_OFF) != (aa_mode != simple_tiling_utils::AA_OFF);
+	aa_mode = mode;
+	aa_filter = filter;
+	aa_edge_contrast = edge_contrast;
+	if (resize)
+	{
+		resize_tile_memory();
+	}
+}
+
+void simple_tiling::set_shading_rates(simple_tiling_utils::SHADING_RATE_MODES mode, const uint8_t* rate_map, uint8_t max_coarse_contrast)
+{
+	ZoneScoped;
+	assert(mode != simple_tiling_utils::USER_RATE_SHADING || rate_map != nullptr);
+
+	// Tiles read the mode + map all through their passes, so let in-flight work finish first
+	const presenter_pause paused;
+	drain_tiles();
+
+	shading_rate_mode = mode;
+	shading_rate_map = rate_map;
+	coarse_contrast_limit = max_coarse_contrast;
+
+	// Start every block over at full rate; adaptive rates settle after one pass
+	for (uint32_t i = 0; i < numTiles; i++)
+	{
+		const XThreadWrapper::data& tileInfo = tile_data[i].threadData;
+		uint64_t rate_blocks = 0;
+		for (uint32_t r = tileInfo.first_region; r < tileInfo.first_region + tileInfo.num_regions; r++)
+		{
+			rate_blocks += static_cast<uint64_t>(region_rate_cols(tile_regions[r])) * region_rate_rows(tile_regions[r]);
+		}
+		memset(shading_rates[i], simple_tiling_utils::RATE_1X1, rate_blocks);
+	}
+}
+
+void simple_tiling::shutdown()
+{
+	// Stop presenting first; the presenter reads from the swap-chain we're about to free
+	stop_presenter();
+
+	// Terminate tile threads
+	stop_tiles(0, numTiles);
+
+	// ... other shutdown things ... //
+	presenter->shutdown();
+	free(tiling_pool); // <3 linear allocators
+	tiling_pool = nullptr;
+	tiling_pool_size = 0;
+}
+
+// Number of spans in a tile that differ between the given swap-chain buffer and the screen
+uint32_t count_damaged_spans(uint32_t tile_ndx, uint32_t buffer_ndx, uint32_t num_spans)
+{
+	const uint32_t* frame_versions = held_span_versions(buffer_ndx, tile_ndx);
+	const uint32_t* screen_versions = screen_span_versions + (static_cast<uint64_t>(tile_ndx) * spans_per_tile);
+	uint32_t num_damaged = 0;
+	for (uint32_t s = 0; s < num_spans; s++)
+	{
+		num_damaged += (frame_versions[s] != screen_versions[s]);
+	}
+	return num_damaged;
+}
+
+// Backend-agnostic presentation loop; [win_paint] and headless hosts both route through here
+void simple_tiling::present(void* present_target, uint32_t frame_budget_ms)
+{
+	ZoneScoped;
+	auto t = std::chrono::steady_clock::now();
+	auto start_t = t.time_since_epoch();
+	uint32_t d_i = 1;
+	uint32_t num_blits = 0;
+
+	// Resolve presentation order for this call
+	// Round-robin picks up from wherever the last call ran out of budget; oldest-first sorts by time since each tile last reached the screen
+	// Either way, every tile eventually gets presented under a tight budget, instead of high-index tiles starving behind tile 0
+	uint32_t order[simple_tiling_utils::max_tiles] = {};
+	for (uint32_t i = 0; i < numTiles; i++)
+	{
+		order[i] = (present_cursor + i) % numTiles;
+	}
+
+	if (present_order == simple_tiling_utils::OLDEST_FIRST_PRESENT)
+	{
+		std::stable_sort(order, order + numTiles, [](uint32_t a, uint32_t b)
+		{
+			return tile_last_presented_us[a].load(std::memory_order_relaxed) < tile_last_presented_us[b].load(std::memory_order_relaxed);
+		});
+	}
+
+	// Grab the newest complete frame; every tile in it is finished, so there's nothing to wait on while we blit
+	uint64_t frame_publish_us = 0;
+	const uint32_t* frame = tile_swap_chain.acquire_present(frame_publish_us);
+	const uint32_t frame_ndx = tile_swap_chain.present_ndx;
+	uint64_t pixels_blitted = 0;
+	uint32_t i = 0;
+
+	// Morton micro-tiles are far too small + scattered to upload one at a time; without dirty tracking to narrow things down, upload the whole
+	// canvas in one go and count every tile as presented
+	if (tile_layout == simple_tiling_utils::MORTON_TILES && !dirty_tracking)
+	{
+		presenter->blit(present_target, frame, canvas_width, canvas_height, 0, 0, canvas_width, canvas_height);
+		pixels_blitted += static_cast<uint64_t>(canvas_width) * canvas_height;
+		num_blits++;
+
+		const uint64_t curr_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		for (uint32_t j = 0; j < numTiles; j++)
+		{
+			tile_last_presented_us[j].store(curr_us, std::memory_order_relaxed);
+		}
+		i = numTiles;
+	}
+
+	for (; i < numTiles; i += d_i)
+	{
+		ZoneScoped;
+		XThreadWrapper::data& tileInfo = tile_data[order[i]].threadData;
+		const tile_region* regions = tile_regions + tileInfo.first_region;
+		const uint32_t minY = tileInfo.tileMinY;
+		const uint32_t minX = tileInfo.tileMinX;
+		const uint32_t maxY = tileInfo.tileMaxY;
+		const uint32_t h = maxY - minY;
+		uint32_t maxX = tileInfo.tileMaxX;
+		d_i = 1;
+
+		// With dirty tracking, only upload spans the screen doesn't already show
+		// Clean tiles cost nothing, and partially-damaged tiles blit each run of damaged spans (per-region) on its own
+		const uint32_t num_spans = tileInfo.num_spans;
+		const uint32_t num_damaged = dirty_tracking ? count_damaged_spans(order[i], frame_ndx, num_spans) : num_spans;
+		if (num_damaged < num_spans)
+		{
+			if (num_damaged > 0)
+			{
+				const uint32_t* frame_versions = held_span_versions(frame_ndx, order[i]);
+				const uint32_t* screen_versions = screen_span_versions + (static_cast<uint64_t>(order[i]) * spans_per_tile);
+				for (uint32_t r = 0; r < tileInfo.num_regions; r++)
+				{
+					const tile_region& region = regions[r];
+					const uint32_t end_span = region.span_offset + region_num_spans(region);
+					uint32_t s = region.span_offset;
+					while (s < end_span)
+					{
+						if (frame_versions[s] == screen_versions[s])
+						{
+							s++;
+							continue;
+						}
+
+						// Extend the run as far as the damage goes
+						uint32_t run_end = s + 1;
+						while (run_end < end_span && frame_versions[run_end] != screen_versions[run_end])
+						{
+							run_end++;
+						}
+
+						const uint32_t run_minY = region.minY + ((s - region.span_offset) * dirty_span_rows);
+						const uint32_t run_h = std::min(region.minY + ((run_end - region.span_offset) * dirty_span_rows), region.maxY) - run_minY;
+						presenter->blit(present_target, frame, canvas_width, canvas_height, region.minX, run_minY, region.maxX - region.minX, run_h);
+						pixels_blitted += static_cast<uint64_t>(region.maxX - region.minX) * run_h;
+						num_blits++;
+						s = run_end;
+					}
+				}
+			}
+		}
+		else if (tileInfo.num_regions > 1)
+		{
+			// Fully-damaged Morton tiles (only reachable with dirty tracking on); upload each micro-tile as-is
+			for (uint32_t r = 0; r < tileInfo.num_regions; r++)
+			{
+				const tile_region& region = regions[r];
+				presenter->blit(present_target, frame, canvas_width, canvas_height, region.minX, region.minY, region.maxX - region.minX, region.maxY - region.minY);
+				pixels_blitted += static_cast<uint64_t>(region.maxX - region.minX) * (region.maxY - region.minY);
+				num_blits++;
+			}
+		}
+		else
+		{
+			// If the current tile & the following tiles share a row and are side-by-side, blit them together with the current one; that may be faster than many separate copies
+			// (stop at the last live tile - anything past [numTiles] is zero-initialized and would look "adjacent" to every tile on the top row)
+			// (neighbours only join in if they're fully damaged as well; no point re-uploading tiles the screen already has)
+			while ((i + d_i) < numTiles)
+			{
+				const XThreadWrapper::data& nextTileInfo = tile_data[order[i + d_i]].threadData;
+				if (nextTileInfo.num_regions == 1 && nextTileInfo.tileMinY == minY && nextTileInfo.tileMaxY == maxY && nextTileInfo.tileMinX == maxX &&
+					(!dirty_tracking || count_damaged_spans(order[i + d_i], frame_ndx, nextTileInfo.num_spans) == nextTileInfo.num_spans))
+				{
+					maxX = nextTileInfo.tileMaxX;
+					d_i++;
+				}
+				else
+				{
+					break;
+				}
+			}
+
+			const uint32_t w = maxX - minX;
+			presenter->blit(present_target, frame, canvas_width, canvas_height, minX, minY, w, h);
+			pixels_blitted += static_cast<uint64_t>(w) * h;
+			num_blits++;
+		}
+
+		if (dirty_tracking)
+		{
+			for (uint32_t j = i; j < (i + d_i); j++)
+			{
+				memcpy(screen_span_versions + (static_cast<uint64_t>(order[j]) * spans_per_tile), held_span_versions(frame_ndx, order[j]), sizeof(uint32_t) * spans_per_tile);
+			}
+		}
+
+		t = std::chrono::steady_clock::now();
+		const auto curr_t = t.time_since_epoch();
+		for (uint32_t j = i; j < (i + d_i); j++)
+		{
+			tile_last_presented_us[order[j]].store(std::chrono::duration_cast<std::chrono::microseconds>(curr_t).count(), std::memory_order_relaxed);
+		}
+
+		const auto dt_ms = std::chrono::duration_cast<std::chrono::milliseconds>(curr_t - start_t);
+		if (dt_ms.count() > frame_budget_ms)
+		{
+			i += d_i;
+			break;
+		}
+	}
+	present_complete = (i >= numTiles);
+
+	// Remember where we stopped, so the next call starts with the tiles we didn't reach
+	if (present_order == simple_tiling_utils::ROUND_ROBIN_PRESENT)
+	{
+		present_cursor = (present_cursor + i) % numTiles;
+	}
+	presenter->flush(present_target);
+
+	// Record timings; the flush is included, since that's where asynchronous backends actually pay for their blits
+	const auto end_t = std::chrono::steady_clock::now().time_since_epoch();
+	const auto present_us = std::chrono::duration_cast<std::chrono::microseconds>(end_t - start_t).count();
+	std::lock_guard<std::mutex> stats_guard(presentation_stats_lock);
+	presentation_stats.num_presents++;
+	presentation_stats.num_blits += num_blits;
+	presentation_stats.pixels_blitted += pixels_blitted;
+	presentation_stats.last_present_us = present_us;
+	presentation_stats.max_present_us = std::max(presentation_stats.max_present_us, static_cast<uint64_t>(present_us));
+	presentation_stats.avg_present_us += (static_cast<double>(present_us) - presentation_stats.avg_present_us) / presentation_stats.num_presents;
+
+	// Per-tile presentation age, measured at the end of this present
+	uint64_t age_sum_us = 0;
+	presentation_stats.max_tile_age_us = 0;
+	for (uint32_t j = 0; j < numTiles; j++)
+	{
+		const uint64_t age_us = GetTilePresentAge(j);
+		age_sum_us += age_us;
+		presentation_stats.max_tile_age_us = std::max(presentation_stats.max_tile_age_us, age_us);
+	}
+	presentation_stats.avg_tile_age_us = static_cast<double>(age_sum_us) / numTiles;
+
+	// Publish -> screen latency, for new frames only
+	if (frame_publish_us != 0)
+	{
+		const uint64_t end_us = std::chrono::duration_cast<std::chrono::microseconds>(end_t).count();
+		const uint64_t latency_us = end_us - std::min(end_us, frame_publish_us);
+		presentation_stats.num_frames_presented++;
+		presentation_stats.last_latency_us = latency_us;
+		presentation_stats.max_latency_us = std::max(presentation_stats.max_latency_us, latency_us);
+		presentation_stats.avg_latency_us += (static_cast<double>(latency_us) - presentation_stats.avg_latency_us) / presentation_stats.num_frames_presented;
+	}
+}
+
+void simple_tiling::set_present_order(simple_tiling_utils::PRESENT_ORDERS order)
+{
+	present_order = order;
+}
+
+uint64_t simple_tiling::GetTilePresentAge(uint32_t tile_ndx)
+{
+	const uint64_t now_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	const uint64_t presented_us = tile_last_presented_us[tile_ndx].load(std::memory_order_relaxed);
+	if (presented_us == 0)
+	{
+		return 0; // Before [setup]; nothing's been on-screen long enough to have an age
+	}
+
+	// The presenter thread can stamp this tile between our clock read and our load
+	return now_us - std::min(now_us, presented_us);
+}
+
+// Called from the WM_PAINT block of your message pump
+// (between BeginPaint() and EndPaint())
+void simple_tiling::win_paint(void* hdc, uint32_t frame_budget_ms)
+{
+	if (presenter_running)
+	{
+		repaint_requested = true; // The presenter thread blits through its own DC; just make sure it redraws everything
+		return;
+	}
+	present(hdc, frame_budget_ms);
+}
+
+void presenter_main()
+{
+	using namespace std::chrono;
+	const microseconds interval(presenter_interval_us);
+
+	// Half the interval for blits, so the flush + any scheduling noise still fit before the deadline
+	const uint32_t blit_budget_ms = std::max(presenter_interval_us / 2000u, 1u);
+	steady_clock::time_point deadline = steady_clock::now() + interval;
+	while (presenter_running)
+	{
+		// Only present when there's something new to show; a new frame, tiles we ran out of budget for last time, or a host repaint
+		const bool repaint = repaint_requested.exchange(false);
+		if (tile_swap_chain.has_fresh_frame() || !present_complete || repaint)
+		{
+			if (repaint)
+			{
+				present_complete = false;
+				std::fill(screen_span_versions, screen_span_versions + (static_cast<uint64_t>(spans_per_tile) * simple_tiling_utils::max_tiles), unknown_screen_version);
+			}
+			simple_tiling::present(presenter_target, blit_budget_ms);
+		}
+
+		// Pace against the refresh interval; if we overran, count the miss and skip ahead to the next interval we can still make
+		// instead of firing a burst of back-to-back presents to catch up
+		const steady_clock::time_point now = steady_clock::now();
+		if (now > deadline)
+		{
+			const uint64_t late_intervals = static_cast<uint64_t>((now - deadline) / interval);
+			{
+				std::lock_guard<std::mutex> stats_guard(presentation_stats_lock);
+				presentation_stats.missed_deadlines++;
+				presentation_stats.dropped_intervals += late_intervals;
+			}
+			deadline += interval * (late_intervals + 1);
+		}
+		{
+			std::unique_lock<std::mutex> wake_guard(presenter_wake_lock);
+			presenter_wake.wait_until(wake_guard, deadline, [] { return !presenter_running; });
+		}
+		deadline += interval;
+	}
+}
+
+void simple_tiling::start_presenter(void* present_target, uint32_t refresh_interval_us)
+{
+	assert(!presenter_running && refresh_interval_us > 0);
+	presenter_target = present_target;
+	presenter_interval_us = refresh_interval_us;
+	present_complete = false; // Make sure the first paced present reaches the screen, even if no new frame has landed yet
+	presenter_running = true;
+	presenter_thread = std::thread(presenter_main);
+}
+
+void simple_tiling::stop_presenter()
+{
+	if (presenter_running)
+	{
+		{
+			std::lock_guard<std::mutex> wake_guard(presenter_wake_lock);
+			presenter_running = false;
+		}
+		presenter_wake.notify_all();
+		presenter_thread.join();
+	}
+}
+
+// Headless equivalent of a submit/WM_PAINT round-trip; draws one full frame and waits for every tile to land in the back-buffer
+// Shared between 8bpc, HDR + fused jobs; plain draw jobs can run [sparse] passes as well
+template<typename job_type>
+void render_frame_job(job_type work, const simple_tiling_utils::damage_rect* damage_rects, uint32_t num_damage_rects, bool sparse = false)
+{
+	ZoneScoped;
+	if (damage_rects != nullptr && num_damage_rects == 0)
+	{
+		return; // Empty damage; the current back-buffer is already up to date
+	}
+
+	// Let tiles drain anything already queued, so the next copy-out from each tile can only come from [work]
+	drain_tiles();
+
+	uint32_t copies_before[simple_tiling_utils::max_tiles] = {};
+	for (uint32_t i = 0; i < numTiles; i++)
+	{
+		copies_before[i] = tile_data[i].threadData.copy_outs;
+	}
+	if constexpr (std::same_as<job_type, simple_tiling_utils::hdr_draw_job>)
+	{
+		if (damage_rects != nullptr)
+		{
+			simple_tiling::submit_hdr_draw_work_damaged(work, damage_rects, num_damage_rects);
+		}
+		else
+		{
+			simple_tiling::submit_hdr_draw_work(work);
+		}
+	}
+	else if constexpr (std::same_as<job_type, const simple_tiling_utils::fused_chain*>)
+	{
+		if (damage_rects != nullptr)
+		{
+			simple_tiling::submit_fused_draw_work_damaged(*work, damage_rects, num_damage_rects);
+		}
+		else
+		{
+			simple_tiling::submit_fused_draw_work(*work);
+		}
+	}
+	else if constexpr (std::same_as<job_type, const simple_tiling_utils::inlined_draw_job*>)
+	{
+		simple_tiling::submit_inlined_draw_job(*work, damage_rects, num_damage_rects, simple_tiling_utils::IMPLICIT_SYNC, UINT64_MAX);
+	}
+	else if constexpr (std::same_as<job_type, simple_tiling_utils::span_draw_job>)
+	{
+		if (damage_rects != nullptr)
+		{
+			simple_tiling::submit_span_draw_work_damaged(work, damage_rects, num_damage_rects);
+		}
+		else
+		{
+			simple_tiling::submit_span_draw_work(work);
+		}
+	}
+	else
+	{
+		if (sparse)
+		{
+			simple_tiling::submit_sparse_draw_work(work);
+		}
+		else if (damage_rects != nullptr)
+		{
+			simple_tiling::submit_draw_work_damaged(work, damage_rects, num_damage_rects);
+		}
+		else
+		{
+			simple_tiling::submit_draw_work(work);
+		}
+	}
+
+	// Block until every tile has copied out, then until the swap-chain frame they landed in has been published
+	uint32_t frame_generation = 0;
+	for (uint32_t i = 0; i < numTiles; i++)
+	{
+		XThreadWrapper::data& tileInfo = tile_data[i].threadData;
+		tileInfo.copy_outs.wait(copies_before[i]);
+		frame_generation = std::max(frame_generation, tileInfo.swap_generation);
+	}
+
+	uint32_t gen = tile_swap_chain.generation;
+	while (gen < frame_generation)
+	{
+		tile_swap_chain.generation.wait(gen);
+		gen = tile_swap_chain.generation;
+	}
+
+	// Frames are complete here, so this is a cheap place to re-balance tiles (if it's enabled + due), and to pick the next frame's resolution
+	simple_tiling::rebalance_tiles();
+	simple_tiling::update_dynamic_resolution();
+}
+
+void simple_tiling::render_frame(simple_tiling_utils::draw_job work, const simple_tiling_utils::damage_rect* damage_rects, uint32_t num_damage_rects)
+{
+	render_frame_job(work, damage_rects, num_damage_rects);
+}
+
+void simple_tiling::render_frame(simple_tiling_utils::hdr_draw_job work, const simple_tiling_utils::damage_rect* damage_rects, uint32_t num_damage_rects)
+{
+	render_frame_job(work, damage_rects, num_damage_rects);
+}
+
+void simple_tiling::render_frame(const simple_tiling_utils::fused_chain& chain, const simple_tiling_utils::damage_rect* damage_rects, uint32_t num_damage_rects)
+{
+	render_frame_job(&chain, damage_rects, num_damage_rects);
+}
+
+void simple_tiling::render_frame(simple_tiling_utils::span_draw_job work, const simple_tiling_utils::damage_rect* damage_rects, uint32_t num_damage_rects)
+{
+	render_frame_job(work, damage_rects, num_damage_rects);
+}
+
+void simple_tiling::render_frame(const simple_tiling_utils::inlined_draw_job& job, const simple_tiling_utils::damage_rect* damage_rects, uint32_t num_damage_rects)
+{
+	render_frame_job(&job, damage_rects, num_damage_rects);
+}
+
+void simple_tiling::render_frame_sparse(simple_tiling_utils::draw_job work)
+{
+	render_frame_job(work, nullptr, 0, true);
+}
+
+simple_tiling_utils::present_stats simple_tiling::GetPresentStats()
+{
+	std::lock_guard<std::mutex> stats_guard(presentation_stats_lock);
+	return presentation_stats;
+}
+
+void simple_tiling::set_output_mode(simple_tiling_utils::OUTPUT_MODES mode, uint32_t* external_buffer, uint32_t external_stride_px)
+{
+	assert(mode != simple_tiling_utils::EXTERNAL_OUTPUT || (external_buffer != nullptr && external_stride_px >= canvas_width));
+	output_mode = mode;
+	external_output = external_buffer;
+	external_output_stride = external_stride_px;
+
+	// Checkerboard reconstruction reads the previous frame back out of the output surface, and we've just switched surfaces
+	for (uint32_t i = 0; i < numTiles; i++)
+	{
+		tile_data[i].threadData.history_valid = false;
+	}
+}
+
+simple_tiling_utils::output_stats simple_tiling::GetOutputStats()
+{
+	simple_tiling_utils::output_stats stats = {};
+	stats.frames = tile_swap_chain.generation;
+	stats.accumulated_samples = accumulating ? UINT32_MAX : 0;
+	uint64_t last_reused = 0;
+	uint64_t last_shaded = 0;
+	for (uint32_t i = 0; i < numTiles; i++)
+	{
+		stats.bytes_shaded += tile_data[i].threadData.bytes_shaded.load(std::memory_order_relaxed);
+		stats.bytes_copied += tile_data[i].threadData.bytes_copied.load(std::memory_order_relaxed);
+		stats.spans_hashed += tile_data[i].threadData.spans_hashed.load(std::memory_order_relaxed);
+		stats.spans_dirty += tile_data[i].threadData.spans_dirty.load(std::memory_order_relaxed);
+		for (uint32_t r = 0; r < 3; r++)
+		{
+			stats.rate_blocks[r] += tile_data[i].threadData.rate_blocks[r].load(std::memory_order_relaxed);
+		}
+		stats.accumulated_samples = std::min(stats.accumulated_samples, tile_data[i].threadData.accum_samples.load(std::memory_order_relaxed));
+		stats.pixels_reused += tile_data[i].threadData.pixels_reused.load(std::memory_order_relaxed);
+		stats.pixels_reshaded += tile_data[i].threadData.pixels_reshaded.load(std::memory_order_relaxed);
+		last_reused += tile_data[i].threadData.last_pixels_reused.load(std::memory_order_relaxed);
+		last_shaded += tile_data[i].threadData.last_pixels_reshaded.load(std::memory_order_relaxed);
+		stats.sparse_pixels += tile_data[i].threadData.sparse_pixels.load(std::memory_order_relaxed);
+		stats.marks_dropped += tile_data[i].threadData.marks_dropped.load(std::memory_order_relaxed);
+		stats.listed_pixels += tile_data[i].threadData.listed_pixels.load(std::memory_order_relaxed);
+		stats.aa_pixels += tile_data[i].threadData.aa_pixels.load(std::memory_order_relaxed);
+	}
+	stats.reuse_ratio = (last_reused + last_shaded) > 0 ? static_cast<float>(static_cast<double>(last_reused) / static_cast<double>(last_reused + last_shaded)) : 0.0f;
+	return stats;
+}
+
+void simple_tiling::set_dirty_tracking(bool enabled)
+{
+	assert(!enabled || output_mode != simple_tiling_utils::EXTERNAL_OUTPUT);
+	if (enabled && !dirty_tracking)
+	{
+		reset_dirty_state(); // Versions went stale while tracking was off
+	}
+	dirty_tracking = enabled;
+}
+
+void simple_tiling::invalidate_screen()
+{
+	if (presenter_running)
+	{
+		repaint_requested = true; // Screen versions belong to the presenter thread; let it reset them
+		return;
+	}
+	std::fill(screen_span_versions, screen_span_versions + (static_cast<uint64_t>(spans_per_tile) * simple_tiling_utils::max_tiles), unknown_screen_version);
+}
+
+const uint32_t* simple_tiling::GetBackBuffer()
+{
+	return tile_swap_chain.buffers[tile_swap_chain.last_published];
+}
+
+bool simple_tiling::dump_frame(const char* path, simple_tiling_utils::FRAME_DUMP_FORMATS format)
+{
+	ZoneScoped;
+	switch (format)
+	{
+		case simple_tiling_utils::PPM_DUMP:
+			return simple_tiling_backends::write_ppm(path, GetBackBuffer(), canvas_width, canvas_height);
+		case simple_tiling_utils::QOI_DUMP:
+			return simple_tiling_backends::write_qoi(path, GetBackBuffer(), canvas_width, canvas_height);
+		default:
+			return false;
+	}
+}
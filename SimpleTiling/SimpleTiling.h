@@ -1,85 +1,877 @@
-#pragma oncex	
-
-#include <stdint.h>
-#include <intrin.h>
-#include <atomic>
-
-// SimpleTiling assumes AVX256 support
-#define NUM_VECTOR_LANES 8
-#define v_access(v) v.m256_f32
-
-namespace simple_tiling_utils
-{
-	static constexpr uint32_t max_tiles = 64;
-
-	// Batched colors for output - would prefer to vectorize these but the logic is awkward and I'm not sure if unsigned integer mode is possible in AVX2
-	struct color_batch
-	{
-		uint32_t colors8bpc[NUM_VECTOR_LANES] = {}; // Assumes calculations use one pixel/lane
-	};
-
-	// Wrapper function definitions, allowing us to pass arbitrary update/draw items through a shared interface
-	using draw_job = void(*)(__m256, uint32_t, color_batch*); // Draw-jobs take worker indices as well as pixel/output colors, so they can access resources created by
-															  // users and not just ones internal to SimpleTiling
-	using update_job = void(*)(uint32_t); // Update jobs need access to worker indices, but nothing otherwise (the actual logic is treated like an arbitrary black-box)
-
-	// Incidental duplication here - draw and update job wrappers take worker indices as well, since they're needed for tile management
-	// (checking if threads are still running, etc.)
-	using draw_job_wrapper = void(*)(uint32_t, draw_job);
-	using update_job_wrapper = void(*)(uint32_t, update_job);
-
-	// Types of job (draw/update/graph), to help with work submission & processing
-	enum WORK_TYPES
-	{
-		DRAW_WORK,
-		UPDATE_WORK
-	};
-
-	enum TASK_SYNC_TYPE
-	{
-		EXPLICIT_SYNC, // A job in the queue has a many-to-many relation to the previous job, so the task has to wait on all instances from any previous tasks before it can launch
-		IMPLICIT_SYNC // A job in the queue has a one-to-one relation to the previous job; that is, each instance only needs to depend on its immediate predecessor in the thread running the graph
-					  // These jobs are implicitly synchronised by the sequencing of the queue, so no actual wait is necessary
-	};
-
-	// Frame abstraction; dispatched continuously early in program startup, independently of the main program loop
-	// Frames are expected to contain update/draw/task-graph submissions (sending these directly in the main program loop is possible, but it will cause blocking on backbuffer updates)
-	// Core implementation (backing thread &c) doesn't need to be user-visible, so it's declared/defined in SimpleTiling.cpp
-	using frame_task = void(*)(); // Frames take no arguments and return nothing - they're empty containers for the work expected in the main program loop
-
-	// Thread signals have three separate states; IDLE, PROCESSING, and UPLOADING
-	// Threads swap to UPLOADING when they're ready for copy-out, and back to IDLE when the CPU finishes with their dat
-	// Threads can process work in any state, but not write out to the scratch buffer until they enter IDLE or PROCESSING
-	enum TILE_STATES
-	{
-		IDLE,
-		PROCESSING,
-		UPLOADING
-	};
-};
-
-class simple_tiling
-{
-	public:
-		// Draw work resolves to an array of colors and interacts with the swap-chain
-		// Work items must accept a vector of pixel indices to operate on + a pointer to a vector of 8bpc colors storing results for each pixel
-		// Tile mask assumes users never request more than 64 threads/tiles
-		// Draw and update work should be submitted from the main loop; whether before or after [swap_tile_buffers] is up to the user
-		static void submit_draw_work(simple_tiling_utils::draw_job work, simple_tiling_utils::TASK_SYNC_TYPE sync_mode = simple_tiling_utils::IMPLICIT_SYNC, uint64_t tile_mask = 0xffffffffffffffff);
-
-		// Update work takes a tile index, but nothing else - all other job inputs/outputs are expected to come from client statics/globals/captures
-		static void submit_update_work(simple_tiling_utils::update_job work, simple_tiling_utils::TASK_SYNC_TYPE sync_mode = simple_tiling_utils::IMPLICIT_SYNC, uint64_t tile_mask = 0xffffffffffffffff);
-
-		// Get the total number of tiles used for the current project + the number per-axis
-		// Useful for managing work distribution between jobs, especially in compute work (where each tile has to manage many individual work items & not a single block of 4/8 vector lanes) (>= 4-8)
-		static uint32_t GetNumTilesTotal();
-		static uint32_t GetNumTilesX();
-		static uint32_t GetNumTilesY();
-
-		// Setup/shutdown
-		static void setup(uint32_t num_tiles, uint32_t window_width, uint32_t window_height, bool using_interlacing);
-		static void shutdown();
-
-		// Called from the WM_PAINT block of your message pump
-		static void win_paint(void* hdc, uint32_t frame_budget_ms);
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <type_traits>
+
+#ifdef _WIN32
+#include <intrin.h>
+#else
+#include <immintrin.h>
+#endif
+
+// SimpleTiling assumes AVX256 support
+#define NUM_VECTOR_LANES 8
+#ifdef _MSC_VER
+#define v_access(v) v.m256_f32
+#else
+#define v_access(v) v // GCC/Clang vector extensions support lane subscripts directly
+#endif
+
+// Function-pointer fused stages (see [simple_tiling_utils::fused_stage]) pass + return whole color vectors; __vectorcall keeps those in YMM registers
+// under MSVC, while the System V ABI has no equivalent, so they go through the stack there. Compile-time chains (see [simple_tiling_utils::fused_kernel])
+// inline their stages instead, so they don't depend on this
+#ifdef _MSC_VER
+#define VECTOR_CALL __vectorcall
+#else
+#define VECTOR_CALL
+#endif
+
+namespace simple_tiling_utils
+{
+	static constexpr uint32_t max_tiles = 64;
+
+	// Batched colors for output - would prefer to vectorize these but the logic is awkward and I'm not sure if unsigned integer mode is possible in AVX2
+	struct color_batch
+	{
+		uint32_t colors8bpc[NUM_VECTOR_LANES] = {}; // Assumes calculations use one pixel/lane
+	};
+
+	// Wrapper function definitions, allowing us to pass arbitrary update/draw items through a shared interface
+	using draw_job = void(*)(__m256, uint32_t, color_batch*); // Draw-jobs take worker indices as well as pixel/output colors, so they can access resources created by
+															  // users and not just ones internal to SimpleTiling
+															  // Lane [i] holds the index (y * width + x) of the pixel stored from colors8bpc[i]; on canvases
+															  // that aren't a multiple of 8 wide, spare lanes in the last batch of each row repeat its last pixel
+															  // Checkerboard passes (see [simple_tiling::setup]) hold every second pixel instead, so lane [i]
+															  // is pixel (index + 2i); kernels that derive x/y from each lane's index work either way
+															  // Dynamic-resolution passes (see [simple_tiling::set_dynamic_resolution]) shade a coarser grid, so
+															  // lanes hold the pixels each sample stands in for (roughly 1 / scale apart, in both directions)
+															  // Coarse shading-rate blocks (see [simple_tiling::set_shading_rates]) hold one pixel per 2x2 or 4x4
+															  // group, with spare lanes repeating the block's last sample
+	// Reprojection callbacks (see [simple_tiling::set_reprojection]) take the same lanes as draw jobs, and fill [prev_pixels] with where each lane's
+	// pixel was on the previous frame (its index there, y * width + x), or -1 wherever history can't be trusted (disocclusions, lighting
+	// changes, anything the kernel wants shaded again)
+	struct reprojection_batch
+	{
+		int32_t prev_pixels[NUM_VECTOR_LANES] = {};
+	};
+	using reprojection_job = void(*)(__m256, uint32_t, reprojection_batch*);
+
+	// Linear, unbounded colors for HDR draw jobs (see [simple_tiling::submit_hdr_draw_work]); one plane per channel, lane [i] for pixel [i]
+	// SimpleTiling applies exposure, tonemapping, sRGB encoding + dithering itself, so kernels never quantize anything
+	struct hdr_color_batch
+	{
+		float red[NUM_VECTOR_LANES] = {};
+		float green[NUM_VECTOR_LANES] = {};
+		float blue[NUM_VECTOR_LANES] = {};
+	};
+	using hdr_draw_job = void(*)(__m256, uint32_t, hdr_color_batch*); // Same lanes as [draw_job]
+
+	// Fused draw chains (see [simple_tiling::submit_fused_draw_work]); every stage runs on a batch before the next batch starts, handing its
+	// colors straight to the next stage as float vectors, so only the last stage's output ever reaches tile memory
+	// Stages take the same lanes as [draw_job], plus the previous stage's colors (zero for the first stage), and return their own
+	// [fused_chain] calls its stages through pointers, so chains can be assembled at runtime (and end in HDR colors); chains known at compile time
+	// should prefer [fused_kernel], which inlines every stage into one tile loop
+	struct color_vectors
+	{
+		__m256 red;
+		__m256 green;
+		__m256 blue;
+	};
+	using fused_stage = color_vectors(VECTOR_CALL*)(__m256, uint32_t, color_vectors);
+
+	static constexpr uint32_t max_fused_stages = 8;
+	struct fused_chain
+	{
+		fused_stage stages[max_fused_stages] = {};
+		uint32_t num_stages = 0;
+		bool hdr = false; // Whether the last stage leaves linear HDR colors (tonemapped like [hdr_draw_job]s) or display colors from 0 to 1
+	};
+
+	// Inlined draw jobs (see [simple_tiling::submit_inlined_draw_work]); the kernel's own type instantiates a copy of the tile loop with the kernel
+	// inlined into it, so batches don't pay for an indirect call each, and anything the kernel derives from constants (canvas size, splats,
+	// per-frame uniforms captured by value) hoists out of the loop instead of being rebuilt per batch
+	// Kernels are any callable with [draw_job]'s signature; they're copied into the job queue, so captures need to be trivially copyable + small
+	struct shade_block_args
+	{
+		uint32_t* out_origin; // Output pixel for ([origin_x], [origin_y]), rows [out_stride] pixels apart
+		uint32_t out_stride;
+		uint32_t origin_x;
+		uint32_t origin_y;
+		uint32_t x0; // Pixels to shade; [x0, x1) * [y0, y1), with [x0] on the output's batch grid
+		uint32_t x1;
+		uint32_t y0;
+		uint32_t y1;
+		uint32_t canvas_width;
+		uint32_t tile_id;
+		bool padded_output; // Whether rows have room for whole batches past [x1]
+	};
+
+	// Shade every batch in a block with [job], and return how many batches that took; shared by every block loop SimpleTiling runs, so
+	// function-pointer jobs instantiate this with [draw_job], and inlined jobs with their own kernel type
+	template<typename kernel>
+	uint64_t shade_block_rows(const kernel& job, const shade_block_args& block)
+	{
+		const __m256 lane_offsets = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+		const __m256i lane_ids = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+		uint64_t num_batches = 0;
+		for (uint32_t pixel_row = block.y0; pixel_row < block.y1; pixel_row++)
+		{
+			uint32_t* out_row = block.out_origin + (static_cast<uint64_t>(pixel_row - block.origin_y) * block.out_stride);
+			for (uint32_t pixel_batch = block.x0; pixel_batch < block.x1; pixel_batch += NUM_VECTOR_LANES) // For each vectorized pixel batch
+			{
+				// Define outputs
+				color_batch* batch_colors = reinterpret_cast<color_batch*>(out_row + (pixel_batch - block.origin_x));
+
+				// Issue work
+				// Lane [i] always shades pixel [init_px + i], matching colors8bpc[i]
+				const float init_px = static_cast<float>((pixel_row * block.canvas_width) + pixel_batch);
+				const uint32_t valid_lanes = (block.x1 - pixel_batch) < NUM_VECTOR_LANES ? (block.x1 - pixel_batch) : NUM_VECTOR_LANES;
+				if (valid_lanes == NUM_VECTOR_LANES)
+				{
+					job(_mm256_add_ps(_mm256_set1_ps(init_px), lane_offsets), block.tile_id, batch_colors);
+				}
+				else
+				{
+					// Partial batch at the edge of the canvas; the spare lanes repeat the last real pixel, so kernels never see indices past the
+					// end of the row (or the canvas), and the batch still runs as one full vector
+					const __m256 tail_px = _mm256_add_ps(_mm256_set1_ps(init_px), _mm256_min_ps(lane_offsets, _mm256_set1_ps(static_cast<float>(valid_lanes - 1))));
+					if (block.padded_output)
+					{
+						job(tail_px, block.tile_id, batch_colors);
+					}
+					else
+					{
+						// No room past the edge here (that's the next row, or another tile) - shade into a scratch batch, then only store the real lanes
+						color_batch tail_colors;
+						job(tail_px, block.tile_id, &tail_colors);
+						const __m256i lane_mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(valid_lanes)), lane_ids);
+						_mm256_maskstore_epi32(reinterpret_cast<int*>(batch_colors), lane_mask, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(tail_colors.colors8bpc)));
+					}
+				}
+				num_batches++;
+			}
+		}
+		return num_batches;
+	}
+
+	static constexpr uint32_t max_inlined_kernel_bytes = 64;
+	struct inlined_draw_job
+	{
+		uint64_t(*block_loop)(const void*, const shade_block_args&) = nullptr; // [shade_block_rows], specialized for the kernel
+		void(*batch_job)(const void*, __m256, uint32_t, color_batch*) = nullptr; // One batch at a time, for passes that choose their own lanes
+																				  // (checkerboards, upscaling, coarse rates, accumulation...)
+		alignas(32) uint8_t kernel[max_inlined_kernel_bytes] = {}; // The kernel object itself
+	};
+
+	// Package [work] up for [simple_tiling::submit_inlined_draw_work]
+	template<typename kernel>
+	inlined_draw_job make_inlined_draw_job(const kernel& work)
+	{
+		static_assert(std::is_trivially_copyable_v<kernel> && std::is_trivially_destructible_v<kernel>, "Inlined kernels are copied into the job queue byte-for-byte");
+		static_assert(sizeof(kernel) <= max_inlined_kernel_bytes && alignof(kernel) <= 32, "Inlined kernels need to fit in [inlined_draw_job::kernel]; capture pointers to big data instead");
+		inlined_draw_job job;
+		job.block_loop = [](const void* k, const shade_block_args& block) { return shade_block_rows(*static_cast<const kernel*>(k), block); };
+		job.batch_job = [](const void* k, __m256 pixels, uint32_t tile_id, color_batch* colors_out) { (*static_cast<const kernel*>(k))(pixels, tile_id, colors_out); };
+		memcpy(job.kernel, &work, sizeof(kernel));
+		return job;
+	}
+
+	// Scale display colors (0 to 1) to 8 bits, rounded + clamped, and store them to [colors_out]; how 8bpc fused chains end
+	inline void store_display_colors(const color_vectors& colors, color_batch* colors_out)
+	{
+		const __m256 scale = _mm256_set1_ps(255.0f);
+		const __m256i zero = _mm256_setzero_si256();
+		const __m256i max_channel = _mm256_set1_epi32(255);
+		const __m256i r = _mm256_min_epi32(_mm256_max_epi32(_mm256_cvtps_epi32(_mm256_mul_ps(colors.red, scale)), zero), max_channel);
+		const __m256i g = _mm256_min_epi32(_mm256_max_epi32(_mm256_cvtps_epi32(_mm256_mul_ps(colors.green, scale)), zero), max_channel);
+		const __m256i b = _mm256_min_epi32(_mm256_max_epi32(_mm256_cvtps_epi32(_mm256_mul_ps(colors.blue, scale)), zero), max_channel);
+		const __m256i packed = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(r, 16), _mm256_slli_epi32(g, 8)), b);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(colors_out->colors8bpc), packed);
+	}
+
+	// Compile-time fused chains; every stage is a callable with [fused_stage]'s signature (lambdas, function objects, [static_stage]s), and the
+	// chain is an inlined kernel (see [make_inlined_draw_job]) in its own right, so submitting it instantiates [shade_block_rows] with every stage
+	// inlined into the batch loop; colors stay in registers between stages on every compiler, and each batch ends in display colors like an
+	// 8bpc [fused_chain]. Stages are copied into the chain, so their captures follow the same rules as inlined kernels
+	template<typename... stages>
+	struct fused_stage_list
+	{
+		color_vectors operator()(__m256, uint32_t, color_vectors colors) const
+		{
+			return colors;
+		}
+	};
+
+	template<typename stage, typename... later_stages>
+	struct fused_stage_list<stage, later_stages...>
+	{
+		stage first;
+		fused_stage_list<later_stages...> rest;
+
+		fused_stage_list(const stage& s, const later_stages&... later) : first(s), rest(later...) {}
+		color_vectors operator()(__m256 pixels, uint32_t tile_id, color_vectors colors) const
+		{
+			return rest(pixels, tile_id, first(pixels, tile_id, colors));
+		}
+	};
+
+	template<typename... stages>
+	struct fused_kernel
+	{
+		fused_stage_list<stages...> chain;
+
+		fused_kernel(const stages&... s) : chain(s...) {}
+		void operator()(__m256 pixels, uint32_t tile_id, color_batch* colors_out) const
+		{
+			store_display_colors(chain(pixels, tile_id, { _mm256_setzero_ps(), _mm256_setzero_ps(), _mm256_setzero_ps() }), colors_out);
+		}
+	};
+
+	// Chain [stage_list] into one kernel, for [simple_tiling::submit_inlined_draw_work] or [simple_tiling::render_frame_inlined]
+	template<typename... stages>
+	fused_kernel<stages...> fuse_stages(const stages&... stage_list)
+	{
+		static_assert(sizeof...(stages) > 0 && sizeof...(stages) <= max_fused_stages, "Fused chains take between one and [max_fused_stages] stages");
+		return fused_kernel<stages...>(stage_list...);
+	}
+
+	// Wraps a plain stage function as a type, so [fuse_stages] can inline it; function pointers passed directly are still called through
+	template<auto stage_fn>
+	struct static_stage
+	{
+		color_vectors operator()(__m256 pixels, uint32_t tile_id, color_vectors colors) const
+		{
+			return stage_fn(pixels, tile_id, colors);
+		}
+	};
+
+	// Span draw jobs (see [simple_tiling::submit_span_draw_work]) shade a whole block per call instead of one batch; pixels [x, x + count) on each
+	// of rows [y, y + num_rows), written to [dst] (rows [dst_stride] pixels apart), plus a tile index like [draw_job]
+	// Kernels loop over the block themselves, so anything invariant across it (per-row maths, constants, state) stays in registers, and
+	// they're free to unroll/software-pipeline several vectors at a time. [count] is always a whole number of batches; blocks at the right edge of
+	// a region carry on up to seven pixels past it (past the edge of the canvas, at the far right), into memory SimpleTiling throws away
+	using span_draw_job = void(*)(uint32_t* dst, uint32_t dst_stride, uint32_t x, uint32_t y, uint32_t count, uint32_t num_rows, uint32_t tile_id);
+
+	using update_job = void(*)(uint32_t); // Update jobs need access to worker indices, but nothing otherwise (the actual logic is treated like an arbitrary black-box)
+
+	// Canvas-space rectangle, in pixels; max bounds are exclusive
+	// Rows follow the back-buffer, so under GDI row 0 is the *bottom* of the window (flip window-space rects like PAINTSTRUCT::rcPaint first)
+	struct damage_rect
+	{
+		uint32_t minX;
+		uint32_t minY;
+		uint32_t maxX;
+		uint32_t maxY;
+	};
+
+	// Rectangles carried by a damage-driven draw job (see [simple_tiling::submit_draw_work_damaged])
+	struct damage_list
+	{
+		static constexpr uint32_t max_rects = 64;
+		damage_rect rects[max_rects] = {};
+		uint32_t num_rects = 0;
+		bool sparse = false; // Sparse passes (see [simple_tiling::submit_sparse_draw_work]) travel as damage-driven ones with no rects, and shade each tile's pixel list instead
+	};
+
+	// What draw jobs really are, underneath the [draw_job] they travel through the job queue as
+	enum DRAW_JOB_TYPES
+	{
+		PLAIN_DRAW_JOB,
+		HDR_DRAW_JOB, // [hdr_draw_job]
+		FUSED_DRAW_JOB, // const [fused_chain]*
+		INLINED_DRAW_JOB, // const [inlined_draw_job]*
+		SPAN_DRAW_JOB // [span_draw_job]
+	};
+
+	// Incidental duplication here - draw and update job wrappers take worker indices as well, since they're needed for tile management
+	// (checking if threads are still running, etc.)
+	// Draw wrappers also take the job's damage list, or nullptr for full-tile work, the render-scale level it was submitted at, and what the
+	// job really is
+	using draw_job_wrapper = void(*)(uint32_t, draw_job, const damage_list*, uint32_t, DRAW_JOB_TYPES);
+	using update_job_wrapper = void(*)(uint32_t, update_job);
+
+	// Types of job (draw/update/graph), to help with work submission & processing
+	enum WORK_TYPES
+	{
+		DRAW_WORK,
+		UPDATE_WORK
+	};
+
+	enum TASK_SYNC_TYPE
+	{
+		EXPLICIT_SYNC, // A job in the queue has a many-to-many relation to the previous job, so the task has to wait on all instances from any previous tasks before it can launch
+		IMPLICIT_SYNC // A job in the queue has a one-to-one relation to the previous job; that is, each instance only needs to depend on its immediate predecessor in the thread running the graph
+					  // These jobs are implicitly synchronised by the sequencing of the queue, so no actual wait is necessary
+	};
+
+	// Frame abstraction; dispatched continuously early in program startup, independently of the main program loop
+	// Frames are expected to contain update/draw/task-graph submissions (sending these directly in the main program loop is possible, but it will cause blocking on backbuffer updates)
+	// Core implementation (backing thread &c) doesn't need to be user-visible, so it's declared/defined in SimpleTiling.cpp
+	using frame_task = void(*)(); // Frames take no arguments and return nothing - they're empty containers for the work expected in the main program loop
+
+	// Thread signals have three separate states; IDLE, PROCESSING, and UPLOADING
+	// Threads swap to UPLOADING when they're ready for copy-out, and back to IDLE once their pixels have landed in the swap-chain's write buffer
+	// Threads can process work in any state; the swap-chain (not the tile state) decides when they're allowed to write out
+	enum TILE_STATES
+	{
+		IDLE,
+		PROCESSING,
+		UPLOADING
+	};
+
+	// Presentation backends; chosen once in [setup], and used for every blit issued by [present]/[win_paint]
+	enum PRESENT_BACKENDS
+	{
+		GDI_BACKEND, // SetDIBitsToDevice into a window HDC (Windows only)
+		HEADLESS_BACKEND, // No window at all; frames stay in the back-buffer until the host reads/dumps them (render farms, benchmarks, CI)
+		X11_SHM_BACKEND // XShmPutImage from a shared-memory back-buffer (Linux, built with SIMPLE_TILING_X11 + linked against libX11/libXext)
+						// Falls back to XPutImage when the server can't share memory with us, and to a per-blit conversion on TrueColor visuals that
+						// don't store 0x00RRGGBB pixels (e.g. 16-bit); other visual classes present nothing
+	};
+
+	// X11 presentation target; hand one of these to [setup] (as [backend_target]) so the backend can create its shared-memory image
+	// Kept as void*/unsigned long so SimpleTiling.h doesn't drag Xlib into every translation unit
+	// Note that X11 images are top-down, so pixel row 0 is the top of the window here (vs. the bottom under GDI)
+	struct x11_target
+	{
+		void* display; // Display*
+		unsigned long window; // Window
+	};
+
+#ifdef _WIN32
+	static constexpr PRESENT_BACKENDS default_backend = GDI_BACKEND;
+#else
+	static constexpr PRESENT_BACKENDS default_backend = HEADLESS_BACKEND;
+#endif
+
+	// Backend interface - same C-style polymorphism as the job wrappers, one function table per backend
+	// [present_target] is whatever the backend needs to reach the screen (an HDC for GDI, nothing for headless, an x11_target for X11)
+	// [init] may fill [canvases] with backend-owned swap-chain memory (e.g. shared-memory segments the display server reads directly)
+	// and return true; SimpleTiling then uses those as its back-buffers instead of allocating its own, so presenting needs no extra copies
+	struct present_backend
+	{
+		bool(*init)(uint32_t canvas_width, uint32_t canvas_height, void* backend_target, uint32_t** canvases, uint32_t num_canvases);
+		void(*blit)(void* present_target, const uint32_t* canvas, uint32_t canvas_width, uint32_t canvas_height, uint32_t x, uint32_t y, uint32_t w, uint32_t h);
+		void(*flush)(void* present_target); // Called once per [present], after the last blit; backends with asynchronous submission wait for completion here
+		void(*shutdown)();
+	};
+
+	// Presentation timings, for comparing backends against each other
+	struct present_stats
+	{
+		uint64_t num_presents = 0;
+		uint64_t num_blits = 0; // Coalesced blits, summed over every present
+		uint64_t pixels_blitted = 0; // Pixels actually uploaded; drops well below (presents * canvas area) with dirty tracking on mostly-static content
+		uint64_t last_present_us = 0; // Wall-clock time for the most recent [present], including the backend flush
+		uint64_t max_present_us = 0;
+		double avg_present_us = 0.0; // Running mean over every present since [setup]
+		uint64_t max_tile_age_us = 0; // Longest time any tile has gone without reaching the screen, as of the last present
+		double avg_tile_age_us = 0.0; // Mean of the same, over every tile
+
+		// Latency from a frame being published by the tiles to the end of the first present that shows it
+		uint64_t num_frames_presented = 0; // Distinct frames (stale re-presents don't count)
+		uint64_t last_latency_us = 0;
+		uint64_t max_latency_us = 0;
+		double avg_latency_us = 0.0;
+
+		// Presenter-thread pacing (see [simple_tiling::start_presenter]); zero when presenting from the message pump
+		uint64_t missed_deadlines = 0; // Presents that overran the refresh interval they started in
+		uint64_t dropped_intervals = 0; // Whole refresh intervals skipped to catch back up after a miss
+	};
+
+	// Order [present] walks tiles in; matters once [frame_budget_ms] is too tight to blit everything in one call
+	enum PRESENT_ORDERS
+	{
+		ROUND_ROBIN_PRESENT, // Resume from wherever the previous present ran out of budget (default)
+		OLDEST_FIRST_PRESENT // Tiles that have gone longest without reaching the screen go first
+	};
+
+	// How the canvas is divided between tiles; pass to [simple_tiling::setup], or switch live with [simple_tiling::set_tile_layout]
+	enum TILE_LAYOUTS
+	{
+		SQUARE_TILES, // Squarest columns * rows grid that divides the tile count (default); best cache locality for texture/SDF kernels
+		STRIP_TILES, // Full-width horizontal strips; each tile's rows are contiguous in the back-buffer, so copy-out is one long run per tile
+		MORTON_TILES // 32x32 micro-tiles in Morton (Z-curve) order, dealt round-robin to tiles; every tile samples the whole canvas, so expensive
+					 // areas (geometry, detail) spread evenly over workers without any measurement. Presents as one full-canvas blit unless dirty
+					 // tracking is on, since the micro-tiles are too small + scattered to upload one-by-one
+	};
+
+	// Where draw passes write their colors
+	enum OUTPUT_MODES
+	{
+		TILE_BUFFER_OUTPUT, // Kernels write into per-tile scratch, then each tile copies its rows into the swap-chain (default; the only mode
+							// that keeps kernel output between frames, so the only one that supports interlacing)
+		DIRECT_OUTPUT, // Kernels write straight into the swap-chain's write buffer; no scratch and no copy-out (interlacing is ignored)
+		EXTERNAL_OUTPUT // Kernels write straight into host memory with its own row stride; the host owns presentation in this mode (interlacing is ignored)
+	};
+
+	// Framebuffer traffic, cumulative since [setup]
+	// Divide by [frames] for per-frame figures; [bytes_shaded] counts kernel output, [bytes_copied] counts copy-out reads + writes
+	struct output_stats
+	{
+		uint64_t frames = 0;
+		uint64_t bytes_shaded = 0;
+		uint64_t bytes_copied = 0;
+		uint64_t spans_hashed = 0; // Dirty tracking only; row-spans checked for changes, and how many of those actually changed
+		uint64_t spans_dirty = 0;
+		uint64_t rate_blocks[3] = {}; // Variable-rate shading only; blocks shaded at each of [SHADING_RATES]
+		uint32_t accumulated_samples = 0; // Accumulation only; samples per pixel in the least-refined tile (see [simple_tiling::set_accumulation])
+		uint64_t pixels_reused = 0; // Reprojection only; pixels copied from history vs. pixels shaded in full passes (see [simple_tiling::set_reprojection])
+		uint64_t pixels_reshaded = 0;
+		float reuse_ratio = 0.0f; // Share of pixels reused over every tile's latest full pass
+		uint64_t sparse_pixels = 0; // Pixel lists only; listed pixels shaded by sparse passes, and marks dropped because a list was full (see [simple_tiling::mark_pixels])
+		uint64_t marks_dropped = 0;
+		uint32_t listed_pixels = 0; // Pixels marked by every tile's latest pass, waiting on the next sparse pass
+		uint64_t aa_pixels = 0; // Anti-aliasing only; edge pixels re-shaded with extra samples (see [simple_tiling::set_anti_aliasing])
+	};
+
+	// Sub-pixel offset for the sample a tile is currently shading, in pixels (-0.5 to 0.5 on each axis, or -1 to 1 for tent-filtered
+	// anti-aliasing), + how many samples came before it; see [simple_tiling::GetSampleJitter]
+	struct sample_jitter
+	{
+		float x = 0.0f;
+		float y = 0.0f;
+		uint32_t sample_index = 0;
+	};
+
+	// Per-frame constants, published by the host (see [simple_tiling::publish_frame_constants]) and read by jobs through
+	// [simple_tiling::GetFrameConstants]; published snapshots are never written again, so jobs can read them without locks
+	// [user_data] holds whatever else the app wants shared between update + draw jobs; see [user]/[set_user]
+	static constexpr uint32_t max_frame_user_bytes = 256;
+	struct frame_constants
+	{
+		uint64_t frame_index = 0; // Filled in on publish; zero until the host publishes anything
+		double time = 0.0; // Seconds, from whichever clock the host likes
+		float delta_time = 0.0f;
+		float camera_position[3] = {};
+		float camera_forward[3] = { 0.0f, 0.0f, 1.0f };
+		float camera_up[3] = { 0.0f, 1.0f, 0.0f };
+		float camera_fov_y = 1.0f; // Radians
+		alignas(32) uint8_t user_data[max_frame_user_bytes] = {};
+
+		template<typename user_type>
+		const user_type& user() const
+		{
+			static_assert(sizeof(user_type) <= max_frame_user_bytes && alignof(user_type) <= 32 && std::is_trivially_copyable_v<user_type>,
+						  "Frame user data needs to be trivially copyable, and fit in [max_frame_user_bytes]");
+			return *reinterpret_cast<const user_type*>(user_data);
+		}
+
+		template<typename user_type>
+		void set_user(const user_type& data)
+		{
+			static_assert(sizeof(user_type) <= max_frame_user_bytes && alignof(user_type) <= 32 && std::is_trivially_copyable_v<user_type>,
+						  "Frame user data needs to be trivially copyable, and fit in [max_frame_user_bytes]");
+			memcpy(user_data, &data, sizeof(user_type));
+		}
+	};
+
+	// Variable-rate shading; the canvas splits into [shading_rate_block_px]-square blocks, and each block runs one kernel invocation per pixel,
+	// per 2x2 pixels, or per 4x4 pixels (copying each result over its group)
+	static constexpr uint32_t shading_rate_block_px = 8;
+	enum SHADING_RATES : uint8_t
+	{
+		RATE_1X1,
+		RATE_2X2,
+		RATE_4X4
+	};
+
+	// Where shading rates come from; see [simple_tiling::set_shading_rates]
+	enum SHADING_RATE_MODES
+	{
+		FULL_RATE_SHADING, // Every pixel shades (default)
+		USER_RATE_SHADING, // Rates come from a host-provided map
+		ADAPTIVE_RATE_SHADING // Rates follow each block's contrast in the previous frame; flat areas (skies, backgrounds) drop to coarse rates
+	};
+
+	// Where HDR draw jobs keep their output before it's tonemapped (see [simple_tiling::set_hdr_buffering])
+	enum HDR_FORMATS
+	{
+		HDR_UNBUFFERED, // Tonemap every batch as soon as it's shaded (default)
+		HDR_FLOAT16, // Half-float RGB tile buffers (6 bytes per pixel)
+		HDR_FLOAT32 // Float RGB tile buffers (12 bytes per pixel)
+	};
+
+	// Tonemapping curves for HDR draw jobs (see [simple_tiling::set_tonemapping])
+	enum TONEMAP_OPERATORS
+	{
+		TONEMAP_CLAMP, // No curve; anything past 1.0 clips
+		TONEMAP_REINHARD, // x / (1 + x), per channel
+		TONEMAP_ACES // Narkowicz's fit of the ACES filmic curve (default)
+	};
+
+	// Adaptive anti-aliasing; edge pixels shade extra samples at sub-pixel offsets, see [simple_tiling::set_anti_aliasing]
+	enum ANTI_ALIASING_MODES
+	{
+		AA_OFF, // One sample per pixel (default)
+		AA_ADAPTIVE_4X, // Edge pixels add four samples (rotated grid)
+		AA_ADAPTIVE_8X // Edge pixels add eight samples (sparse 8-queens grid)
+	};
+
+	// How edge pixels' samples are weighted together
+	enum AA_FILTERS
+	{
+		AA_BOX_FILTER, // Samples cover the pixel, all weighted equally (default)
+		AA_TENT_FILTER // Samples cover twice the pixel's width, weighted by distance from its centre; softer, with less crawl along thin edges
+	};
+
+	// Post-processing; neighbourhood filters run over each finished frame, see [simple_tiling::set_post_processing]
+	static constexpr uint32_t max_post_effects = 8;
+	static constexpr uint32_t max_post_halo = 32;
+	enum POST_EFFECT_TYPES
+	{
+		SEPARABLE_POST_EFFECT, // Weighted sum over a row of (2 * halo + 1) pixels, then over a column of them (blurs, bloom spreads)
+		KERNEL_POST_EFFECT // Arbitrary [post_job] per batch (sharpening, edge detection, anything non-separable)
+	};
+
+	// Post-processing kernels take a pointer to the first pixel of their batch in the effect's input (a full frame, 32bpp, rows [stride] pixels
+	// apart), the batch's pixel indices (same lanes as [draw_job]), a tile index, and somewhere to write eight output colors
+	// Every pixel up to the effect's [halo] away from the batch is readable, including past the edges of the canvas (edge pixels repeat outwards)
+	using post_job = void(*)(const uint32_t*, uint32_t, __m256, uint32_t, color_batch*);
+
+	struct post_effect
+	{
+		POST_EFFECT_TYPES type = SEPARABLE_POST_EFFECT;
+		uint32_t halo = 0; // Furthest any output pixel reads from its own position, in pixels (up to [max_post_halo])
+		const float* weights = nullptr; // Separable effects only; (2 * halo + 1) horizontal taps, centred on each pixel
+		const float* weights_y = nullptr; // Vertical taps, or nullptr to re-use [weights]
+		post_job job = nullptr; // Kernel effects only
+	};
+
+	// Adaptive tiling; per-tile draw times, averaged over each measurement window (see [simple_tiling::set_adaptive_tiling])
+	// Balance is max/mean; 1.0 means every worker finished at the same time
+	struct balance_stats
+	{
+		uint64_t num_rebalances = 0;
+		double max_tile_us = 0.0; // Latest window
+		double mean_tile_us = 0.0;
+		double max_tile_us_before = 0.0; // Window that triggered the latest rebalance
+		double mean_tile_us_before = 0.0;
+		double max_tile_us_after = 0.0; // First full window after the latest rebalance
+		double mean_tile_us_after = 0.0;
+		double predicted_balance = 0.0; // What the cost map expected from the latest partition
+	};
+
+	// Dynamic resolution renders at (render_scale_steps - level) / render_scale_steps of the canvas' size on each axis; level zero is native
+	static constexpr uint32_t render_scale_steps = 32;
+
+	// Dynamic-resolution controller decisions, cumulative since it was last enabled (see [simple_tiling::set_dynamic_resolution])
+	struct resolution_stats
+	{
+		uint64_t frames = 0; // Frames the controller has measured
+		uint64_t scale_changes = 0;
+		uint64_t frames_over_budget = 0;
+		float render_scale = 1.0f; // Per-axis scale new draw work renders at
+		uint32_t render_width = 0; // Internal resolution at [render_scale]
+		uint32_t render_height = 0;
+		float min_render_scale = 1.0f; // Lowest scale used so far
+		double avg_render_scale = 0.0; // Mean over [frames]
+		double last_frame_ms = 0.0; // Slowest tile's latest full draw pass (shading + upscale)
+		double predicted_frame_ms = 0.0; // What the controller expects from [render_scale]
+	};
+
+	// Image formats supported by [simple_tiling::dump_frame]
+	enum FRAME_DUMP_FORMATS
+	{
+		PPM_DUMP, // Binary P6, no compression; readable by practically everything
+		QOI_DUMP // "Quite OK Image" format, lossless + much smaller than PPM for the kind of images we tend to render
+	};
+};
+
+class simple_tiling
+{
+	public:
+		// Draw work resolves to an array of colors and interacts with the swap-chain
+		// Work items must accept a vector of pixel indices to operate on + a pointer to a vector of 8bpc colors storing results for each pixel
+		// Tile mask assumes users never request more than 64 threads/tiles
+		// Draw and update work should be submitted from the main loop; whether before or after [swap_tile_buffers] is up to the user
+		static void submit_draw_work(simple_tiling_utils::draw_job work, simple_tiling_utils::TASK_SYNC_TYPE sync_mode = simple_tiling_utils::IMPLICIT_SYNC, uint64_t tile_mask = 0xffffffffffffffff);
+
+		// Damage-driven draw work; only pixels inside [rects] are shaded, and tiles that don't intersect any of them skip shading entirely
+		// Rects are clipped against each tile and widened to whole AVX batches; overlapping rects shade their overlap twice, so prefer disjoint
+		// lists (e.g. from GetRegionData). Lists longer than [damage_list::max_rects] have their tail merged into one bounding rect
+		// Everything outside the damage keeps its previous contents, in every output mode; interlacing is skipped for damaged pixels
+		// [rects] is copied, so it doesn't need to outlive the call
+		static void submit_draw_work_damaged(simple_tiling_utils::draw_job work, const simple_tiling_utils::damage_rect* rects, uint32_t num_rects,
+											 simple_tiling_utils::TASK_SYNC_TYPE sync_mode = simple_tiling_utils::IMPLICIT_SYNC, uint64_t tile_mask = 0xffffffffffffffff);
+
+		// HDR draw work; kernels write linear float colors (see [simple_tiling_utils::hdr_color_batch]), and tiles tonemap them with
+		// [set_tonemapping] on the way out. Otherwise the same as [submit_draw_work]/[submit_draw_work_damaged], and works with every other mode
+		// (accumulation averages HDR samples before tonemapping them, so bright highlights don't clip before they're filtered)
+		static void submit_hdr_draw_work(simple_tiling_utils::hdr_draw_job work, simple_tiling_utils::TASK_SYNC_TYPE sync_mode = simple_tiling_utils::IMPLICIT_SYNC, uint64_t tile_mask = 0xffffffffffffffff);
+		static void submit_hdr_draw_work_damaged(simple_tiling_utils::hdr_draw_job work, const simple_tiling_utils::damage_rect* rects, uint32_t num_rects,
+												 simple_tiling_utils::TASK_SYNC_TYPE sync_mode = simple_tiling_utils::IMPLICIT_SYNC, uint64_t tile_mask = 0xffffffffffffffff);
+
+		// Fused draw work; one pass that runs every stage of [chain] per batch (see [simple_tiling_utils::fused_chain]), instead of one pass per
+		// job with colors round-tripping through tile memory in between. 8bpc chains end in display colors (clamped + rounded on the way out);
+		// HDR chains go through [set_tonemapping] + [set_hdr_buffering] like [submit_hdr_draw_work]. Otherwise the same as [submit_draw_work]
+		// [chain] is copied, so it doesn't need to outlive the call. 8bpc chains known at compile time run faster as inlined work, with every stage
+		// inlined into the tile loop (see [simple_tiling_utils::fuse_stages]); this is the fallback for chains built at runtime, and HDR chains
+		static void submit_fused_draw_work(const simple_tiling_utils::fused_chain& chain, simple_tiling_utils::TASK_SYNC_TYPE sync_mode = simple_tiling_utils::IMPLICIT_SYNC,
+										   uint64_t tile_mask = 0xffffffffffffffff);
+		static void submit_fused_draw_work_damaged(const simple_tiling_utils::fused_chain& chain, const simple_tiling_utils::damage_rect* rects, uint32_t num_rects,
+												   simple_tiling_utils::TASK_SYNC_TYPE sync_mode = simple_tiling_utils::IMPLICIT_SYNC, uint64_t tile_mask = 0xffffffffffffffff);
+
+		// Span draw work; kernels shade whole blocks per call (see [simple_tiling_utils::span_draw_job]) instead of one batch at a time
+		// Full-rate passes hand each kernel its whole region (or damage rect) in one go; passes that choose their own lanes (reduced resolution,
+		// coarse shading rates, accumulation, reprojection) shade the smallest span covering each batch, and interlaced passes alternate
+		// eight-pixel cells instead of single pixels (so every call still shades a whole batch). Otherwise the same as [submit_draw_work]/[submit_draw_work_damaged]
+		static void submit_span_draw_work(simple_tiling_utils::span_draw_job work, simple_tiling_utils::TASK_SYNC_TYPE sync_mode = simple_tiling_utils::IMPLICIT_SYNC,
+										  uint64_t tile_mask = 0xffffffffffffffff);
+		static void submit_span_draw_work_damaged(simple_tiling_utils::span_draw_job work, const simple_tiling_utils::damage_rect* rects, uint32_t num_rects,
+												  simple_tiling_utils::TASK_SYNC_TYPE sync_mode = simple_tiling_utils::IMPLICIT_SYNC, uint64_t tile_mask = 0xffffffffffffffff);
+
+		// Inlined draw work; [work] is any callable with [simple_tiling_utils::draw_job]'s signature (usually a lambda), and tiles shade with a
+		// copy of the tile loop built around it (see [simple_tiling_utils::inlined_draw_job]), instead of calling through a pointer per batch
+		// Otherwise the same as [submit_draw_work]/[submit_draw_work_damaged], and works with every other mode; passes that choose their own
+		// lanes (checkerboards, reduced resolution, coarse shading rates, accumulation, reprojection) still call [work] once per batch
+		// [work] is copied, so it doesn't need to outlive the call
+		template<typename kernel>
+		static void submit_inlined_draw_work(const kernel& work, simple_tiling_utils::TASK_SYNC_TYPE sync_mode = simple_tiling_utils::IMPLICIT_SYNC, uint64_t tile_mask = 0xffffffffffffffff)
+		{
+			submit_inlined_draw_job(simple_tiling_utils::make_inlined_draw_job(work), nullptr, 0, sync_mode, tile_mask);
+		}
+
+		template<typename kernel>
+		static void submit_inlined_draw_work_damaged(const kernel& work, const simple_tiling_utils::damage_rect* rects, uint32_t num_rects,
+													 simple_tiling_utils::TASK_SYNC_TYPE sync_mode = simple_tiling_utils::IMPLICIT_SYNC, uint64_t tile_mask = 0xffffffffffffffff)
+		{
+			submit_inlined_draw_job(simple_tiling_utils::make_inlined_draw_job(work), rects, num_rects, sync_mode, tile_mask);
+		}
+
+		// What the templates above submit through; [rects] may be nullptr for full-tile work
+		static void submit_inlined_draw_job(const simple_tiling_utils::inlined_draw_job& job, const simple_tiling_utils::damage_rect* rects, uint32_t num_rects,
+											simple_tiling_utils::TASK_SYNC_TYPE sync_mode, uint64_t tile_mask);
+
+		// Sparse draw work; only pixels on each tile's pixel list are shaded (see [mark_pixels]), packed eight to a batch wherever they sit in the
+		// tile, so irregular refinement (anti-aliasing edges, rays that didn't converge...) keeps every lane busy instead of running whole batches
+		// for a pixel or two. Lane [i] holds the index (y * width + x) of the batch's i-th listed pixel, and spare lanes in each tile's last batch
+		// repeat its last pixel; everything else keeps its previous contents, in every output mode
+		// Sparse passes are draw passes in their own right, so their kernels can mark pixels again (e.g. the rays still marching), and the next
+		// sparse pass only shades those. Like damage-driven passes, they run at native resolution + full rate without checkerboarding, and turn
+		// into full passes in accumulating tiles. They still publish a whole frame; with [set_dirty_tracking], only the spans their pixels landed
+		// in are hashed, and copy-outs skip the rest
+		static void submit_sparse_draw_work(simple_tiling_utils::draw_job work, simple_tiling_utils::TASK_SYNC_TYPE sync_mode = simple_tiling_utils::IMPLICIT_SYNC,
+											uint64_t tile_mask = 0xffffffffffffffff);
+
+		// Put pixels from [pixels] on [tile_id]'s pixel list, for the next sparse pass; lanes with every bit set in [lane_mask] are listed (so
+		// vector compares can be passed straight in), and the rest are skipped. Call from inside draw jobs, with their own tile index + lanes
+		// Marked lanes are stream-compacted onto the end of the list with one shuffle + store; spare lanes repeating the lane before them are
+		// only listed once. Every draw pass starts a new list, so lists always hold whatever the previous pass marked
+		static void mark_pixels(uint32_t tile_id, __m256 pixels, __m256i lane_mask);
+
+		// Update work takes a tile index, but nothing else - all other job inputs/outputs are expected to come from client statics/globals/captures
+		static void submit_update_work(simple_tiling_utils::update_job work, simple_tiling_utils::TASK_SYNC_TYPE sync_mode = simple_tiling_utils::IMPLICIT_SYNC, uint64_t tile_mask = 0xffffffffffffffff);
+
+		// Publish [constants] as the next frame's snapshot (its [frame_index] is filled in here); every job submitted from now until the next
+		// publish reads this snapshot, in every tile, however long it waits in the queue. Call from the thread that submits work, before
+		// submitting the frame's jobs
+		// Snapshots live in a small ring; if a tile is still working through jobs from the frame whose slot comes up next, this waits for them
+		static void publish_frame_constants(const simple_tiling_utils::frame_constants& constants);
+
+		// The snapshot the job running on [tile_id] was submitted with; call from inside update/draw jobs, with their tile index
+		// Stays valid (+ unchanged) until the job returns
+		static const simple_tiling_utils::frame_constants& GetFrameConstants(uint32_t tile_id);
+
+		// Get the total number of tiles used for the current project + the number per-axis
+		// (strips are 1 * N; Morton layouts have no grid, and report N * 1; adaptive tiling keeps reporting the grid tiles started from)
+		// Useful for managing work distribution between jobs, especially in compute work (where each tile has to manage many individual work items & not a single block of 4/8 vector lanes) (>= 4-8)
+		static uint32_t GetNumTilesTotal();
+		static uint32_t GetNumTilesX();
+		static uint32_t GetNumTilesY();
+
+		// Setup/shutdown
+		// Any tile count + resolution works; tiles form whichever columns * rows grid of [num_tiles] gives the squarest tiles, and cover every pixel
+		// [backend_target] is backend-specific setup data (an x11_target* for X11_SHM_BACKEND; unused by GDI/headless)
+		// [using_interlacing] enables checkerboard rendering; each draw pass shades half the pixels ((x + y) even or odd, alternating every pass),
+		// and reconstructs the others from their previous value, clamped per-channel to the range of their four freshly-shaded neighbours
+		// Roughly halves shading cost; static content converges to full detail, moving edges soften slightly for a frame
+		// Span jobs (see [submit_span_draw_work]) checkerboard eight-pixel cells instead, reconstructed from the cells above + below
+		static void setup(uint32_t num_tiles, uint32_t window_width, uint32_t window_height, bool using_interlacing,
+						  simple_tiling_utils::PRESENT_BACKENDS backend = simple_tiling_utils::default_backend, void* backend_target = nullptr,
+						  simple_tiling_utils::TILE_LAYOUTS layout = simple_tiling_utils::SQUARE_TILES);
+		static void shutdown();
+
+		// Resize the canvas and/or change the tile count without restarting; drains queued work, rebuilds the tile layout, tile buffers,
+		// swap-chain and backend resources in-place, and keeps every worker thread that's still needed alive (extra tiles are spawned/retired)
+		// Call from the thread that submits work, e.g. on WM_SIZE; the presenter thread (if any) is paused and resumed around the change
+		// Everything on-screen is invalidated, and external output falls back to TILE_BUFFER_OUTPUT (the host buffer can't follow a resize)
+		// Returns the time taken, in microseconds (should stay well under a frame; mostly drain time + whatever the backend needs)
+		static uint64_t reconfigure(uint32_t window_width, uint32_t window_height, uint32_t num_tiles);
+
+		// Switch tile layouts live; same rules (and return value) as [reconfigure], with the current canvas size + tile count
+		static uint64_t set_tile_layout(simple_tiling_utils::TILE_LAYOUTS layout);
+
+		// Backend-agnostic presentation; blits finished tiles through whichever backend was chosen in [setup]
+		static void present(void* present_target, uint32_t frame_budget_ms);
+
+		// Called from the WM_PAINT block of your message pump
+		// While the presenter thread is running this only requests a repaint, since the presenter owns every blit
+		static void win_paint(void* hdc, uint32_t frame_budget_ms);
+
+		// Optional presenter thread; takes presentation off the message pump and paces it against [refresh_interval_us] instead
+		// [present_target] must stay valid (and usable from another thread) until [stop_presenter]: a GetDC(hwnd) handle for GDI (not the
+		// BeginPaint one), or an x11_target* on a Display connection the host doesn't share between threads (or after XInitThreads) for X11
+		// [shutdown] stops the presenter automatically
+		static void start_presenter(void* present_target, uint32_t refresh_interval_us = 16667);
+		static void stop_presenter();
+
+		// Submit [work] to every tile and block until each tile has drawn it *and* copied it out to the back-buffer
+		// Intended for headless hosts (offline renders, benchmarks); make sure nothing else is submitting work while this runs
+		// Pass [damage_rects] to only shade part of the canvas (see [submit_draw_work_damaged])
+		static void render_frame(simple_tiling_utils::draw_job work, const simple_tiling_utils::damage_rect* damage_rects = nullptr, uint32_t num_damage_rects = 0);
+		static void render_frame(simple_tiling_utils::hdr_draw_job work, const simple_tiling_utils::damage_rect* damage_rects = nullptr, uint32_t num_damage_rects = 0);
+		static void render_frame(const simple_tiling_utils::fused_chain& chain, const simple_tiling_utils::damage_rect* damage_rects = nullptr, uint32_t num_damage_rects = 0);
+		static void render_frame(const simple_tiling_utils::inlined_draw_job& job, const simple_tiling_utils::damage_rect* damage_rects = nullptr, uint32_t num_damage_rects = 0);
+		static void render_frame(simple_tiling_utils::span_draw_job work, const simple_tiling_utils::damage_rect* damage_rects = nullptr, uint32_t num_damage_rects = 0);
+		static void render_frame_sparse(simple_tiling_utils::draw_job work); // Sparse passes (see [submit_sparse_draw_work]) never carry damage
+
+		// [render_frame] for inlined kernels (see [submit_inlined_draw_work]); a separate name, so captureless lambdas meant for the
+		// function-pointer path don't pick this up by accident
+		template<typename kernel>
+		static void render_frame_inlined(const kernel& work, const simple_tiling_utils::damage_rect* damage_rects = nullptr, uint32_t num_damage_rects = 0)
+		{
+			render_frame(simple_tiling_utils::make_inlined_draw_job(work), damage_rects, num_damage_rects);
+		}
+
+		// Read-only view of the most recently completed swap-chain frame (canvas_width * canvas_height 32bpp pixels, bottom-up like the DIB we blit from)
+		// Only stable while tiles are idle (e.g. right after [render_frame]); the buffer is recycled for writing two frames later
+		static const uint32_t* GetBackBuffer();
+
+		// Write the current back-buffer to disk; returns false if the file couldn't be written
+		static bool dump_frame(const char* path, simple_tiling_utils::FRAME_DUMP_FORMATS format);
+
+		// Per-present timings, accumulated since [setup]
+		static simple_tiling_utils::present_stats GetPresentStats();
+
+		// Choose how [present] prioritizes tiles when it can't blit all of them within its budget
+		static void set_present_order(simple_tiling_utils::PRESENT_ORDERS order);
+
+		// Microseconds since the given tile last reached the screen (or since [setup]/[reconfigure], for tiles that haven't been presented yet)
+		// Safe to poll from any thread, including while the presenter thread is running
+		static uint64_t GetTilePresentAge(uint32_t tile_ndx);
+
+		// Choose where draw passes write (see [simple_tiling_utils::OUTPUT_MODES]); only call while tiles are idle (e.g. between [render_frame]s)
+		// [external_buffer]/[external_stride_px] are only used by EXTERNAL_OUTPUT, and must cover the whole canvas
+		static void set_output_mode(simple_tiling_utils::OUTPUT_MODES mode, uint32_t* external_buffer = nullptr, uint32_t external_stride_px = 0);
+
+		// Bytes moved by draw passes + copy-outs, for comparing output modes
+		static simple_tiling_utils::output_stats GetOutputStats();
+
+		// Detect unchanged output and skip work for it; tiles hash their pixels in 16-row spans after every draw pass, copy-outs skip spans
+		// the swap-chain buffer already holds, and presents only upload spans the screen doesn't already show
+		// Costs one read of each tile per pass, so it's only worth it for mostly-static content (dashboards, UI, converged renders)
+		// Tile-buffer + direct output only (external output is presented by the host); only call while tiles are idle
+		static void set_dirty_tracking(bool enabled);
+
+		// Adaptive tiling; time every tile's draw passes, fold those times into a cost map over the canvas, and every [interval_frames] frames
+		// move tile boundaries (cost-weighted recursive bisection) once the slowest tile has stayed over [imbalance_threshold] times the mean for two
+		// windows running
+		// Partitions only change when the cost map predicts a clear improvement, so noisy timings can't make tiles thrash back and forth
+		// Square/strip layouts only (Morton layouts balance themselves); disabling leaves tiles where they are, [set_tile_layout] resets them
+		// Enabling/disabling drains queued work and rebuilds tile memory; while it's on, tile memory keeps room for any partition, so moving tiles
+		// never has to touch the swap-chain
+		static void set_adaptive_tiling(bool enabled, uint32_t interval_frames = 60, float imbalance_threshold = 1.2f);
+
+		// Count a frame towards adaptive tiling, and re-partition if one's due; [render_frame] calls this for you, but hosts driving tiles with
+		// [submit_draw_work] should call it once per frame from the submitting thread. Cheap unless a re-partition actually happens (that drains
+		// queued work first, like [reconfigure]). Returns true if tiles moved
+		static bool rebalance_tiles();
+		static simple_tiling_utils::balance_stats GetBalanceStats();
+
+		// Dynamic resolution; full draw passes shade a reduced grid of samples (down to [min_scale] of the canvas on each axis), then each tile
+		// upscales its own pixels from them with a bilinear filter, optionally sharpened first ([sharpening] from 0 to 1)
+		// The scale is picked once per frame by a controller that keeps the slowest tile's draw pass under [frame_budget_ms]; it drops straight
+		// to whatever fits when frames run over, and climbs back one step at a time once there's clear headroom
+		// Damage-driven work always renders at native resolution. Enabling/disabling drains queued work and rebuilds tile memory, like adaptive
+		// tiling does when it moves tiles
+		static void set_dynamic_resolution(bool enabled, float frame_budget_ms = 16.0f, float min_scale = 0.5f, float sharpening = 0.0f);
+
+		// Measure the latest frame and pick the scale for the next one; [render_frame] calls this for you, but hosts driving tiles with
+		// [submit_draw_work] should call it once per frame from the submitting thread. Returns true if the scale changed
+		static bool update_dynamic_resolution();
+		static simple_tiling_utils::resolution_stats GetResolutionStats();
+
+		// Variable-rate shading for full native-resolution passes (see [simple_tiling_utils::SHADING_RATE_MODES]); blocks are laid out from each tile
+		// region's top-left corner, so tiles never share one
+		// USER_RATE_SHADING reads [rate_map]; one [SHADING_RATES] entry per block of the canvas ((width + 7) / 8 per row, rows following the
+		// back-buffer), and tile blocks straddling several entries take the finest of them. Tiles read it during every pass, so it has to stay valid
+		// until rates are switched off, and should only change between frames
+		// ADAPTIVE_RATE_SHADING measures each block's contrast (its largest per-channel range) after every pass; blocks within [max_coarse_contrast]
+		// shade at 2x2 next time, blocks within half that at 4x4. A few coarse blocks re-shade at full rate every pass (each one every eighth pass),
+		// so detail appearing between samples gets noticed
+		// Checkerboarding is skipped while rates are on; damage-driven + reduced-resolution passes always shade at full rate
+		// Only call while tiles are idle (e.g. between [render_frame]s)
+		static void set_shading_rates(simple_tiling_utils::SHADING_RATE_MODES mode, const uint8_t* rate_map = nullptr, uint8_t max_coarse_contrast = 12);
+
+		// Progressive accumulation for static scenes; every full native-resolution pass adds one more sample per pixel to a float buffer in each
+		// tile, and presents the running average. Up to [max_samples], after which tiles stop shading and just re-present their average
+		// Samples are jittered across each pixel's footprint, but only for kernels that ask; see [GetSampleJitter]. The first sample of every
+		// run sits at the pixel centre, so it matches what the kernel would render without accumulation
+		// Accumulation restarts on [restart_accumulation], on reduced-resolution passes, and in every tile touched by damage-driven work (those
+		// re-shade their whole tile, since their average no longer means anything); checkerboarding + shading rates are skipped while it's on
+		// Enabling/disabling drains queued work and rebuilds tile memory (accumulation needs 12 bytes per pixel). Only color channels are averaged,
+		// so accumulated output always has zero in the top byte
+		static void set_accumulation(bool enabled, uint32_t max_samples = 64);
+
+		// Tell tiles the scene changed; the next pass in every tile starts a new average
+		static void restart_accumulation();
+
+		// Where kernels should place the sample they're shading; add [x]/[y] to each pixel's coordinates before use. [sample_index] also makes a
+		// handy seed for stochastic kernels. Always zero outside accumulation + anti-aliasing. Call from inside draw jobs, with their tile index
+		static simple_tiling_utils::sample_jitter GetSampleJitter(uint32_t tile_id);
+
+		// Adaptive anti-aliasing for full native-resolution passes; once a region is shaded, pixels whose neighbourhood (the pixel + its four
+		// neighbours) spans more than [edge_contrast] in any color channel are listed, re-shaded at every offset of [mode]'s sample pattern
+		// (eight edge pixels to a batch), and resolved together with their first sample through [filter]
+		// Offsets reach kernels through [GetSampleJitter], so only kernels that ask get anti-aliased. Neighbours come from the pixel's own region,
+		// so edges running along region boundaries are only caught from one side
+		// Checkerboarding + shading rates are skipped while it's on; accumulated passes (which jitter every pixel already), reprojected passes, and
+		// damage-driven, sparse + reduced-resolution passes aren't anti-aliased
+		// Switching on/off drains queued work and rebuilds tile memory (edge lists need 4 bytes per pixel of each tile's largest region)
+		static void set_anti_aliasing(simple_tiling_utils::ANTI_ALIASING_MODES mode, simple_tiling_utils::AA_FILTERS filter = simple_tiling_utils::AA_BOX_FILTER,
+									  uint8_t edge_contrast = 32);
+
+		// Temporal reprojection; full native-resolution passes ask [reprojection] where each pixel was on the previous frame, copy its color from
+		// there wherever that's valid, and only run draw jobs for the rest (packed together into full batches)
+		// Previous frames live in a canvas-sized history (three frames' worth, since tiles can run a frame apart); passes that start before every
+		// tile has finished the frame before them shade everything instead. Checkerboarding + shading rates are skipped while reprojecting, and
+		// accumulation takes priority over it
+		// Pass nullptr to disable; enabling/disabling drains queued work and rebuilds tile memory, like [set_accumulation]
+		static void set_reprojection(simple_tiling_utils::reprojection_job reprojection);
+
+		// How HDR draw jobs turn into 8bpc output; colors are scaled by [exposure], mapped through [tonemap], sRGB-encoded (unless [srgb_encode]
+		// is false, for kernels already working in display space), then quantized. [dither] adds a fixed per-pixel offset of up to one 8-bit step
+		// before truncating, which breaks up banding in smooth gradients; it never changes between frames, so static content stays static
+		// Only call while tiles are idle (e.g. between [render_frame]s)
+		static void set_tonemapping(simple_tiling_utils::TONEMAP_OPERATORS tonemap = simple_tiling_utils::TONEMAP_ACES, float exposure = 1.0f, bool srgb_encode = true,
+									bool dither = true);
+
+		// HDR tile buffers; with a float format, full-rate HDR passes shade each region into a float buffer, then resolve it to 8bpc a row at a
+		// time (exposure, tonemap, sRGB encode + dither in one SIMD loop) before copy-out. HDR_UNBUFFERED resolves every batch straight out of
+		// its kernel instead. Checkerboard, variable-rate, reduced-resolution + reprojected passes always work unbuffered, since they filter
+		// display colors
+		// Switching formats drains queued work and rebuilds tile memory, like [set_accumulation]
+		static void set_hdr_buffering(simple_tiling_utils::HDR_FORMATS format);
+
+		// Post-processing; after every draw pass, tiles run [effects] over their regions in order, reading up to each effect's halo from their
+		// neighbours. Tiles store the shaded frame into a padded canvas, wait for each other once, then every effect reads the previous one's
+		// canvas and writes its own, with one more wait between effects (and after a lone effect, so the next pass can't overwrite its input early)
+		// Separable effects run as two vectorized passes per region; the horizontal pass covers the region plus [halo] rows above + below into
+		// float scratch, so the vertical pass needs nothing from other tiles. Effects work on display (8bpc) colors, after tonemapping
+		// Every tile takes part in every pass, so draw work goes to every tile while effects are set (tile masks are ignored). Checkerboarding,
+		// accumulation + reprojection keep working from the unprocessed frame; damage-driven passes re-run effects over whole tiles, since halos
+		// spread damage past its rects
+		// Effects (+ weights) are copied; pass nullptr/0 to disable. Drains queued work and rebuilds tile memory, like [set_accumulation]
+		static void set_post_processing(const simple_tiling_utils::post_effect* effects, uint32_t num_effects);
+
+		// Pixel lists for sparse passes (see [submit_sparse_draw_work]); each tile keeps two (one filling while sparse passes read the other),
+		// with room for every pixel it owns, so they cost eight bytes per pixel. While they're off, [mark_pixels] does nothing and sparse passes
+		// shade nothing. Enabling/disabling drains queued work and rebuilds tile memory, like [set_accumulation]
+		static void set_pixel_lists(bool enabled);
+
+		// Forget what's on screen, so the next present uploads everything (call on window exposes/resizes when dirty tracking is on)
+		static void invalidate_screen();
 };
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+
+// Internal header - shared between SimpleTiling.cpp and the per-platform presentation backends
+// Nothing in here is user-visible; hosts choose a backend through [simple_tiling::setup] and never touch these tables directly
+
+#include "SimpleTiling.h"
+#include <cassert>
+
+namespace simple_tiling_backends
+{
+	// Backend tables, defined in their own translation units (SimpleTilingGDI.cpp, SimpleTilingHeadless.cpp, SimpleTilingX11.cpp)
+#ifdef _WIN32
+	extern const simple_tiling_utils::present_backend gdi_backend;
+#endif
+#if defined(__linux__) && defined(SIMPLE_TILING_X11)
+	extern const simple_tiling_utils::present_backend x11_shm_backend;
+#endif
+	extern const simple_tiling_utils::present_backend headless_backend;
+
+	// Resolve a backend enum to its function table
+	// Backends that don't exist on the current platform fall back to headless, so setup() never hands out a null presenter
+	inline const simple_tiling_utils::present_backend* select(simple_tiling_utils::PRESENT_BACKENDS backend)
+	{
+		switch (backend)
+		{
+#ifdef _WIN32
+			case simple_tiling_utils::GDI_BACKEND:
+				return &gdi_backend;
+#endif
+#if defined(__linux__) && defined(SIMPLE_TILING_X11)
+			case simple_tiling_utils::X11_SHM_BACKEND:
+				return &x11_shm_backend;
+#endif
+			case simple_tiling_utils::HEADLESS_BACKEND:
+				return &headless_backend;
+			default:
+				assert(false); // Requested backend isn't available on this platform
+				return &headless_backend;
+		}
+	}
+
+	// Frame-dump encoders (SimpleTilingHeadless.cpp)
+	// [canvas] is expected in the same bottom-up 0x00RRGGBB layout we blit through GDI; both writers flip it upright
+	bool write_ppm(const char* path, const uint32_t* canvas, uint32_t width, uint32_t height);
+	bool write_qoi(const char* path, const uint32_t* canvas, uint32_t width, uint32_t height);
+};
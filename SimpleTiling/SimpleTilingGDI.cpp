@@ -0,0 +1,58 @@
+// SimpleTilingGDI.cpp : GDI presentation backend (SetDIBitsToDevice into the window HDC handed to [win_paint])
+//
+
+#ifdef _WIN32
+
+#include "SimpleTilingBackends.h"
+#include "../ThirdParty/tracy-0.8/Tracy.hpp"
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#undef min
+#undef max
+
+namespace simple_tiling_backends
+{
+	BITMAPINFO canvas_bmi;
+
+	bool gdi_init(uint32_t canvas_width, uint32_t canvas_height, void* backend_target, uint32_t** canvases, uint32_t num_canvases)
+	{
+		// Prepare BITMAPINFO (needed for Windows' blitting interface)
+		BITMAPINFO nfo;
+		ZeroMemory(&nfo, sizeof(BITMAPINFO));
+		nfo.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+		nfo.bmiHeader.biWidth = canvas_width;
+		nfo.bmiHeader.biHeight = canvas_height;
+		nfo.bmiHeader.biPlanes = 1;
+		nfo.bmiHeader.biBitCount = 32;
+		nfo.bmiHeader.biCompression = BI_RGB;
+		nfo.bmiHeader.biSizeImage = 0;
+		nfo.bmiHeader.biXPelsPerMeter = 0; // 3840 / 36cm
+		nfo.bmiHeader.biYPelsPerMeter = 0; // 2160 / 16cm
+		nfo.bmiHeader.biClrUsed = FALSE;
+		nfo.bmiHeader.biClrImportant = FALSE;
+		canvas_bmi = nfo;
+		return false; // SetDIBitsToDevice reads from any memory, so SimpleTiling can keep its own swap-chain
+	}
+
+	void gdi_blit(void* present_target, const uint32_t* canvas, uint32_t canvas_width, uint32_t canvas_height, uint32_t x, uint32_t y, uint32_t w, uint32_t h)
+	{
+		ZoneScoped;
+		uint32_t test = SetDIBitsToDevice(static_cast<HDC>(present_target), x, y, w, h, x, y, y, h, canvas, &canvas_bmi, DIB_RGB_COLORS);
+		assert(test);
+	}
+
+	void gdi_flush(void* present_target)
+	{
+		// SetDIBitsToDevice is synchronous from our side; nothing to wait on
+	}
+
+	void gdi_shutdown()
+	{
+		// Nothing to release - BITMAPINFO is plain data, and the HDC belongs to the host
+	}
+
+	const simple_tiling_utils::present_backend gdi_backend = { gdi_init, gdi_blit, gdi_flush, gdi_shutdown };
+};
+
+#endif
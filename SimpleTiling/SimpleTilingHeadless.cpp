@@ -0,0 +1,162 @@
+// SimpleTilingHeadless.cpp : Window-less presentation backend + frame dumps (PPM/QOI)
+//
+
+#include "SimpleTilingBackends.h"
+#include "../ThirdParty/tracy-0.8/Tracy.hpp"
+#include <fstream>
+#include <vector>
+
+namespace simple_tiling_backends
+{
+	// Headless presentation is a no-op; tiles still copy into the back-buffer, and hosts read it back with
+	// [simple_tiling::GetBackBuffer] or [simple_tiling::dump_frame]
+	// Parameters are unnamed since none of them matter here; see [simple_tiling_utils::present_backend] for what each one is
+	bool headless_init(uint32_t, uint32_t, void*, uint32_t**, uint32_t) { return false; }
+	void headless_blit(void*, const uint32_t*, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t) {}
+	void headless_flush(void*) {}
+	void headless_shutdown() {}
+
+	const simple_tiling_utils::present_backend headless_backend = { headless_init, headless_blit, headless_flush, headless_shutdown };
+
+	// Shared by both writers; back-buffer rows are bottom-up (positive-height DIB), image formats are top-down
+	const uint32_t* upright_row(const uint32_t* canvas, uint32_t width, uint32_t height, uint32_t y)
+	{
+		return canvas + (static_cast<uint64_t>(height - 1 - y) * width);
+	}
+
+	bool write_ppm(const char* path, const uint32_t* canvas, uint32_t width, uint32_t height)
+	{
+		ZoneScoped;
+		std::ofstream file(path, std::ios::binary);
+		if (!file)
+		{
+			return false;
+		}
+
+		file << "P6\n" << width << " " << height << "\n255\n";
+
+		// One row at a time, so we never hold more than a scanline of repacked pixels
+		std::vector<uint8_t> row(width * 3);
+		for (uint32_t y = 0; y < height; y++)
+		{
+			const uint32_t* src = upright_row(canvas, width, height, y);
+			for (uint32_t x = 0; x < width; x++)
+			{
+				row[(x * 3) + 0] = static_cast<uint8_t>(src[x] >> 16); // R
+				row[(x * 3) + 1] = static_cast<uint8_t>(src[x] >> 8); // G
+				row[(x * 3) + 2] = static_cast<uint8_t>(src[x]); // B
+			}
+			file.write(reinterpret_cast<const char*>(row.data()), row.size());
+		}
+		return file.good();
+	}
+
+	// Minimal QOI encoder (https://qoiformat.org/qoi-specification.pdf)
+	// We only emit 3-channel images - GDI ignores the alpha byte in our DIBs, so dumping it would just record whatever the kernels left there
+	bool write_qoi(const char* path, const uint32_t* canvas, uint32_t width, uint32_t height)
+	{
+		ZoneScoped;
+		struct rgba
+		{
+			uint8_t r, g, b, a;
+			bool operator==(const rgba& other) const { return r == other.r && g == other.g && b == other.b && a == other.a; }
+		};
+
+		std::vector<uint8_t> out;
+		out.reserve(14 + (static_cast<uint64_t>(width) * height * 4) + 8); // Worst case; one QOI_OP_RGB(A) per pixel
+
+		auto push_u32_be = [&out](uint32_t v)
+		{
+			out.push_back(static_cast<uint8_t>(v >> 24));
+			out.push_back(static_cast<uint8_t>(v >> 16));
+			out.push_back(static_cast<uint8_t>(v >> 8));
+			out.push_back(static_cast<uint8_t>(v));
+		};
+
+		// Header
+		out.push_back('q'); out.push_back('o'); out.push_back('i'); out.push_back('f');
+		push_u32_be(width);
+		push_u32_be(height);
+		out.push_back(3); // RGB
+		out.push_back(0); // sRGB with linear alpha
+
+		rgba index[64] = {};
+		rgba prev = { 0, 0, 0, 255 };
+		uint32_t run = 0;
+		const uint64_t num_px = static_cast<uint64_t>(width) * height;
+		uint64_t px_ctr = 0;
+		for (uint32_t y = 0; y < height; y++)
+		{
+			const uint32_t* src = upright_row(canvas, width, height, y);
+			for (uint32_t x = 0; x < width; x++, px_ctr++)
+			{
+				const rgba px = { static_cast<uint8_t>(src[x] >> 16), static_cast<uint8_t>(src[x] >> 8), static_cast<uint8_t>(src[x]), 255 };
+				if (px == prev)
+				{
+					run++;
+					if (run == 62 || px_ctr == (num_px - 1))
+					{
+						out.push_back(static_cast<uint8_t>(0xc0 | (run - 1))); // QOI_OP_RUN
+						run = 0;
+					}
+					continue;
+				}
+
+				if (run > 0)
+				{
+					out.push_back(static_cast<uint8_t>(0xc0 | (run - 1))); // QOI_OP_RUN
+					run = 0;
+				}
+
+				const uint32_t hash = ((px.r * 3) + (px.g * 5) + (px.b * 7) + (px.a * 11)) % 64;
+				if (index[hash] == px)
+				{
+					out.push_back(static_cast<uint8_t>(hash)); // QOI_OP_INDEX
+				}
+				else
+				{
+					index[hash] = px;
+
+					// Alpha is pinned to 255, so we never need QOI_OP_RGBA
+					const int8_t vr = static_cast<int8_t>(px.r - prev.r);
+					const int8_t vg = static_cast<int8_t>(px.g - prev.g);
+					const int8_t vb = static_cast<int8_t>(px.b - prev.b);
+					const int8_t vg_r = static_cast<int8_t>(vr - vg);
+					const int8_t vg_b = static_cast<int8_t>(vb - vg);
+					if (vr > -3 && vr < 2 && vg > -3 && vg < 2 && vb > -3 && vb < 2)
+					{
+						out.push_back(static_cast<uint8_t>(0x40 | ((vr + 2) << 4) | ((vg + 2) << 2) | (vb + 2))); // QOI_OP_DIFF
+					}
+					else if (vg_r > -9 && vg_r < 8 && vg > -33 && vg < 32 && vg_b > -9 && vg_b < 8)
+					{
+						out.push_back(static_cast<uint8_t>(0x80 | (vg + 32))); // QOI_OP_LUMA
+						out.push_back(static_cast<uint8_t>(((vg_r + 8) << 4) | (vg_b + 8)));
+					}
+					else
+					{
+						out.push_back(0xfe); // QOI_OP_RGB
+						out.push_back(px.r);
+						out.push_back(px.g);
+						out.push_back(px.b);
+					}
+				}
+				prev = px;
+			}
+		}
+
+		// End marker
+		for (uint32_t i = 0; i < 7; i++)
+		{
+			out.push_back(0);
+		}
+		out.push_back(1);
+
+		std::ofstream file(path, std::ios::binary);
+		if (!file)
+		{
+			return false;
+		}
+		file.write(reinterpret_cast<const char*>(out.data()), out.size());
+		return file.good();
+	}
+};
@@ -0,0 +1,296 @@
+// SimpleTilingX11.cpp : X11 presentation backend; tiles copy straight into an MIT-SHM image, and presents are XShmPutImage calls
+//
+
+#if defined(__linux__) && defined(SIMPLE_TILING_X11)
+
+#include "SimpleTilingBackends.h"
+#include "../ThirdParty/tracy-0.8/Tracy.hpp"
+#include <bit>
+#include <cstdlib>
+
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <X11/extensions/XShm.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+
+namespace simple_tiling_backends
+{
+	// One image per swap-chain buffer
+	static constexpr uint32_t x11_max_canvases = 4;
+	struct x11_canvas
+	{
+		XShmSegmentInfo shm_info = {};
+		XImage* image = nullptr;
+	};
+
+	// How we reach the screen; decided in [x11_init], from whatever the server + window visual allow
+	enum X11_PRESENT_PATHS
+	{
+		X11_SHM_PRESENT, // Tiles copy into shared-memory images, presented with XShmPutImage (no copies anywhere)
+		X11_PUT_PRESENT, // Tiles copy into plain images, presented with XPutImage (no copies on our side, but every present goes over the socket)
+		X11_CONVERT_PRESENT, // The visual doesn't match our 0x00RRGGBB pixels; SimpleTiling keeps its own canvases, and blits convert into [x11_scratch]
+		X11_NO_PRESENT // Not a TrueColor visual; nothing reaches the screen (frames are still readable through [simple_tiling::GetBackBuffer])
+	};
+
+	simple_tiling_utils::x11_target x11_dest = {};
+	x11_canvas x11_canvases[x11_max_canvases] = {};
+	uint32_t x11_num_canvases = 0;
+	GC x11_gc = nullptr;
+	X11_PRESENT_PATHS x11_path = X11_NO_PRESENT;
+	XImage* x11_scratch = nullptr; // Canvas-sized image in the window's own pixel format, for [X11_CONVERT_PRESENT]
+
+	// Servers can advertise MIT-SHM and still refuse to attach our segments (remote displays, containers in another IPC namespace), and
+	// Xlib's default handler exits on the BadAccess that follows; trap errors around attaches instead, and fall back to XPutImage
+	bool x11_attach_failed = false;
+	int x11_trap_error(Display*, XErrorEvent*)
+	{
+		x11_attach_failed = true;
+		return 0;
+	}
+
+	// Share [canvas]'s pixels with the server; returns false (with nothing left to clean up but the image) if the server can't use them
+	bool x11_attach_shm(Display* display, x11_canvas& canvas, uint32_t canvas_height)
+	{
+		canvas.shm_info.shmid = shmget(IPC_PRIVATE, static_cast<size_t>(canvas.image->bytes_per_line) * canvas_height, IPC_CREAT | 0600);
+		if (canvas.shm_info.shmid == -1)
+		{
+			return false;
+		}
+
+		canvas.shm_info.shmaddr = static_cast<char*>(shmat(canvas.shm_info.shmid, nullptr, 0));
+		if (canvas.shm_info.shmaddr == reinterpret_cast<char*>(-1))
+		{
+			shmctl(canvas.shm_info.shmid, IPC_RMID, nullptr);
+			return false;
+		}
+		canvas.shm_info.readOnly = True; // The server only ever reads from our canvases
+		canvas.image->data = canvas.shm_info.shmaddr;
+
+		// Errors arrive asynchronously; sync once so earlier errors still reach the previous handler, and again so ours sees the attach's
+		x11_attach_failed = false;
+		XSync(display, False);
+		int(*prev_handler)(Display*, XErrorEvent*) = XSetErrorHandler(x11_trap_error);
+		XShmAttach(display, &canvas.shm_info);
+		XSync(display, False);
+		XSetErrorHandler(prev_handler);
+
+		// Mark the segment for deletion now; it stays alive until both we and the server detach, so crashes can't leak it
+		shmctl(canvas.shm_info.shmid, IPC_RMID, nullptr);
+		if (x11_attach_failed)
+		{
+			shmdt(canvas.shm_info.shmaddr);
+			canvas.image->data = nullptr;
+			return false;
+		}
+		return true;
+	}
+
+	// Release [x11_canvases] (whichever path created them) + the conversion image, leaving the GC alone
+	void x11_release_canvases(Display* display)
+	{
+		for (uint32_t i = 0; i < x11_num_canvases; i++)
+		{
+			x11_canvas& canvas = x11_canvases[i];
+			if (canvas.image == nullptr)
+			{
+				continue;
+			}
+
+			if (x11_path == X11_SHM_PRESENT)
+			{
+				XShmDetach(display, &canvas.shm_info);
+				XSync(display, False);
+				shmdt(canvas.shm_info.shmaddr);
+				canvas.image->data = nullptr; // Not ours to free via XDestroyImage
+			}
+			XDestroyImage(canvas.image); // Frees calloc'd canvases as well
+			canvas = {};
+		}
+		x11_num_canvases = 0;
+
+		if (x11_scratch != nullptr)
+		{
+			XDestroyImage(x11_scratch);
+			x11_scratch = nullptr;
+		}
+	}
+
+	// Create one image per canvas along [x11_path]; returns false if any of them can't be used as a swap-chain buffer (the server
+	// refused to share memory, or the images don't come out as tightly-packed 32-bit pixels), after releasing whatever was made so far
+	bool x11_create_canvases(Display* display, const XWindowAttributes& attribs, uint32_t canvas_width, uint32_t canvas_height, uint32_t num_canvases)
+	{
+		for (uint32_t i = 0; i < num_canvases; i++)
+		{
+			x11_canvas& canvas = x11_canvases[i];
+			x11_num_canvases = i + 1;
+			bool usable = false;
+			if (x11_path == X11_SHM_PRESENT)
+			{
+				canvas.image = XShmCreateImage(display, attribs.visual, attribs.depth, ZPixmap, nullptr, &canvas.shm_info, canvas_width, canvas_height);
+				usable = canvas.image != nullptr && x11_attach_shm(display, canvas, canvas_height);
+			}
+			else
+			{
+				char* canvas_mem = static_cast<char*>(calloc(static_cast<size_t>(canvas_width) * canvas_height, sizeof(uint32_t)));
+				canvas.image = XCreateImage(display, attribs.visual, attribs.depth, ZPixmap, 0, canvas_mem, canvas_width, canvas_height, 32, 0);
+				usable = canvas.image != nullptr;
+				if (!usable)
+				{
+					free(canvas_mem);
+				}
+			}
+
+			// Tiles copy directly into the images, so they *are* the swap-chain
+			usable = usable && canvas.image->bits_per_pixel == 32 && canvas.image->bytes_per_line == static_cast<int>(canvas_width * sizeof(uint32_t));
+			if (!usable)
+			{
+				if (canvas.image != nullptr && canvas.image->data == nullptr)
+				{
+					XDestroyImage(canvas.image); // Failed attach; nothing shared to detach
+					canvas = {};
+				}
+				x11_release_canvases(display);
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Pack an 8-bit channel into [mask]'s bits
+	unsigned long x11_pack_channel(uint32_t value, unsigned long mask)
+	{
+		const int shift = std::countr_zero(mask);
+		const int bits = std::popcount(mask);
+		const unsigned long scaled = bits >= 8 ? (static_cast<unsigned long>(value) << (bits - 8)) : (value >> (8 - bits));
+		return (scaled << shift) & mask;
+	}
+
+	bool x11_init(uint32_t canvas_width, uint32_t canvas_height, void* backend_target, uint32_t** canvases, uint32_t num_canvases)
+	{
+		assert(backend_target != nullptr); // X11 needs a display/window from the host; see [simple_tiling_utils::x11_target]
+		assert(num_canvases <= x11_max_canvases);
+		x11_dest = *static_cast<simple_tiling_utils::x11_target*>(backend_target);
+		Display* display = static_cast<Display*>(x11_dest.display);
+
+		XWindowAttributes attribs;
+		XGetWindowAttributes(display, x11_dest.window, &attribs);
+		x11_gc = XCreateGC(display, x11_dest.window, 0, nullptr);
+
+		// Anything that isn't TrueColor needs colormap management we don't do
+		if (attribs.visual->c_class != TrueColor)
+		{
+			x11_path = X11_NO_PRESENT;
+			return false;
+		}
+
+		// Our back-buffer is 0x00RRGGBB per pixel, which only matches 24/32-bit visuals with the usual channel masks; anything else
+		// (e.g. 16-bit 565) goes through a conversion on every blit instead
+		const bool native_format = (attribs.depth == 24 || attribs.depth == 32) && attribs.visual->red_mask == 0xff0000 &&
+								   attribs.visual->green_mask == 0xff00 && attribs.visual->blue_mask == 0xff;
+		if (native_format)
+		{
+			x11_path = XShmQueryExtension(display) ? X11_SHM_PRESENT : X11_PUT_PRESENT;
+			bool created = x11_create_canvases(display, attribs, canvas_width, canvas_height, num_canvases);
+			if (!created && x11_path == X11_SHM_PRESENT)
+			{
+				x11_path = X11_PUT_PRESENT;
+				created = x11_create_canvases(display, attribs, canvas_width, canvas_height, num_canvases);
+			}
+
+			if (created)
+			{
+				for (uint32_t i = 0; i < num_canvases; i++)
+				{
+					canvases[i] = reinterpret_cast<uint32_t*>(x11_canvases[i].image->data);
+				}
+				return true;
+			}
+		}
+
+		// Let SimpleTiling allocate its own canvases, and convert out of those when presenting
+		x11_path = X11_CONVERT_PRESENT;
+		x11_scratch = XCreateImage(display, attribs.visual, attribs.depth, ZPixmap, 0, nullptr, canvas_width, canvas_height, 32, 0);
+		if (x11_scratch == nullptr)
+		{
+			x11_path = X11_NO_PRESENT;
+			return false;
+		}
+		x11_scratch->data = static_cast<char*>(calloc(static_cast<size_t>(x11_scratch->bytes_per_line) * canvas_height, 1));
+		return false;
+	}
+
+	void x11_blit(void* present_target, const uint32_t* canvas, uint32_t canvas_width, uint32_t /*canvas_height*/, uint32_t x, uint32_t y, uint32_t w, uint32_t h)
+	{
+		ZoneScoped;
+		if (x11_path == X11_NO_PRESENT)
+		{
+			return;
+		}
+
+		const simple_tiling_utils::x11_target& dest = present_target != nullptr ? *static_cast<simple_tiling_utils::x11_target*>(present_target) : x11_dest;
+		Display* display = static_cast<Display*>(dest.display);
+		if (x11_path == X11_CONVERT_PRESENT)
+		{
+			// Slow path, but only for visuals nobody renders to by choice; XPutPixel copes with every pixel layout the server might use
+			for (uint32_t row = y; row < (y + h); row++)
+			{
+				const uint32_t* src = canvas + (static_cast<uint64_t>(row) * canvas_width);
+				for (uint32_t col = x; col < (x + w); col++)
+				{
+					const uint32_t px = src[col];
+					const unsigned long packed = x11_pack_channel((px >> 16) & 0xff, x11_scratch->red_mask) |
+												 x11_pack_channel((px >> 8) & 0xff, x11_scratch->green_mask) |
+												 x11_pack_channel(px & 0xff, x11_scratch->blue_mask);
+					XPutPixel(x11_scratch, col, row, packed);
+				}
+			}
+			XPutImage(display, dest.window, x11_gc, x11_scratch, x, y, x, y, w, h);
+			return;
+		}
+
+		// Map the swap-chain buffer back to the image wrapping it
+		XImage* image = nullptr;
+		for (uint32_t i = 0; i < x11_num_canvases; i++)
+		{
+			if (reinterpret_cast<const uint32_t*>(x11_canvases[i].image->data) == canvas)
+			{
+				image = x11_canvases[i].image;
+				break;
+			}
+		}
+		assert(image != nullptr);
+
+		if (x11_path == X11_SHM_PRESENT)
+		{
+			XShmPutImage(display, dest.window, x11_gc, image, x, y, x, y, w, h, False);
+		}
+		else
+		{
+			XPutImage(display, dest.window, x11_gc, image, x, y, x, y, w, h);
+		}
+	}
+
+	void x11_flush(void* present_target)
+	{
+		ZoneScoped;
+
+		// XShmPutImage only queues a request; wait for the server to consume it so (1) per-present timings are honest, and
+		// (2) the swap-chain can't hand this buffer back to tiles before the server has read it
+		const simple_tiling_utils::x11_target& dest = present_target != nullptr ? *static_cast<simple_tiling_utils::x11_target*>(present_target) : x11_dest;
+		XSync(static_cast<Display*>(dest.display), False);
+	}
+
+	void x11_shutdown()
+	{
+		Display* display = static_cast<Display*>(x11_dest.display);
+		x11_release_canvases(display);
+		XFreeGC(display, x11_gc);
+		x11_gc = nullptr;
+		x11_path = X11_NO_PRESENT;
+	}
+
+	const simple_tiling_utils::present_backend x11_shm_backend = { x11_init, x11_blit, x11_flush, x11_shutdown };
+};
+
+#endif
@@ -0,0 +1,1799 @@
+// tiling_benchmark.cpp : Headless benchmarks for SimpleTiling; no window, so this runs on render-farm machines as well as desktops
+// (apart from the x11 suite, which presents into a window; run it under xvfb-run on machines without a display)
+//
+// Usage: tiling_benchmark [suite] [num_tiles]
+//        suites: output (default), reconfigure, layout, adaptive, checkerboard, resolution, rates, accumulation,
+//                reprojection, hdr, post, fused, inlined, span, sparse, aa, x11
+//
+
+#include "../SimpleTiling/SimpleTiling.h"
+#include <algorithm>
+#include <bit>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__) && defined(SIMPLE_TILING_X11)
+#include <X11/Xlib.h>
+#endif
+
+static constexpr uint32_t bench_frames = 120;
+static constexpr uint32_t warmup_frames = 8;
+
+// Kernels are plain function pointers, so canvas dimensions live in statics
+static uint32_t bench_width = 0;
+static uint32_t bench_height = 0;
+
+// Cheap gradient kernel - cheap on purpose, so framebuffer traffic dominates frame time
+// Split out from [gradient_kernel] so [inlined_suite] can run the exact same maths through an inlined lambda
+static inline void gradient_batch(__m256 pixels, float width, simple_tiling_utils::color_batch* colors_out)
+{
+    const auto wvec = _mm256_set1_ps(width);
+    const auto yvec = _mm256_floor_ps(_mm256_div_ps(pixels, wvec));
+    const auto xvec = _mm256_sub_ps(pixels, _mm256_mul_ps(yvec, wvec));
+
+    const auto x_i = _mm256_and_si256(_mm256_cvttps_epi32(xvec), _mm256_set1_epi32(0xff));
+    const auto y_i = _mm256_and_si256(_mm256_cvttps_epi32(yvec), _mm256_set1_epi32(0xff));
+    auto rgb = _mm256_or_si256(_mm256_slli_epi32(x_i, 16), _mm256_slli_epi32(y_i, 8));
+    rgb = _mm256_or_si256(rgb, _mm256_set1_epi32(static_cast<int>(0xff000000)));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(colors_out), rgb);
+}
+
+static void gradient_kernel(__m256 pixels, uint32_t /*threadID*/, simple_tiling_utils::color_batch* colors_out)
+{
+    gradient_batch(pixels, static_cast<float>(bench_width), colors_out);
+}
+
+struct bench_result
+{
+    double ms_per_frame;
+    double shaded_mb_per_frame;
+    double copied_mb_per_frame;
+};
+
+// Render [bench_frames] frames with the given output mode and report time + traffic per frame
+static bench_result run_output_bench(uint32_t num_tiles, uint32_t width, uint32_t height, simple_tiling_utils::OUTPUT_MODES mode)
+{
+    bench_width = width;
+    bench_height = height;
+    simple_tiling::setup(num_tiles, width, height, false, simple_tiling_utils::HEADLESS_BACKEND);
+
+    // External buffers get a padded stride, like a host texture/surface would usually have
+    const uint32_t external_stride = width + 64;
+    std::vector<uint32_t> external_buffer;
+    if (mode == simple_tiling_utils::EXTERNAL_OUTPUT)
+    {
+        external_buffer.resize(static_cast<size_t>(external_stride) * height);
+    }
+    simple_tiling::set_output_mode(mode, external_buffer.data(), external_stride);
+
+    for (uint32_t i = 0; i < warmup_frames; i++)
+    {
+        simple_tiling::render_frame(gradient_kernel);
+    }
+
+    const auto stats_before = simple_tiling::GetOutputStats();
+    const auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < bench_frames; i++)
+    {
+        simple_tiling::render_frame(gradient_kernel);
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+    const auto stats_after = simple_tiling::GetOutputStats();
+    simple_tiling::shutdown();
+
+    const double frames = static_cast<double>(stats_after.frames - stats_before.frames);
+    bench_result result = {};
+    result.ms_per_frame = std::chrono::duration<double, std::milli>(t1 - t0).count() / bench_frames;
+    result.shaded_mb_per_frame = (stats_after.bytes_shaded - stats_before.bytes_shaded) / (frames * 1024.0 * 1024.0);
+    result.copied_mb_per_frame = (stats_after.bytes_copied - stats_before.bytes_copied) / (frames * 1024.0 * 1024.0);
+    return result;
+}
+
+static void output_suite(uint32_t num_tiles)
+{
+    struct resolution { const char* name; uint32_t w, h; };
+    const resolution resolutions[] = { { "1080p", 1920, 1080 }, { "4K", 3840, 2160 } };
+
+    struct mode { const char* name; simple_tiling_utils::OUTPUT_MODES mode; };
+    const mode modes[] = { { "tile-buffer", simple_tiling_utils::TILE_BUFFER_OUTPUT },
+                           { "direct", simple_tiling_utils::DIRECT_OUTPUT },
+                           { "external", simple_tiling_utils::EXTERNAL_OUTPUT } };
+
+    printf("%-8s %-12s %12s %16s %16s %16s\n", "res", "mode", "ms/frame", "shaded MB/frame", "copied MB/frame", "total MB/frame");
+    for (const resolution& res : resolutions)
+    {
+        for (const mode& m : modes)
+        {
+            const bench_result r = run_output_bench(num_tiles, res.w, res.h, m.mode);
+            printf("%-8s %-12s %12.3f %16.2f %16.2f %16.2f\n", res.name, m.name, r.ms_per_frame, r.shaded_mb_per_frame, r.copied_mb_per_frame,
+                   r.shaded_mb_per_frame + r.copied_mb_per_frame);
+        }
+    }
+}
+
+// Resize/re-tile latency; live [reconfigure] vs. a full shutdown + setup, across a handful of typical window sizes
+static void reconfigure_suite(uint32_t num_tiles)
+{
+    struct step { uint32_t w, h, tiles; };
+    const step steps[] = { { 1920, 1080, num_tiles }, { 1280, 720, num_tiles }, { 2560, 1440, num_tiles * 2 },
+                           { 3840, 2160, num_tiles }, { 1600, 900, num_tiles / 2 }, { 1920, 1080, num_tiles } };
+    const uint32_t num_steps = sizeof(steps) / sizeof(step);
+
+    printf("%-12s %8s %18s %20s\n", "canvas", "tiles", "reconfigure (us)", "shutdown+setup (us)");
+    bench_width = 1920;
+    bench_height = 1080;
+    simple_tiling::setup(num_tiles, bench_width, bench_height, false, simple_tiling_utils::HEADLESS_BACKEND);
+    for (uint32_t i = 0; i < num_steps; i++)
+    {
+        const step& s = steps[i];
+        simple_tiling::render_frame(gradient_kernel);
+
+        // Live path
+        const uint64_t live_us = simple_tiling::reconfigure(s.w, s.h, std::max(s.tiles, 1u));
+        bench_width = s.w;
+        bench_height = s.h;
+        simple_tiling::render_frame(gradient_kernel);
+
+        // Restart path, for comparison (back to the same configuration, so the next step starts from an identical state)
+        const auto t0 = std::chrono::steady_clock::now();
+        simple_tiling::shutdown();
+        simple_tiling::setup(std::max(s.tiles, 1u), s.w, s.h, false, simple_tiling_utils::HEADLESS_BACKEND);
+        const auto t1 = std::chrono::steady_clock::now();
+        const double restart_us = std::chrono::duration<double, std::micro>(t1 - t0).count();
+
+        char canvas[32];
+        snprintf(canvas, sizeof(canvas), "%ux%u", s.w, s.h);
+        printf("%-12s %8u %18llu %20.0f\n", canvas, simple_tiling::GetNumTilesTotal(), static_cast<unsigned long long>(live_us), restart_us);
+    }
+    simple_tiling::shutdown();
+}
+
+// Layout comparisons need kernels with real (and uneven) per-pixel cost; these are SVML-free versions of the two demo kernels
+static float bench_time = 0.0f;
+static float bench_pan = 0.0f; // Horizontal camera offset in pixels, for [reprojection_suite]
+
+// Range-reduced Taylor cosine; plenty for a benchmark, and portable to compilers without _mm256_cos_ps
+static __m256 bench_cos(__m256 x)
+{
+    const auto inv_two_pi = _mm256_set1_ps(0.15915494f);
+    const auto two_pi = _mm256_set1_ps(6.28318531f);
+    x = _mm256_sub_ps(x, _mm256_mul_ps(two_pi, _mm256_round_ps(_mm256_mul_ps(x, inv_two_pi), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)));
+    const auto x2 = _mm256_mul_ps(x, x);
+    auto r = _mm256_set1_ps(1.0f / 40320.0f);
+    r = _mm256_fmadd_ps(r, x2, _mm256_set1_ps(-1.0f / 720.0f));
+    r = _mm256_fmadd_ps(r, x2, _mm256_set1_ps(1.0f / 24.0f));
+    r = _mm256_fmadd_ps(r, x2, _mm256_set1_ps(-0.5f));
+    return _mm256_fmadd_ps(r, x2, _mm256_set1_ps(1.0f));
+}
+
+// Animated colour gradient, same maths as tiling_demo_colours; even cost across the canvas
+static inline void colours_batch(__m256 pixels, float time, float width, float height, simple_tiling_utils::color_batch* colors_out)
+{
+    const auto tvec = _mm256_set1_ps(time);
+    const auto wvec = _mm256_set1_ps(width);
+    const auto yvec = _mm256_floor_ps(_mm256_div_ps(pixels, wvec));
+    const auto xvec = _mm256_sub_ps(pixels, _mm256_mul_ps(yvec, wvec));
+    const auto u_vec = _mm256_div_ps(xvec, wvec);
+    const auto v_vec = _mm256_div_ps(yvec, _mm256_set1_ps(height));
+
+    const auto half = _mm256_set1_ps(0.5f);
+    const auto scale = _mm256_set1_ps(255.0f);
+    const auto red = _mm256_mul_ps(_mm256_fmadd_ps(half, bench_cos(_mm256_add_ps(tvec, u_vec)), half), scale);
+    const auto blue = _mm256_mul_ps(_mm256_fmadd_ps(half, bench_cos(_mm256_add_ps(tvec, v_vec)), half), scale);
+    const auto rgb = _mm256_or_si256(_mm256_slli_epi32(_mm256_cvttps_epi32(red), 16), _mm256_cvttps_epi32(blue));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(colors_out), rgb);
+}
+
+static void colours_kernel(__m256 pixels, uint32_t /*threadID*/, simple_tiling_utils::color_batch* colors_out)
+{
+    colours_batch(pixels, bench_time, static_cast<float>(bench_width), static_cast<float>(bench_height), colors_out);
+}
+
+// Sphere-traced cluster of spheres in the lower-left of the screen, like tiling_demo_raymarching; rays that miss leave after a few steps,
+// rays that graze the cluster take up to [raymarch_steps], so cost is heavily skewed across the canvas
+static constexpr uint32_t raymarch_steps = 96;
+
+// March each lane for up to [max_steps]; returns the steps each lane took, and leaves [active] set on lanes that were still marching
+static __m256 march_spheres(__m256 pixels, uint32_t threadID, uint32_t max_steps, __m256& active)
+{
+    const simple_tiling_utils::sample_jitter jitter = simple_tiling::GetSampleJitter(threadID); // Zero unless accumulating/anti-aliasing
+    const auto wvec = _mm256_set1_ps(static_cast<float>(bench_width));
+    const auto pixel_y = _mm256_floor_ps(_mm256_div_ps(pixels, wvec));
+    const auto xvec = _mm256_add_ps(_mm256_sub_ps(pixels, _mm256_mul_ps(pixel_y, wvec)), _mm256_set1_ps(jitter.x + bench_pan));
+    const auto yvec = _mm256_add_ps(pixel_y, _mm256_set1_ps(jitter.y));
+    const auto inv_h = _mm256_set1_ps(2.0f / static_cast<float>(bench_height));
+    const auto aspect = _mm256_set1_ps(static_cast<float>(bench_width) / static_cast<float>(bench_height));
+
+    // Pinhole camera at the origin, looking down +z
+    const auto dx = _mm256_sub_ps(_mm256_mul_ps(xvec, inv_h), aspect);
+    const auto dy = _mm256_sub_ps(_mm256_mul_ps(yvec, inv_h), _mm256_set1_ps(1.0f));
+    const auto inv_len = _mm256_rsqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_set1_ps(1.0f)));
+    const auto rdx = _mm256_mul_ps(dx, inv_len);
+    const auto rdy = _mm256_mul_ps(dy, inv_len);
+    const auto rdz = inv_len;
+
+    struct sphere { float x, y, z, r; };
+    const sphere spheres[] = { { -1.2f, -0.6f, 4.0f, 0.5f }, { -0.6f, -0.9f, 3.5f, 0.3f }, { -1.6f, -0.2f, 5.0f, 0.6f }, { -0.9f, -0.3f, 4.5f, 0.25f } };
+
+    auto dist = _mm256_setzero_ps();
+    auto steps = _mm256_setzero_ps();
+    active = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+    const auto far_plane = _mm256_set1_ps(12.0f);
+    const auto epsilon = _mm256_set1_ps(0.001f);
+    for (uint32_t i = 0; i < max_steps && _mm256_movemask_ps(active) != 0; i++)
+    {
+        const auto px = _mm256_mul_ps(rdx, dist);
+        const auto py = _mm256_mul_ps(rdy, dist);
+        const auto pz = _mm256_mul_ps(rdz, dist);
+        auto d = far_plane;
+        for (const sphere& s : spheres)
+        {
+            const auto ox = _mm256_sub_ps(px, _mm256_set1_ps(s.x));
+            const auto oy = _mm256_sub_ps(py, _mm256_set1_ps(s.y));
+            const auto oz = _mm256_sub_ps(pz, _mm256_set1_ps(s.z));
+            const auto len = _mm256_sqrt_ps(_mm256_fmadd_ps(ox, ox, _mm256_fmadd_ps(oy, oy, _mm256_mul_ps(oz, oz))));
+            d = _mm256_min_ps(d, _mm256_sub_ps(len, _mm256_set1_ps(s.r)));
+        }
+
+        // Lanes stop once they hit something or leave the scene; everyone else keeps marching
+        dist = _mm256_add_ps(dist, _mm256_and_ps(d, active));
+        steps = _mm256_add_ps(steps, _mm256_and_ps(_mm256_set1_ps(1.0f), active));
+        active = _mm256_and_ps(active, _mm256_and_ps(_mm256_cmp_ps(d, epsilon, _CMP_GT_OQ), _mm256_cmp_ps(dist, far_plane, _CMP_LT_OQ)));
+    }
+    return steps;
+}
+
+// Shade by step count; cheap, and shows exactly where the work went
+static void shade_steps(__m256 steps, simple_tiling_utils::color_batch* colors_out)
+{
+    const auto shade = _mm256_cvttps_epi32(_mm256_mul_ps(steps, _mm256_set1_ps(255.0f / raymarch_steps)));
+    const auto rgb = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(shade, 16), _mm256_slli_epi32(shade, 8)), shade);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(colors_out), rgb);
+}
+
+static void raymarch_kernel(__m256 pixels, uint32_t threadID, simple_tiling_utils::color_batch* colors_out)
+{
+    __m256 active;
+    shade_steps(march_spheres(pixels, threadID, raymarch_steps, active), colors_out);
+}
+
+// Last-level cache misses over this process + every thread it spawns afterwards; tiles are launched in [setup], so open the counter first
+// Only available on Linux (and only where perf events are permitted); everywhere else, [read] reports failure and we print "n/a"
+struct llc_counter
+{
+#ifdef __linux__
+    int fd = -1;
+
+    void open()
+    {
+        perf_event_attr attr = {};
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.inherit = 1; // Count tile threads as well; their totals fold into ours when they exit
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    bool read(uint64_t& count)
+    {
+        const bool valid = fd >= 0 && ::read(fd, &count, sizeof(count)) == sizeof(count);
+        if (fd >= 0)
+        {
+            close(fd);
+            fd = -1;
+        }
+        return valid;
+    }
+#else
+    void open() {}
+    bool read(uint64_t& count) { return false; }
+#endif
+};
+
+struct layout_result
+{
+    double ms_per_frame;
+    uint64_t llc_misses; // Setup + warmup + [num_frames] frames + shutdown; see [layout_suite]
+    bool have_llc;
+};
+
+static layout_result run_layout_bench(uint32_t num_tiles, uint32_t width, uint32_t height, simple_tiling_utils::TILE_LAYOUTS layout,
+                                      simple_tiling_utils::draw_job kernel, uint32_t num_frames)
+{
+    bench_width = width;
+    bench_height = height;
+    bench_time = 0.0f;
+
+    llc_counter counter;
+    counter.open();
+    simple_tiling::setup(num_tiles, width, height, false, simple_tiling_utils::HEADLESS_BACKEND, nullptr, layout);
+    for (uint32_t i = 0; i < warmup_frames; i++)
+    {
+        simple_tiling::render_frame(kernel);
+    }
+
+    const auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < num_frames; i++)
+    {
+        bench_time += 1.0f / 60.0f;
+        simple_tiling::render_frame(kernel);
+        simple_tiling::present(nullptr, 1000);
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+    simple_tiling::shutdown();
+
+    layout_result result = {};
+    result.ms_per_frame = num_frames > 0 ? std::chrono::duration<double, std::milli>(t1 - t0).count() / num_frames : 0.0;
+    result.have_llc = counter.read(result.llc_misses);
+    return result;
+}
+
+// Frame time + LLC misses per frame for every tile layout, with an even-cost kernel and a skewed one
+// Misses are counted around whole runs (thread start-up and teardown included), so we subtract a zero-frame run to isolate per-frame traffic
+static void layout_suite(uint32_t num_tiles)
+{
+    struct layout { const char* name; simple_tiling_utils::TILE_LAYOUTS layout; };
+    const layout layouts[] = { { "square", simple_tiling_utils::SQUARE_TILES },
+                               { "strip", simple_tiling_utils::STRIP_TILES },
+                               { "morton", simple_tiling_utils::MORTON_TILES } };
+
+    struct kernel { const char* name; simple_tiling_utils::draw_job job; };
+    const kernel kernels[] = { { "colours", colours_kernel }, { "raymarch", raymarch_kernel } };
+
+    printf("%-10s %-8s %12s %18s\n", "kernel", "layout", "ms/frame", "LLC misses/frame");
+    for (const kernel& k : kernels)
+    {
+        for (const layout& l : layouts)
+        {
+            const layout_result baseline = run_layout_bench(num_tiles, 1920, 1080, l.layout, k.job, 0);
+            const layout_result r = run_layout_bench(num_tiles, 1920, 1080, l.layout, k.job, bench_frames);
+            if (r.have_llc && baseline.have_llc)
+            {
+                const double misses = (static_cast<double>(r.llc_misses) - static_cast<double>(baseline.llc_misses)) / bench_frames;
+                printf("%-10s %-8s %12.3f %18.0f\n", k.name, l.name, r.ms_per_frame, std::max(misses, 0.0));
+            }
+            else
+            {
+                printf("%-10s %-8s %12.3f %18s\n", k.name, l.name, r.ms_per_frame, "n/a");
+            }
+        }
+    }
+}
+
+// Static vs. adaptive tiling on the skewed raymarch kernel; per-tile balance before/after re-partitioning, and the frame time that buys
+static void adaptive_suite(uint32_t num_tiles)
+{
+    printf("%-10s %12s %14s %14s %12s\n", "tiling", "ms/frame", "max tile (us)", "mean tile (us)", "rebalances");
+    for (uint32_t adaptive = 0; adaptive < 2; adaptive++)
+    {
+        bench_width = 1920;
+        bench_height = 1080;
+        simple_tiling::setup(num_tiles, bench_width, bench_height, false, simple_tiling_utils::HEADLESS_BACKEND);
+
+        // Static tiling still measures itself (it just never acts on it), which gives us the "before" figures
+        simple_tiling::set_adaptive_tiling(true, 10, adaptive ? 1.2f : FLT_MAX);
+        for (uint32_t i = 0; i < warmup_frames * 4; i++)
+        {
+            simple_tiling::render_frame(raymarch_kernel);
+        }
+
+        const auto t0 = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < bench_frames; i++)
+        {
+            simple_tiling::render_frame(raymarch_kernel);
+        }
+        const auto t1 = std::chrono::steady_clock::now();
+        const simple_tiling_utils::balance_stats stats = simple_tiling::GetBalanceStats();
+        simple_tiling::shutdown();
+
+        printf("%-10s %12.3f %14.0f %14.0f %12llu\n", adaptive ? "adaptive" : "static", std::chrono::duration<double, std::milli>(t1 - t0).count() / bench_frames,
+               stats.max_tile_us, stats.mean_tile_us, static_cast<unsigned long long>(stats.num_rebalances));
+    }
+}
+
+// Full-rate vs. checkerboard rendering (see [simple_tiling::setup]); frame time, and PSNR of the final checkerboarded frame against a full-rate
+// render of the same frame (so this measures reconstruction error under motion, not just static quality)
+static void checkerboard_suite(uint32_t num_tiles)
+{
+    struct kernel_entry
+    {
+        const char* name;
+        simple_tiling_utils::draw_job job;
+    };
+    const kernel_entry kernels[] = { { "colours", colours_kernel }, { "raymarch", raymarch_kernel } };
+
+    printf("%-10s %-12s %12s %10s\n", "kernel", "rendering", "ms/frame", "PSNR (dB)");
+    for (const kernel_entry& k : kernels)
+    {
+        std::vector<uint32_t> reference;
+        for (uint32_t interlaced = 0; interlaced < 2; interlaced++)
+        {
+            bench_width = 1920;
+            bench_height = 1080;
+            bench_time = 0.0f;
+            simple_tiling::setup(num_tiles, bench_width, bench_height, interlaced != 0, simple_tiling_utils::HEADLESS_BACKEND);
+            for (uint32_t i = 0; i < warmup_frames; i++)
+            {
+                simple_tiling::render_frame(k.job);
+                bench_time += 1.0f / 60.0f;
+            }
+
+            const auto t0 = std::chrono::steady_clock::now();
+            for (uint32_t i = 0; i < bench_frames; i++)
+            {
+                simple_tiling::render_frame(k.job);
+                bench_time += 1.0f / 60.0f;
+            }
+            const auto t1 = std::chrono::steady_clock::now();
+
+            const uint32_t* frame = simple_tiling::GetBackBuffer();
+            const uint64_t num_px = static_cast<uint64_t>(bench_width) * bench_height;
+            double psnr = 0.0;
+            if (!interlaced)
+            {
+                reference.assign(frame, frame + num_px);
+            }
+            else
+            {
+                double sq_err = 0.0;
+                for (uint64_t p = 0; p < num_px; p++)
+                {
+                    for (uint32_t c = 0; c < 24; c += 8)
+                    {
+                        const double d = static_cast<double>((frame[p] >> c) & 0xff) - static_cast<double>((reference[p] >> c) & 0xff);
+                        sq_err += d * d;
+                    }
+                }
+                const double mse = sq_err / (3.0 * num_px);
+                psnr = mse > 0.0 ? 10.0 * log10((255.0 * 255.0) / mse) : INFINITY;
+            }
+            simple_tiling::shutdown();
+
+            if (interlaced)
+            {
+                printf("%-10s %-12s %12.3f %10.1f\n", k.name, "checkerboard", std::chrono::duration<double, std::milli>(t1 - t0).count() / bench_frames, psnr);
+            }
+            else
+            {
+                printf("%-10s %-12s %12.3f %10s\n", k.name, "full", std::chrono::duration<double, std::milli>(t1 - t0).count() / bench_frames, "-");
+            }
+        }
+    }
+}
+
+// Native vs. dynamic resolution on the raymarch kernel; the controller gets 60% of the native frame's slowest tile pass as its budget, and we
+// report where it settled + the PSNR that cost against the native frame (the scene is static, so every native frame is the same)
+static void resolution_suite(uint32_t num_tiles)
+{
+    bench_width = 1920;
+    bench_height = 1080;
+    const uint64_t num_px = static_cast<uint64_t>(bench_width) * bench_height;
+
+    struct config
+    {
+        const char* name;
+        bool dynamic;
+        float sharpening;
+    };
+    const config configs[] = { { "native", false, 0.0f }, { "bilinear", true, 0.0f }, { "sharpened", true, 0.25f } };
+
+    std::vector<uint32_t> reference;
+    float budget_ms = 0.0f;
+    printf("%-10s %12s %10s %10s %10s %10s\n", "upscale", "ms/frame", "scale", "avg scale", "over", "PSNR (dB)");
+    for (const config& c : configs)
+    {
+        simple_tiling::setup(num_tiles, bench_width, bench_height, false, simple_tiling_utils::HEADLESS_BACKEND);
+        if (!c.dynamic)
+        {
+            // Measure the budget with an unreachable one, so the controller never leaves native resolution
+            simple_tiling::set_dynamic_resolution(true, FLT_MAX);
+        }
+        else
+        {
+            simple_tiling::set_dynamic_resolution(true, budget_ms, 0.5f, c.sharpening);
+        }
+
+        for (uint32_t i = 0; i < warmup_frames * 4; i++)
+        {
+            simple_tiling::render_frame(raymarch_kernel);
+        }
+
+        const auto t0 = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < bench_frames; i++)
+        {
+            simple_tiling::render_frame(raymarch_kernel);
+        }
+        const auto t1 = std::chrono::steady_clock::now();
+        const simple_tiling_utils::resolution_stats stats = simple_tiling::GetResolutionStats();
+
+        const uint32_t* frame = simple_tiling::GetBackBuffer();
+        double psnr = INFINITY;
+        if (!c.dynamic)
+        {
+            reference.assign(frame, frame + num_px);
+            budget_ms = static_cast<float>(stats.last_frame_ms * 0.6);
+        }
+        else
+        {
+            double sq_err = 0.0;
+            for (uint64_t p = 0; p < num_px; p++)
+            {
+                for (uint32_t ch = 0; ch < 24; ch += 8)
+                {
+                    const double d = static_cast<double>((frame[p] >> ch) & 0xff) - static_cast<double>((reference[p] >> ch) & 0xff);
+                    sq_err += d * d;
+                }
+            }
+            const double mse = sq_err / (3.0 * num_px);
+            psnr = mse > 0.0 ? 10.0 * log10((255.0 * 255.0) / mse) : INFINITY;
+        }
+        simple_tiling::shutdown();
+
+        printf("%-10s %12.3f %10.3f %10.3f %10llu %10.1f\n", c.name, std::chrono::duration<double, std::milli>(t1 - t0).count() / bench_frames,
+               stats.render_scale, stats.avg_render_scale, static_cast<unsigned long long>(stats.frames_over_budget), psnr);
+    }
+}
+
+// Full-rate vs. adaptive variable-rate shading (see [simple_tiling::set_shading_rates]) at a couple of contrast thresholds; frame time, the share
+// of blocks shaded at each rate, and PSNR of the final frame against a full-rate render of the same (animated) frame
+static void rates_suite(uint32_t num_tiles)
+{
+    struct kernel_entry
+    {
+        const char* name;
+        simple_tiling_utils::draw_job job;
+    };
+    const kernel_entry kernels[] = { { "colours", colours_kernel }, { "raymarch", raymarch_kernel } };
+    const uint8_t thresholds[] = { 0, 12, 24 }; // 0 = full rate
+
+    printf("%-10s %-10s %12s %8s %8s %8s %10s\n", "kernel", "rates", "ms/frame", "1x1 %", "2x2 %", "4x4 %", "PSNR (dB)");
+    for (const kernel_entry& k : kernels)
+    {
+        std::vector<uint32_t> reference;
+        for (const uint8_t threshold : thresholds)
+        {
+            bench_width = 1920;
+            bench_height = 1080;
+            bench_time = 0.0f;
+            simple_tiling::setup(num_tiles, bench_width, bench_height, false, simple_tiling_utils::HEADLESS_BACKEND);
+            if (threshold > 0)
+            {
+                simple_tiling::set_shading_rates(simple_tiling_utils::ADAPTIVE_RATE_SHADING, nullptr, threshold);
+            }
+            for (uint32_t i = 0; i < warmup_frames; i++)
+            {
+                simple_tiling::render_frame(k.job);
+                bench_time += 1.0f / 60.0f;
+            }
+
+            const simple_tiling_utils::output_stats stats_t0 = simple_tiling::GetOutputStats();
+            const auto t0 = std::chrono::steady_clock::now();
+            for (uint32_t i = 0; i < bench_frames; i++)
+            {
+                simple_tiling::render_frame(k.job);
+                bench_time += 1.0f / 60.0f;
+            }
+            const auto t1 = std::chrono::steady_clock::now();
+            const simple_tiling_utils::output_stats stats_t1 = simple_tiling::GetOutputStats();
+
+            const uint32_t* frame = simple_tiling::GetBackBuffer();
+            const uint64_t num_px = static_cast<uint64_t>(bench_width) * bench_height;
+            double psnr = INFINITY;
+            if (threshold == 0)
+            {
+                reference.assign(frame, frame + num_px);
+            }
+            else
+            {
+                double sq_err = 0.0;
+                for (uint64_t p = 0; p < num_px; p++)
+                {
+                    for (uint32_t c = 0; c < 24; c += 8)
+                    {
+                        const double d = static_cast<double>((frame[p] >> c) & 0xff) - static_cast<double>((reference[p] >> c) & 0xff);
+                        sq_err += d * d;
+                    }
+                }
+                const double mse = sq_err / (3.0 * num_px);
+                psnr = mse > 0.0 ? 10.0 * log10((255.0 * 255.0) / mse) : INFINITY;
+            }
+            simple_tiling::shutdown();
+
+            // Full-rate passes don't count blocks at all
+            double block_shares[3] = { 100.0, 0.0, 0.0 };
+            const double num_blocks = static_cast<double>((stats_t1.rate_blocks[0] - stats_t0.rate_blocks[0]) + (stats_t1.rate_blocks[1] - stats_t0.rate_blocks[1]) +
+                                                          (stats_t1.rate_blocks[2] - stats_t0.rate_blocks[2]));
+            if (num_blocks > 0.0)
+            {
+                for (uint32_t r = 0; r < 3; r++)
+                {
+                    block_shares[r] = 100.0 * static_cast<double>(stats_t1.rate_blocks[r] - stats_t0.rate_blocks[r]) / num_blocks;
+                }
+            }
+
+            char rates_name[16];
+            snprintf(rates_name, sizeof(rates_name), threshold > 0 ? "adapt-%u" : "full", threshold);
+            printf("%-10s %-10s %12.3f %8.1f %8.1f %8.1f %10.1f\n", k.name, rates_name, std::chrono::duration<double, std::milli>(t1 - t0).count() / bench_frames,
+                   block_shares[0], block_shares[1], block_shares[2], psnr);
+        }
+    }
+}
+
+// Static raymarch scene with and without accumulation (see [simple_tiling::set_accumulation]); frame time while samples accumulate + once
+// tiles have converged, then PSNR of a few sample counts against the converged (64 samples per pixel) frame
+static void accumulation_suite(uint32_t num_tiles)
+{
+    constexpr uint32_t max_samples = 64;
+    constexpr uint32_t snapshot_samples[] = { 1, 4, 16 };
+    bench_width = 1920;
+    bench_height = 1080;
+    const uint64_t num_px = static_cast<uint64_t>(bench_width) * bench_height;
+
+    auto time_frames = [](uint32_t num_frames)
+    {
+        const auto t0 = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < num_frames; i++)
+        {
+            simple_tiling::render_frame(raymarch_kernel);
+        }
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() / num_frames;
+    };
+
+    simple_tiling::setup(num_tiles, bench_width, bench_height, false, simple_tiling_utils::HEADLESS_BACKEND);
+    time_frames(warmup_frames);
+    const double native_ms = time_frames(bench_frames);
+    simple_tiling::shutdown();
+
+    // Accumulation restarts on setup, so every frame from here adds one sample; snapshot a few along the way
+    simple_tiling::setup(num_tiles, bench_width, bench_height, false, simple_tiling_utils::HEADLESS_BACKEND);
+    simple_tiling::set_accumulation(true, max_samples);
+    std::vector<uint32_t> snapshots[std::size(snapshot_samples)];
+    double accumulating_ms = 0.0;
+    for (uint32_t s = 1; s <= max_samples; s++)
+    {
+        accumulating_ms += time_frames(1);
+        for (uint32_t i = 0; i < std::size(snapshot_samples); i++)
+        {
+            if (snapshot_samples[i] == s)
+            {
+                snapshots[i].assign(simple_tiling::GetBackBuffer(), simple_tiling::GetBackBuffer() + num_px);
+            }
+        }
+    }
+    accumulating_ms /= max_samples;
+    const double converged_ms = time_frames(bench_frames);
+    const uint32_t* converged = simple_tiling::GetBackBuffer();
+
+    printf("%-14s %12s\n", "rendering", "ms/frame");
+    printf("%-14s %12.3f\n", "native", native_ms);
+    printf("%-14s %12.3f\n", "accumulating", accumulating_ms);
+    printf("%-14s %12.3f\n", "converged", converged_ms);
+    printf("\n%-14s %12s\n", "samples", "PSNR (dB)");
+    for (uint32_t i = 0; i < std::size(snapshot_samples); i++)
+    {
+        double sq_err = 0.0;
+        for (uint64_t p = 0; p < num_px; p++)
+        {
+            for (uint32_t c = 0; c < 24; c += 8)
+            {
+                const double d = static_cast<double>((snapshots[i][p] >> c) & 0xff) - static_cast<double>((converged[p] >> c) & 0xff);
+                sq_err += d * d;
+            }
+        }
+        const double mse = sq_err / (3.0 * num_px);
+        printf("%-14u %12.1f\n", snapshot_samples[i], mse > 0.0 ? 10.0 * log10((255.0 * 255.0) / mse) : INFINITY);
+    }
+    simple_tiling::shutdown();
+}
+
+// Raymarch scene panning sideways by [pan_speed] pixels per frame; fractional, so nearest-pixel reprojection drifts from the true image and
+// the PSNR column shows what reuse costs. Pixels panned in from the right edge have no history, and are always shaded
+static constexpr float pan_speed = 2.5f;
+static void pan_reprojection(__m256 pixels, uint32_t /*threadID*/, simple_tiling_utils::reprojection_batch* reprojection_out)
+{
+    const auto wvec = _mm256_set1_ps(static_cast<float>(bench_width));
+    const auto yvec = _mm256_floor_ps(_mm256_div_ps(pixels, wvec));
+    const auto xvec = _mm256_sub_ps(pixels, _mm256_mul_ps(yvec, wvec));
+
+    // The scene moved left, so what's at [x] now was at [x + pan_speed] last frame
+    const auto prev_x = _mm256_round_ps(_mm256_add_ps(xvec, _mm256_set1_ps(pan_speed)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    const auto valid = _mm256_castps_si256(_mm256_cmp_ps(prev_x, wvec, _CMP_LT_OQ));
+    const auto prev_pixels = _mm256_cvttps_epi32(_mm256_fmadd_ps(yvec, wvec, prev_x));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(reprojection_out->prev_pixels), _mm256_blendv_epi8(_mm256_set1_epi32(-1), prev_pixels, valid));
+}
+
+// Panning raymarch scene with and without reprojection (see [simple_tiling::set_reprojection]); frame time, share of pixels reused, and
+// PSNR of the last reprojected frame against a natively shaded one at the same pan
+static void reprojection_suite(uint32_t num_tiles)
+{
+    bench_width = 1920;
+    bench_height = 1080;
+    const uint64_t num_px = static_cast<uint64_t>(bench_width) * bench_height;
+
+    auto time_frames = [](uint32_t num_frames)
+    {
+        const auto t0 = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < num_frames; i++)
+        {
+            bench_pan += pan_speed;
+            simple_tiling::render_frame(raymarch_kernel);
+        }
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() / num_frames;
+    };
+
+    bench_pan = 0.0f;
+    simple_tiling::setup(num_tiles, bench_width, bench_height, false, simple_tiling_utils::HEADLESS_BACKEND);
+    time_frames(warmup_frames);
+    const double native_ms = time_frames(bench_frames);
+    simple_tiling::shutdown();
+
+    bench_pan = 0.0f;
+    simple_tiling::setup(num_tiles, bench_width, bench_height, false, simple_tiling_utils::HEADLESS_BACKEND);
+    simple_tiling::set_reprojection(pan_reprojection);
+    time_frames(warmup_frames);
+    const double reprojected_ms = time_frames(bench_frames);
+    const simple_tiling_utils::output_stats stats = simple_tiling::GetOutputStats();
+    const std::vector<uint32_t> reprojected(simple_tiling::GetBackBuffer(), simple_tiling::GetBackBuffer() + num_px);
+
+    // Same pan, shaded from scratch
+    simple_tiling::set_reprojection(nullptr);
+    bench_pan -= pan_speed;
+    time_frames(1);
+    const uint32_t* native = simple_tiling::GetBackBuffer();
+    double sq_err = 0.0;
+    for (uint64_t p = 0; p < num_px; p++)
+    {
+        for (uint32_t c = 0; c < 24; c += 8)
+        {
+            const double d = static_cast<double>((reprojected[p] >> c) & 0xff) - static_cast<double>((native[p] >> c) & 0xff);
+            sq_err += d * d;
+        }
+    }
+    const double mse = sq_err / (3.0 * num_px);
+    simple_tiling::shutdown();
+    bench_pan = 0.0f;
+
+    printf("%-14s %12s %10s %10s\n", "rendering", "ms/frame", "reused", "PSNR (dB)");
+    printf("%-14s %12.3f %9.1f%% %10s\n", "native", native_ms, 0.0, "-");
+    printf("%-14s %12.3f %9.1f%% %10.1f\n", "reprojected", reprojected_ms, stats.reuse_ratio * 100.0f,
+           mse > 0.0 ? 10.0 * log10((255.0 * 255.0) / mse) : INFINITY);
+}
+
+// HDR version of [colours_kernel]; channels run from 0 to 4, so tonemapping has some highlights to compress
+static void hdr_colours(__m256 pixels, __m256& red, __m256& blue)
+{
+    const auto tvec = _mm256_set1_ps(bench_time);
+    const auto wvec = _mm256_set1_ps(static_cast<float>(bench_width));
+    const auto yvec = _mm256_floor_ps(_mm256_div_ps(pixels, wvec));
+    const auto xvec = _mm256_sub_ps(pixels, _mm256_mul_ps(yvec, wvec));
+    const auto u_vec = _mm256_div_ps(xvec, wvec);
+    const auto v_vec = _mm256_div_ps(yvec, _mm256_set1_ps(static_cast<float>(bench_height)));
+    const auto two = _mm256_set1_ps(2.0f);
+    red = _mm256_fmadd_ps(two, bench_cos(_mm256_add_ps(tvec, u_vec)), two);
+    blue = _mm256_fmadd_ps(two, bench_cos(_mm256_add_ps(tvec, v_vec)), two);
+}
+
+static void hdr_colours_kernel(__m256 pixels, uint32_t /*threadID*/, simple_tiling_utils::hdr_color_batch* colors_out)
+{
+    __m256 red;
+    __m256 blue;
+    hdr_colours(pixels, red, blue);
+    _mm256_storeu_ps(colors_out->red, red);
+    _mm256_storeu_ps(colors_out->green, _mm256_setzero_ps());
+    _mm256_storeu_ps(colors_out->blue, blue);
+}
+
+// The same thing, tonemapped (ACES fit + sRGB) and quantized inside the kernel, one lane at a time; what kernels have to do without HDR jobs
+static void tonemapped_colours_kernel(__m256 pixels, uint32_t /*threadID*/, simple_tiling_utils::color_batch* colors_out)
+{
+    __m256 red;
+    __m256 blue;
+    hdr_colours(pixels, red, blue);
+    auto encode = [](float c)
+    {
+        c = std::min((c * ((2.51f * c) + 0.03f)) / ((c * ((2.43f * c) + 0.59f)) + 0.14f), 1.0f);
+        c = (c < 0.0031308f) ? (c * 12.92f) : ((1.055f * powf(c, 1.0f / 2.4f)) - 0.055f);
+        return static_cast<uint32_t>((c * 255.0f) + 0.5f);
+    };
+    for (uint32_t i = 0; i < NUM_VECTOR_LANES; i++)
+    {
+        colors_out->colors8bpc[i] = (encode(v_access(red)[i]) << 16) | encode(v_access(blue)[i]);
+    }
+}
+
+// Colour gradient with exposure/tonemapping/sRGB done inside the kernel vs. by HDR jobs (see [simple_tiling::submit_hdr_draw_work]),
+// unbuffered + with each tile buffer format (see [simple_tiling::set_hdr_buffering]); [colours_kernel] (no tonemapping at all) is the floor
+// Dithering is off, so every row should land within an 8-bit step of the in-kernel one (the library's sRGB curve is approximate)
+static void hdr_suite(uint32_t num_tiles)
+{
+    bench_width = 1920;
+    bench_height = 1080;
+    const uint64_t num_px = static_cast<uint64_t>(bench_width) * bench_height;
+
+    struct config
+    {
+        const char* name;
+        simple_tiling_utils::draw_job kernel;
+        simple_tiling_utils::HDR_FORMATS format;
+    };
+    const config configs[] = { { "8bpc", colours_kernel, simple_tiling_utils::HDR_UNBUFFERED },
+                               { "in-kernel", tonemapped_colours_kernel, simple_tiling_utils::HDR_UNBUFFERED },
+                               { "hdr", nullptr, simple_tiling_utils::HDR_UNBUFFERED },
+                               { "hdr-float16", nullptr, simple_tiling_utils::HDR_FLOAT16 },
+                               { "hdr-float32", nullptr, simple_tiling_utils::HDR_FLOAT32 } };
+
+    std::vector<uint32_t> reference;
+    printf("%-14s %12s %10s\n", "kernel", "ms/frame", "max diff");
+    for (const config& c : configs)
+    {
+        simple_tiling::setup(num_tiles, bench_width, bench_height, false, simple_tiling_utils::HEADLESS_BACKEND);
+        simple_tiling::set_tonemapping(simple_tiling_utils::TONEMAP_ACES, 1.0f, true, false);
+        simple_tiling::set_hdr_buffering(c.format);
+        auto draw = [&]()
+        {
+            if (c.kernel != nullptr)
+            {
+                simple_tiling::render_frame(c.kernel);
+            }
+            else
+            {
+                simple_tiling::render_frame(hdr_colours_kernel);
+            }
+        };
+
+        bench_time = 0.0f;
+        for (uint32_t i = 0; i < warmup_frames; i++)
+        {
+            draw();
+        }
+        const auto t0 = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < bench_frames; i++)
+        {
+            draw();
+        }
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() / bench_frames;
+
+        // Compare one fixed frame against the in-kernel version
+        bench_time = 1.0f;
+        draw();
+        const uint32_t* frame = simple_tiling::GetBackBuffer();
+        int32_t max_diff = 0;
+        if (c.kernel == tonemapped_colours_kernel)
+        {
+            reference.assign(frame, frame + num_px);
+        }
+        else if (!reference.empty() && c.kernel == nullptr)
+        {
+            for (uint64_t p = 0; p < num_px; p++)
+            {
+                for (uint32_t s = 0; s < 24; s += 8)
+                {
+                    max_diff = std::max(max_diff, abs(static_cast<int32_t>((frame[p] >> s) & 0xff) - static_cast<int32_t>((reference[p] >> s) & 0xff)));
+                }
+            }
+        }
+        simple_tiling::shutdown();
+
+        if (c.kernel == nullptr)
+        {
+            printf("%-14s %12.3f %10d\n", c.name, ms, max_diff);
+        }
+        else
+        {
+            printf("%-14s %12.3f %10s\n", c.name, ms, "-");
+        }
+    }
+    bench_time = 0.0f;
+}
+
+// Gaussian weights for the post-processing suite; radius 4, sigma 2
+static constexpr uint32_t blur_halo = 4;
+static float blur_weights[(blur_halo * 2) + 1] = {};
+
+// The same blur as one non-separable kernel, 81 taps per pixel; what effects cost without the separable path
+static void blur_2d_kernel(const uint32_t* src, uint32_t stride, __m256 /*pixels*/, uint32_t /*threadID*/, simple_tiling_utils::color_batch* colors_out)
+{
+    const auto channel_mask = _mm256_set1_epi32(0xff);
+    auto red = _mm256_setzero_ps();
+    auto green = _mm256_setzero_ps();
+    auto blue = _mm256_setzero_ps();
+    for (int32_t dy = -static_cast<int32_t>(blur_halo); dy <= static_cast<int32_t>(blur_halo); dy++)
+    {
+        for (int32_t dx = -static_cast<int32_t>(blur_halo); dx <= static_cast<int32_t>(blur_halo); dx++)
+        {
+            const auto w = _mm256_set1_ps(blur_weights[dy + blur_halo] * blur_weights[dx + blur_halo]);
+            const auto px = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + (static_cast<int64_t>(dy) * stride) + dx));
+            red = _mm256_fmadd_ps(_mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(px, 16), channel_mask)), w, red);
+            green = _mm256_fmadd_ps(_mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(px, 8), channel_mask)), w, green);
+            blue = _mm256_fmadd_ps(_mm256_cvtepi32_ps(_mm256_and_si256(px, channel_mask)), w, blue);
+        }
+    }
+    const auto colors = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_cvtps_epi32(red), 16), _mm256_slli_epi32(_mm256_cvtps_epi32(green), 8)),
+                                        _mm256_cvtps_epi32(blue));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(colors_out->colors8bpc), colors);
+}
+
+// 3x3 unsharp mask; kernel effect with a one-pixel halo
+static void sharpen_kernel(const uint32_t* src, uint32_t stride, __m256 /*pixels*/, uint32_t /*threadID*/, simple_tiling_utils::color_batch* colors_out)
+{
+    const auto centre = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+    const auto left = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src - 1));
+    const auto right = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 1));
+    const auto up = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src - stride));
+    const auto down = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + stride));
+    auto colors = _mm256_setzero_si256();
+    for (uint32_t s = 0; s < 24; s += 8)
+    {
+        const auto channel_mask = _mm256_set1_epi32(0xff << s);
+        auto c = _mm256_mullo_epi32(_mm256_srli_epi32(_mm256_and_si256(centre, channel_mask), s), _mm256_set1_epi32(5));
+        c = _mm256_sub_epi32(c, _mm256_srli_epi32(_mm256_and_si256(left, channel_mask), s));
+        c = _mm256_sub_epi32(c, _mm256_srli_epi32(_mm256_and_si256(right, channel_mask), s));
+        c = _mm256_sub_epi32(c, _mm256_srli_epi32(_mm256_and_si256(up, channel_mask), s));
+        c = _mm256_sub_epi32(c, _mm256_srli_epi32(_mm256_and_si256(down, channel_mask), s));
+        c = _mm256_min_epi32(_mm256_max_epi32(c, _mm256_setzero_si256()), _mm256_set1_epi32(0xff));
+        colors = _mm256_or_si256(colors, _mm256_slli_epi32(c, s));
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(colors_out->colors8bpc), colors);
+}
+
+// Post-processing (see [simple_tiling::set_post_processing]) over the plain colour gradient; a separable Gaussian blur vs. the same blur
+// as one 81-tap kernel effect, plus a three-effect chain (blur, sharpen, blur) to show what each extra barrier costs
+// Max diff compares the 2D blur against the separable one; they only differ in float rounding
+static void post_suite(uint32_t num_tiles)
+{
+    bench_width = 1920;
+    bench_height = 1080;
+    const uint64_t num_px = static_cast<uint64_t>(bench_width) * bench_height;
+    float weight_sum = 0.0f;
+    for (int32_t i = -static_cast<int32_t>(blur_halo); i <= static_cast<int32_t>(blur_halo); i++)
+    {
+        blur_weights[i + blur_halo] = expf(-static_cast<float>(i * i) / 8.0f);
+        weight_sum += blur_weights[i + blur_halo];
+    }
+    for (float& w : blur_weights)
+    {
+        w /= weight_sum;
+    }
+
+    simple_tiling_utils::post_effect blur = {};
+    blur.type = simple_tiling_utils::SEPARABLE_POST_EFFECT;
+    blur.halo = blur_halo;
+    blur.weights = blur_weights;
+    simple_tiling_utils::post_effect blur_2d = {};
+    blur_2d.type = simple_tiling_utils::KERNEL_POST_EFFECT;
+    blur_2d.halo = blur_halo;
+    blur_2d.job = blur_2d_kernel;
+    simple_tiling_utils::post_effect sharpen = {};
+    sharpen.type = simple_tiling_utils::KERNEL_POST_EFFECT;
+    sharpen.halo = 1;
+    sharpen.job = sharpen_kernel;
+    const simple_tiling_utils::post_effect chain[] = { blur, sharpen, blur };
+
+    struct config
+    {
+        const char* name;
+        const simple_tiling_utils::post_effect* effects;
+        uint32_t num_effects;
+    };
+    const config configs[] = { { "none", nullptr, 0 },
+                               { "blur", &blur, 1 },
+                               { "blur-2d", &blur_2d, 1 },
+                               { "chain", chain, 3 } };
+
+    std::vector<uint32_t> reference;
+    printf("%-14s %12s %10s\n", "effects", "ms/frame", "max diff");
+    for (const config& c : configs)
+    {
+        simple_tiling::setup(num_tiles, bench_width, bench_height, false, simple_tiling_utils::HEADLESS_BACKEND);
+        simple_tiling::set_post_processing(c.effects, c.num_effects);
+
+        bench_time = 0.0f;
+        for (uint32_t i = 0; i < warmup_frames; i++)
+        {
+            simple_tiling::render_frame(colours_kernel);
+        }
+        const auto t0 = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < bench_frames; i++)
+        {
+            simple_tiling::render_frame(colours_kernel);
+        }
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() / bench_frames;
+
+        const uint32_t* frame = simple_tiling::GetBackBuffer();
+        int32_t max_diff = 0;
+        if (c.effects == &blur)
+        {
+            reference.assign(frame, frame + num_px);
+        }
+        else if (c.effects == &blur_2d)
+        {
+            for (uint64_t p = 0; p < num_px; p++)
+            {
+                for (uint32_t s = 0; s < 24; s += 8)
+                {
+                    max_diff = std::max(max_diff, abs(static_cast<int32_t>((frame[p] >> s) & 0xff) - static_cast<int32_t>((reference[p] >> s) & 0xff)));
+                }
+            }
+        }
+        simple_tiling::shutdown();
+
+        if (c.effects == &blur_2d)
+        {
+            printf("%-14s %12.3f %10d\n", c.name, ms, max_diff);
+        }
+        else
+        {
+            printf("%-14s %12.3f %10s\n", c.name, ms, "-");
+        }
+    }
+    bench_time = 0.0f;
+}
+
+// Fused-chain stages (see [simple_tiling::submit_fused_draw_work]); [colours_kernel]'s gradient as display colors, then a colour grade (contrast,
+// saturation + a vignette) on top
+static simple_tiling_utils::color_vectors VECTOR_CALL colours_stage(__m256 pixels, uint32_t /*threadID*/, simple_tiling_utils::color_vectors colors)
+{
+    const auto tvec = _mm256_set1_ps(bench_time);
+    const auto wvec = _mm256_set1_ps(static_cast<float>(bench_width));
+    const auto yvec = _mm256_floor_ps(_mm256_div_ps(pixels, wvec));
+    const auto xvec = _mm256_sub_ps(pixels, _mm256_mul_ps(yvec, wvec));
+    const auto half = _mm256_set1_ps(0.5f);
+    colors.red = _mm256_fmadd_ps(half, bench_cos(_mm256_add_ps(tvec, _mm256_div_ps(xvec, wvec))), half);
+    colors.green = _mm256_set1_ps(0.2f);
+    colors.blue = _mm256_fmadd_ps(half, bench_cos(_mm256_add_ps(tvec, _mm256_div_ps(yvec, _mm256_set1_ps(static_cast<float>(bench_height))))), half);
+    return colors;
+}
+
+static simple_tiling_utils::color_vectors VECTOR_CALL grade_stage(__m256 pixels, uint32_t /*threadID*/, simple_tiling_utils::color_vectors colors)
+{
+    const auto wvec = _mm256_set1_ps(static_cast<float>(bench_width));
+    const auto yvec = _mm256_floor_ps(_mm256_div_ps(pixels, wvec));
+    const auto xvec = _mm256_sub_ps(pixels, _mm256_mul_ps(yvec, wvec));
+    const auto half = _mm256_set1_ps(0.5f);
+    const auto contrast = _mm256_set1_ps(1.25f);
+    const auto saturation = _mm256_set1_ps(1.4f);
+    const auto luma = _mm256_fmadd_ps(colors.red, _mm256_set1_ps(0.2126f),
+                                      _mm256_fmadd_ps(colors.green, _mm256_set1_ps(0.7152f), _mm256_mul_ps(colors.blue, _mm256_set1_ps(0.0722f))));
+    const auto du = _mm256_sub_ps(_mm256_div_ps(xvec, wvec), half);
+    const auto dv = _mm256_sub_ps(_mm256_div_ps(yvec, _mm256_set1_ps(static_cast<float>(bench_height))), half);
+    const auto vignette = _mm256_fnmadd_ps(_mm256_fmadd_ps(du, du, _mm256_mul_ps(dv, dv)), _mm256_set1_ps(0.8f), _mm256_set1_ps(1.0f));
+    auto grade = [&](__m256 c)
+    {
+        c = _mm256_fmadd_ps(_mm256_sub_ps(c, luma), saturation, luma);
+        return _mm256_mul_ps(_mm256_fmadd_ps(_mm256_sub_ps(c, half), contrast, half), vignette);
+    };
+    colors.red = grade(colors.red);
+    colors.green = grade(colors.green);
+    colors.blue = grade(colors.blue);
+    return colors;
+}
+
+static simple_tiling_utils::color_vectors no_colors()
+{
+    return { _mm256_setzero_ps(), _mm256_setzero_ps(), _mm256_setzero_ps() };
+}
+
+static __m256i pack_display_colors(const simple_tiling_utils::color_vectors& colors)
+{
+    const auto scale = _mm256_set1_ps(255.0f);
+    const auto zero = _mm256_setzero_si256();
+    const auto max_channel = _mm256_set1_epi32(255);
+    const auto r = _mm256_min_epi32(_mm256_max_epi32(_mm256_cvtps_epi32(_mm256_mul_ps(colors.red, scale)), zero), max_channel);
+    const auto g = _mm256_min_epi32(_mm256_max_epi32(_mm256_cvtps_epi32(_mm256_mul_ps(colors.green, scale)), zero), max_channel);
+    const auto b = _mm256_min_epi32(_mm256_max_epi32(_mm256_cvtps_epi32(_mm256_mul_ps(colors.blue, scale)), zero), max_channel);
+    return _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(r, 16), _mm256_slli_epi32(g, 8)), b);
+}
+
+// The same two stages as separate draw jobs; the grade reads the base colour back out of tile memory, like hosts have to without fused chains
+static void colours_stage_kernel(__m256 pixels, uint32_t threadID, simple_tiling_utils::color_batch* colors_out)
+{
+    const simple_tiling_utils::color_vectors colors = colours_stage(pixels, threadID, no_colors());
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(colors_out->colors8bpc), pack_display_colors(colors));
+}
+
+static void grade_stage_kernel(__m256 pixels, uint32_t threadID, simple_tiling_utils::color_batch* colors_out)
+{
+    const auto px = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(colors_out->colors8bpc));
+    const auto channel_mask = _mm256_set1_epi32(0xff);
+    const auto to_display = _mm256_set1_ps(1.0f / 255.0f);
+    simple_tiling_utils::color_vectors colors;
+    colors.red = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(px, 16), channel_mask)), to_display);
+    colors.green = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(px, 8), channel_mask)), to_display);
+    colors.blue = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(px, channel_mask)), to_display);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(colors_out->colors8bpc), pack_display_colors(grade_stage(pixels, threadID, colors)));
+}
+
+// Both stages hand-fused into one kernel; the floor for any chain of them
+static void graded_colours_kernel(__m256 pixels, uint32_t threadID, simple_tiling_utils::color_batch* colors_out)
+{
+    const simple_tiling_utils::color_vectors colors = grade_stage(pixels, threadID, colours_stage(pixels, threadID, no_colors()));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(colors_out->colors8bpc), pack_display_colors(colors));
+}
+
+// Base colour + grade as two draw jobs per frame, as one fused chain (see [simple_tiling::submit_fused_draw_work]), as a compile-time chain
+// (see [simple_tiling_utils::fuse_stages]), and hand-fused into one kernel; in tile-buffer + direct output. Separate jobs pay for a second pass over the tile (and a second copy-out), and quantize between
+// stages, which is where their max diff comes from in tile-buffer mode; with direct output each pass lands in a different swap-chain
+// buffer, so the grade never sees the base colours at all (hosts chaining jobs like that need the tile buffer)
+static void fused_suite(uint32_t num_tiles)
+{
+    bench_width = 1920;
+    bench_height = 1080;
+    const uint64_t num_px = static_cast<uint64_t>(bench_width) * bench_height;
+    simple_tiling_utils::fused_chain chain = {};
+    chain.stages[0] = colours_stage;
+    chain.stages[1] = grade_stage;
+    chain.num_stages = 2;
+    const auto inlined_chain = simple_tiling_utils::fuse_stages(simple_tiling_utils::static_stage<colours_stage>(), simple_tiling_utils::static_stage<grade_stage>());
+
+    enum DRAW_STYLES
+    {
+        SEPARATE_JOBS,
+        FUSED_CHAIN,
+        INLINED_CHAIN,
+        ONE_KERNEL
+    };
+    struct config
+    {
+        const char* name;
+        DRAW_STYLES style;
+    };
+    const config configs[] = { { "one kernel", ONE_KERNEL }, { "two jobs", SEPARATE_JOBS }, { "fused chain", FUSED_CHAIN }, { "inlined chain", INLINED_CHAIN } };
+    const simple_tiling_utils::OUTPUT_MODES modes[] = { simple_tiling_utils::TILE_BUFFER_OUTPUT, simple_tiling_utils::DIRECT_OUTPUT };
+
+    printf("%-14s %-12s %12s %10s\n", "draw", "output", "ms/frame", "max diff");
+    for (const simple_tiling_utils::OUTPUT_MODES mode : modes)
+    {
+        std::vector<uint32_t> reference;
+        for (const config& c : configs)
+        {
+            simple_tiling::setup(num_tiles, bench_width, bench_height, false, simple_tiling_utils::HEADLESS_BACKEND);
+            simple_tiling::set_output_mode(mode);
+            auto draw = [&]()
+            {
+                switch (c.style)
+                {
+                    case SEPARATE_JOBS:
+                        simple_tiling::submit_draw_work(colours_stage_kernel);
+                        simple_tiling::render_frame(grade_stage_kernel);
+                        break;
+                    case FUSED_CHAIN:
+                        simple_tiling::render_frame(chain);
+                        break;
+                    case INLINED_CHAIN:
+                        simple_tiling::render_frame_inlined(inlined_chain);
+                        break;
+                    default:
+                        simple_tiling::render_frame(graded_colours_kernel);
+                        break;
+                }
+            };
+
+            bench_time = 0.0f;
+            for (uint32_t i = 0; i < warmup_frames; i++)
+            {
+                draw();
+            }
+            const auto t0 = std::chrono::steady_clock::now();
+            for (uint32_t i = 0; i < bench_frames; i++)
+            {
+                draw();
+            }
+            const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() / bench_frames;
+
+            // Compare the last frame against the hand-fused kernel's
+            const uint32_t* frame = simple_tiling::GetBackBuffer();
+            int32_t max_diff = 0;
+            if (c.style == ONE_KERNEL)
+            {
+                reference.assign(frame, frame + num_px);
+            }
+            else
+            {
+                for (uint64_t p = 0; p < num_px; p++)
+                {
+                    for (uint32_t s = 0; s < 24; s += 8)
+                    {
+                        max_diff = std::max(max_diff, abs(static_cast<int32_t>((frame[p] >> s) & 0xff) - static_cast<int32_t>((reference[p] >> s) & 0xff)));
+                    }
+                }
+            }
+            simple_tiling::shutdown();
+
+            const char* output = (mode == simple_tiling_utils::DIRECT_OUTPUT) ? "direct" : "tile-buffer";
+            if (c.style == ONE_KERNEL)
+            {
+                printf("%-14s %-12s %12.3f %10s\n", c.name, output, ms, "-");
+            }
+            else
+            {
+                printf("%-14s %-12s %12.3f %10d\n", c.name, output, ms, max_diff);
+            }
+        }
+    }
+    bench_time = 0.0f;
+}
+
+// Per-batch overhead of function-pointer draw jobs vs. inlined ones (see [simple_tiling::submit_inlined_draw_work]), for a kernel cheap enough
+// that the call dominates (gradient) and one with some real maths in it (colours); same kernel bodies both ways, so frames should match exactly
+// Overhead per batch is the frame-time difference spread over every batch shaded (tile-buffer + direct output, to see it with + without copy-out)
+static void inlined_suite(uint32_t num_tiles)
+{
+    bench_width = 1920;
+    bench_height = 1080;
+    const uint64_t num_px = static_cast<uint64_t>(bench_width) * bench_height;
+    const float width = static_cast<float>(bench_width);
+    const float height = static_cast<float>(bench_height);
+    const float time = 1.25f;
+    auto inlined_gradient = [width](__m256 pixels, uint32_t /*threadID*/, simple_tiling_utils::color_batch* colors_out)
+    {
+        gradient_batch(pixels, width, colors_out);
+    };
+    auto inlined_colours = [time, width, height](__m256 pixels, uint32_t /*threadID*/, simple_tiling_utils::color_batch* colors_out)
+    {
+        colours_batch(pixels, time, width, height, colors_out);
+    };
+
+    struct config
+    {
+        const char* name;
+        bool colours;
+    };
+    const config configs[] = { { "gradient", false }, { "colours", true } };
+    const simple_tiling_utils::OUTPUT_MODES modes[] = { simple_tiling_utils::TILE_BUFFER_OUTPUT, simple_tiling_utils::DIRECT_OUTPUT };
+
+    printf("%-10s %-12s %14s %14s %14s %10s\n", "kernel", "output", "pointer ms", "inlined ms", "saved ns/batch", "max diff");
+    for (const simple_tiling_utils::OUTPUT_MODES mode : modes)
+    {
+        for (const config& c : configs)
+        {
+            simple_tiling::setup(num_tiles, bench_width, bench_height, false, simple_tiling_utils::HEADLESS_BACKEND);
+            simple_tiling::set_output_mode(mode);
+            bench_time = time;
+
+            double ms[2] = {};
+            uint64_t batches = 0;
+            std::vector<uint32_t> reference;
+            int32_t max_diff = 0;
+            for (uint32_t inlined = 0; inlined < 2; inlined++)
+            {
+                auto draw = [&]()
+                {
+                    if (inlined)
+                    {
+                        c.colours ? simple_tiling::render_frame_inlined(inlined_colours) : simple_tiling::render_frame_inlined(inlined_gradient);
+                    }
+                    else
+                    {
+                        simple_tiling::render_frame(c.colours ? colours_kernel : gradient_kernel);
+                    }
+                };
+
+                for (uint32_t i = 0; i < warmup_frames; i++)
+                {
+                    draw();
+                }
+                const auto stats_before = simple_tiling::GetOutputStats();
+                const auto t0 = std::chrono::steady_clock::now();
+                for (uint32_t i = 0; i < bench_frames; i++)
+                {
+                    draw();
+                }
+                ms[inlined] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() / bench_frames;
+                batches = (simple_tiling::GetOutputStats().bytes_shaded - stats_before.bytes_shaded) / (sizeof(simple_tiling_utils::color_batch) * bench_frames);
+
+                const uint32_t* frame = simple_tiling::GetBackBuffer();
+                if (!inlined)
+                {
+                    reference.assign(frame, frame + num_px);
+                }
+                else
+                {
+                    for (uint64_t p = 0; p < num_px; p++)
+                    {
+                        for (uint32_t s = 0; s < 24; s += 8)
+                        {
+                            max_diff = std::max(max_diff, abs(static_cast<int32_t>((frame[p] >> s) & 0xff) - static_cast<int32_t>((reference[p] >> s) & 0xff)));
+                        }
+                    }
+                }
+            }
+            simple_tiling::shutdown();
+
+            // Frame time is the slowest tile's, so per-batch savings come out of that tile's share of the batches
+            const double tile_batches = static_cast<double>(batches) / num_tiles;
+            const char* output = (mode == simple_tiling_utils::DIRECT_OUTPUT) ? "direct" : "tile-buffer";
+            printf("%-10s %-12s %14.3f %14.3f %14.2f %10d\n", c.name, output, ms[0], ms[1], ((ms[0] - ms[1]) * 1e6) / tile_batches, max_diff);
+        }
+    }
+    bench_time = 0.0f;
+}
+
+// Span versions of [gradient_kernel] + [colours_kernel] (see [simple_tiling::submit_span_draw_work]); coordinates come in as integers, so
+// there's no divide to recover them, and whatever only depends on y (the gradient's green, the colours' blue) is worked out once per row
+static void gradient_span_kernel(uint32_t* dst, uint32_t dst_stride, uint32_t x, uint32_t y, uint32_t count, uint32_t num_rows, uint32_t /*threadID*/)
+{
+    const auto lane_ids = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const auto channel_mask = _mm256_set1_epi32(0xff);
+    for (uint32_t row = 0; row < num_rows; row++)
+    {
+        const auto row_rgb = _mm256_set1_epi32(static_cast<int>(0xff000000 | (((y + row) & 0xff) << 8)));
+        uint32_t* dst_row = dst + (static_cast<uint64_t>(row) * dst_stride);
+        for (uint32_t i = 0; i < count; i += NUM_VECTOR_LANES)
+        {
+            const auto x_i = _mm256_and_si256(_mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(x + i)), lane_ids), channel_mask);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst_row + i), _mm256_or_si256(_mm256_slli_epi32(x_i, 16), row_rgb));
+        }
+    }
+}
+
+static void colours_span_kernel(uint32_t* dst, uint32_t dst_stride, uint32_t x, uint32_t y, uint32_t count, uint32_t num_rows, uint32_t /*threadID*/)
+{
+    const auto lane_offsets = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+    const auto tvec = _mm256_set1_ps(bench_time);
+    const auto inv_w = _mm256_set1_ps(1.0f / static_cast<float>(bench_width));
+    const auto half = _mm256_set1_ps(0.5f);
+    const auto scale = _mm256_set1_ps(255.0f);
+    for (uint32_t row = 0; row < num_rows; row++)
+    {
+        const auto v_vec = _mm256_set1_ps(static_cast<float>(y + row) / static_cast<float>(bench_height));
+        const auto blue = _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_fmadd_ps(half, bench_cos(_mm256_add_ps(tvec, v_vec)), half), scale));
+        uint32_t* dst_row = dst + (static_cast<uint64_t>(row) * dst_stride);
+        auto xvec = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(x)), lane_offsets);
+        for (uint32_t i = 0; i < count; i += NUM_VECTOR_LANES)
+        {
+            const auto red = _mm256_mul_ps(_mm256_fmadd_ps(half, bench_cos(_mm256_fmadd_ps(xvec, inv_w, tvec)), half), scale);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst_row + i), _mm256_or_si256(_mm256_slli_epi32(_mm256_cvttps_epi32(red), 16), blue));
+            xvec = _mm256_add_ps(xvec, _mm256_set1_ps(static_cast<float>(NUM_VECTOR_LANES)));
+        }
+    }
+}
+
+// Per-batch kernels vs. span kernels doing the same work, in tile-buffer + direct output (direct output has unpadded region edges, so it
+// covers the scratch-column path for partial batches as well), and interlaced (checkerboarded pixels vs. checkerboarded span cells)
+static void span_suite(uint32_t num_tiles)
+{
+    bench_width = 1920;
+    bench_height = 1080;
+    bench_time = 1.25f;
+
+    struct config
+    {
+        const char* name;
+        simple_tiling_utils::draw_job batch_kernel;
+        simple_tiling_utils::span_draw_job span_kernel;
+    };
+    const config configs[] = { { "gradient", gradient_kernel, gradient_span_kernel }, { "colours", colours_kernel, colours_span_kernel } };
+    struct output_config
+    {
+        const char* name;
+        simple_tiling_utils::OUTPUT_MODES mode;
+        bool interlaced;
+    };
+    const output_config outputs[] = { { "tile-buffer", simple_tiling_utils::TILE_BUFFER_OUTPUT, false }, { "direct", simple_tiling_utils::DIRECT_OUTPUT, false },
+                                      { "interlaced", simple_tiling_utils::TILE_BUFFER_OUTPUT, true } };
+
+    printf("%-10s %-12s %14s %14s\n", "kernel", "output", "per-batch ms", "span ms");
+    for (const output_config& o : outputs)
+    {
+        for (const config& c : configs)
+        {
+            simple_tiling::setup(num_tiles, bench_width, bench_height, o.interlaced, simple_tiling_utils::HEADLESS_BACKEND);
+            simple_tiling::set_output_mode(o.mode);
+
+            double ms[2] = {};
+            for (uint32_t spans = 0; spans < 2; spans++)
+            {
+                auto draw = [&]()
+                {
+                    spans ? simple_tiling::render_frame(c.span_kernel) : simple_tiling::render_frame(c.batch_kernel);
+                };
+                for (uint32_t i = 0; i < warmup_frames; i++)
+                {
+                    draw();
+                }
+                const auto t0 = std::chrono::steady_clock::now();
+                for (uint32_t i = 0; i < bench_frames; i++)
+                {
+                    draw();
+                }
+                ms[spans] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() / bench_frames;
+            }
+            simple_tiling::shutdown();
+
+            printf("%-10s %-12s %14.3f %14.3f\n", c.name, o.name, ms[0], ms[1]);
+        }
+    }
+    bench_time = 0.0f;
+}
+
+// Two-level raymarching; a short march for every pixel, then the full [raymarch_steps] for rays that hadn't finished by then, which are
+// scattered thinly along the cluster's silhouette. Marching is deterministic, so either way every pixel ends up exactly as [raymarch_kernel] leaves it
+static constexpr uint32_t coarse_march_steps = 16;
+
+// Dense refinement; batches with any unfinished lane march again in full, so every lane pays for its slowest neighbour
+static void dense_refine_kernel(__m256 pixels, uint32_t threadID, simple_tiling_utils::color_batch* colors_out)
+{
+    __m256 active;
+    __m256 steps = march_spheres(pixels, threadID, coarse_march_steps, active);
+    if (_mm256_movemask_ps(active) != 0)
+    {
+        steps = march_spheres(pixels, threadID, raymarch_steps, active);
+    }
+    shade_steps(steps, colors_out);
+}
+
+// Sparse refinement; the short march lists unfinished rays (see [simple_tiling::mark_pixels]), then a sparse pass marches only those,
+// eight to a batch
+static void coarse_march_kernel(__m256 pixels, uint32_t threadID, simple_tiling_utils::color_batch* colors_out)
+{
+    __m256 active;
+    shade_steps(march_spheres(pixels, threadID, coarse_march_steps, active), colors_out);
+    simple_tiling::mark_pixels(threadID, pixels, _mm256_castps_si256(active));
+}
+
+static void sparse_refine_kernel(__m256 pixels, uint32_t threadID, simple_tiling_utils::color_batch* colors_out)
+{
+    __m256 active;
+    shade_steps(march_spheres(pixels, threadID, raymarch_steps, active), colors_out);
+}
+
+// Full-length marching everywhere vs. dense + sparse refinement of a short march, at 1080p; reports how many rays needed refining, and what
+// share of the lanes in dense refinement's re-marched batches were actually doing useful work
+// Sparse passes copy out like any other pass, so they only pay off once the lanes they save outweigh a copy-out; this scene refines too
+// little to get there without dirty tracking, so treat those times as an upper bound on sparse overhead. With dirty tracking, sparse passes
+// only hash + copy out the spans their pixels landed in (see [simple_tiling::set_dirty_tracking])
+static void sparse_suite(uint32_t num_tiles)
+{
+    bench_width = 1920;
+    bench_height = 1080;
+
+    // Lane occupancy for dense refinement, straight from the kernel maths
+    uint64_t unfinished = 0;
+    uint64_t refined_batches = 0;
+    for (uint32_t y = 0; y < bench_height; y++)
+    {
+        for (uint32_t x = 0; x < bench_width; x += NUM_VECTOR_LANES)
+        {
+            const float init_px = static_cast<float>((y * bench_width) + x);
+            __m256 active;
+            march_spheres(_mm256_add_ps(_mm256_set1_ps(init_px), _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f)), 0, coarse_march_steps, active);
+            const uint32_t num_active = static_cast<uint32_t>(std::popcount(static_cast<uint32_t>(_mm256_movemask_ps(active))));
+            unfinished += num_active;
+            refined_batches += (num_active > 0) ? 1 : 0;
+        }
+    }
+
+    struct method
+    {
+        const char* name;
+        uint32_t passes; // 0 = full marching, 1 = dense refinement, 2 = short march + sparse refinement
+        bool dirty_tracking;
+    };
+    const method methods[] = { { "full", 0, false }, { "dense", 1, false }, { "sparse", 2, false }, { "full", 0, true }, { "dense", 1, true }, { "sparse", 2, true } };
+    std::vector<uint32_t> reference(static_cast<size_t>(bench_width) * bench_height);
+
+    printf("%u rays of %u unfinished after %u steps; dense refinement re-marches %llu batches, %.1f%% of their lanes busy\n",
+           static_cast<uint32_t>(unfinished), bench_width * bench_height, coarse_march_steps, static_cast<unsigned long long>(refined_batches),
+           refined_batches > 0 ? (100.0 * unfinished) / (static_cast<double>(refined_batches) * NUM_VECTOR_LANES) : 0.0);
+    printf("%-8s %-6s %10s %14s %12s %14s %10s\n", "method", "dirty", "ms", "sparse px", "MB copied", "spans hashed", "max diff");
+    for (const method& m : methods)
+    {
+        simple_tiling::setup(num_tiles, bench_width, bench_height, false, simple_tiling_utils::HEADLESS_BACKEND);
+        simple_tiling::set_pixel_lists(m.passes == 2);
+        simple_tiling::set_dirty_tracking(m.dirty_tracking);
+        auto draw = [&]()
+        {
+            if (m.passes == 2)
+            {
+                simple_tiling::render_frame(coarse_march_kernel);
+                simple_tiling::render_frame_sparse(sparse_refine_kernel);
+            }
+            else
+            {
+                simple_tiling::render_frame(m.passes == 1 ? dense_refine_kernel : raymarch_kernel);
+            }
+        };
+        for (uint32_t i = 0; i < warmup_frames; i++)
+        {
+            draw();
+        }
+
+        const simple_tiling_utils::output_stats stats_before = simple_tiling::GetOutputStats();
+        const auto t0 = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < bench_frames; i++)
+        {
+            draw();
+        }
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() / bench_frames;
+        const simple_tiling_utils::output_stats stats = simple_tiling::GetOutputStats();
+        const uint64_t sparse_px = (stats.sparse_pixels - stats_before.sparse_pixels) / bench_frames;
+        const double mb_copied = static_cast<double>(stats.bytes_copied - stats_before.bytes_copied) / (1e6 * bench_frames);
+        const uint64_t spans_hashed = (stats.spans_hashed - stats_before.spans_hashed) / bench_frames;
+
+        // Every method should land on exactly the same image
+        const uint32_t* frame = simple_tiling::GetBackBuffer();
+        int max_diff = 0;
+        for (size_t i = 0; i < reference.size(); i++)
+        {
+            if (&m == methods)
+            {
+                reference[i] = frame[i];
+            }
+            max_diff = std::max(max_diff, std::abs(static_cast<int>(frame[i] & 0xff) - static_cast<int>(reference[i] & 0xff)));
+        }
+        simple_tiling::shutdown();
+        printf("%-8s %-6s %10.3f %14llu %12.1f %14llu %10d\n", m.name, m.dirty_tracking ? "on" : "off", ms, static_cast<unsigned long long>(sparse_px), mb_copied,
+               static_cast<unsigned long long>(spans_hashed), max_diff);
+    }
+}
+
+// Hard-edged shapes (a ring of discs over diagonal stripes), flat-colored so nothing hides their edges; places samples with
+// [simple_tiling::GetSampleJitter], so anti-aliasing + accumulation both smooth it
+static constexpr uint32_t num_edge_discs = 6;
+static float edge_disc_x[num_edge_discs] = {};
+static float edge_disc_y[num_edge_discs] = {};
+static void edges_kernel(__m256 pixels, uint32_t threadID, simple_tiling_utils::color_batch* colors_out)
+{
+    const simple_tiling_utils::sample_jitter jitter = simple_tiling::GetSampleJitter(threadID);
+    const auto wvec = _mm256_set1_ps(static_cast<float>(bench_width));
+    const auto pixel_y = _mm256_floor_ps(_mm256_div_ps(pixels, wvec));
+    const auto xvec = _mm256_add_ps(_mm256_sub_ps(pixels, _mm256_mul_ps(pixel_y, wvec)), _mm256_set1_ps(0.5f + jitter.x));
+    const auto yvec = _mm256_add_ps(pixel_y, _mm256_set1_ps(0.5f + jitter.y));
+
+    const auto stripe = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvttps_epi32(_mm256_fmadd_ps(xvec, _mm256_set1_ps(0.021f), _mm256_mul_ps(yvec, _mm256_set1_ps(0.008f)))), 31));
+    auto disc = _mm256_setzero_ps();
+    for (uint32_t i = 0; i < num_edge_discs; i++)
+    {
+        const auto dx = _mm256_sub_ps(xvec, _mm256_set1_ps(edge_disc_x[i]));
+        const auto dy = _mm256_sub_ps(yvec, _mm256_set1_ps(edge_disc_y[i]));
+        disc = _mm256_or_ps(disc, _mm256_cmp_ps(_mm256_fmadd_ps(dx, dx, _mm256_mul_ps(dy, dy)), _mm256_set1_ps(bench_height * bench_height * 0.01f), _CMP_LT_OQ));
+    }
+    const auto inside = _mm256_castps_si256(_mm256_xor_ps(disc, _mm256_cmp_ps(stripe, _mm256_setzero_ps(), _CMP_NEQ_UQ)));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(colors_out), _mm256_blendv_epi8(_mm256_set1_epi32(0xff102080), _mm256_set1_epi32(0xffe0c020), inside));
+}
+
+// Adaptive anti-aliasing (see [simple_tiling::set_anti_aliasing]) over hard-edged shapes at 1080p; frame time, share of pixels found on
+// edges, and PSNR against a converged (64 samples per pixel) accumulated frame, next to what accumulation needs for a frame of similar quality
+static void aa_suite(uint32_t num_tiles)
+{
+    constexpr uint32_t max_samples = 64;
+    constexpr uint32_t ssaa_samples = 9;
+    bench_width = 1920;
+    bench_height = 1080;
+    const uint64_t num_px = static_cast<uint64_t>(bench_width) * bench_height;
+    for (uint32_t i = 0; i < num_edge_discs; i++)
+    {
+        const float angle = static_cast<float>(i) * (6.2831853f / num_edge_discs);
+        edge_disc_x[i] = (bench_width * 0.5f) + (bench_height * 0.3f * cosf(angle));
+        edge_disc_y[i] = (bench_height * 0.5f) + (bench_height * 0.3f * sinf(angle));
+    }
+
+    auto time_frames = [](uint32_t num_frames)
+    {
+        const auto t0 = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < num_frames; i++)
+        {
+            simple_tiling::render_frame(edges_kernel);
+        }
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() / num_frames;
+    };
+    auto psnr = [num_px](const uint32_t* frame, const std::vector<uint32_t>& reference)
+    {
+        double sq_err = 0.0;
+        for (uint64_t p = 0; p < num_px; p++)
+        {
+            for (uint32_t c = 0; c < 24; c += 8)
+            {
+                const double d = static_cast<double>((frame[p] >> c) & 0xff) - static_cast<double>((reference[p] >> c) & 0xff);
+                sq_err += d * d;
+            }
+        }
+        const double mse = sq_err / (3.0 * num_px);
+        return mse > 0.0 ? 10.0 * log10((255.0 * 255.0) / mse) : INFINITY;
+    };
+
+    // Reference + brute-force supersampling, both through accumulation; every frame from setup adds one sample
+    simple_tiling::setup(num_tiles, bench_width, bench_height, false, simple_tiling_utils::HEADLESS_BACKEND);
+    simple_tiling::set_accumulation(true, max_samples);
+    std::vector<uint32_t> ssaa;
+    double ssaa_ms = 0.0;
+    for (uint32_t s = 1; s <= max_samples; s++)
+    {
+        const double ms = time_frames(1);
+        if (s <= ssaa_samples)
+        {
+            ssaa_ms += ms;
+        }
+        if (s == ssaa_samples)
+        {
+            ssaa.assign(simple_tiling::GetBackBuffer(), simple_tiling::GetBackBuffer() + num_px);
+        }
+    }
+    const std::vector<uint32_t> reference(simple_tiling::GetBackBuffer(), simple_tiling::GetBackBuffer() + num_px);
+    simple_tiling::shutdown();
+
+    struct aa_config
+    {
+        const char* name;
+        simple_tiling_utils::ANTI_ALIASING_MODES mode;
+        simple_tiling_utils::AA_FILTERS filter;
+    };
+    const aa_config configs[] = { { "none", simple_tiling_utils::AA_OFF, simple_tiling_utils::AA_BOX_FILTER },
+                                  { "4x box", simple_tiling_utils::AA_ADAPTIVE_4X, simple_tiling_utils::AA_BOX_FILTER },
+                                  { "4x tent", simple_tiling_utils::AA_ADAPTIVE_4X, simple_tiling_utils::AA_TENT_FILTER },
+                                  { "8x box", simple_tiling_utils::AA_ADAPTIVE_8X, simple_tiling_utils::AA_BOX_FILTER },
+                                  { "8x tent", simple_tiling_utils::AA_ADAPTIVE_8X, simple_tiling_utils::AA_TENT_FILTER } };
+
+    printf("%-10s %12s %10s %10s\n", "aa", "ms/frame", "edges %", "PSNR (dB)");
+    for (const aa_config& config : configs)
+    {
+        simple_tiling::setup(num_tiles, bench_width, bench_height, false, simple_tiling_utils::HEADLESS_BACKEND);
+        simple_tiling::set_anti_aliasing(config.mode, config.filter);
+        time_frames(warmup_frames);
+        const uint64_t edges_before = simple_tiling::GetOutputStats().aa_pixels;
+        const double ms = time_frames(bench_frames);
+        const double edge_share = (100.0 * (simple_tiling::GetOutputStats().aa_pixels - edges_before)) / (static_cast<double>(num_px) * bench_frames);
+        printf("%-10s %12.3f %10.2f %10.1f\n", config.name, ms, edge_share, psnr(simple_tiling::GetBackBuffer(), reference));
+        simple_tiling::shutdown();
+    }
+    printf("%-10s %12.3f %10.2f %10.1f\n", "ssaa 9x", ssaa_ms, 100.0, psnr(ssaa.data(), reference));
+}
+
+// X11_SHM_BACKEND in a real window; animated colours, presented from this thread after every frame, then from the presenter thread
+// Present times include the backend's XSync, so they cover the server reading each frame as well as us sending it
+#if defined(__linux__) && defined(SIMPLE_TILING_X11)
+static void x11_suite(uint32_t num_tiles)
+{
+    XInitThreads(); // The presenter thread presents through the same connection we set up on
+    Display* display = XOpenDisplay(nullptr);
+    if (display == nullptr)
+    {
+        printf("Couldn't open an X display; set DISPLAY, or run under xvfb-run\n");
+        return;
+    }
+
+    bench_width = 1280;
+    bench_height = 720;
+    const int screen = DefaultScreen(display);
+    const Window window = XCreateSimpleWindow(display, RootWindow(display, screen), 0, 0, bench_width, bench_height, 0, BlackPixel(display, screen),
+                                              BlackPixel(display, screen));
+    XMapWindow(display, window);
+    XSync(display, False);
+    simple_tiling_utils::x11_target target = { display, window };
+
+    printf("%-10s %10s %10s %14s %14s %16s %16s %8s\n", "presenting", "ms/frame", "presents", "avg present us", "max present us", "MB/present",
+           "avg latency us", "missed");
+    for (const bool presenter_thread : { false, true })
+    {
+        simple_tiling::setup(num_tiles, bench_width, bench_height, false, simple_tiling_utils::X11_SHM_BACKEND, &target);
+        if (presenter_thread)
+        {
+            simple_tiling::start_presenter(&target);
+        }
+
+        const auto t0 = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < bench_frames; i++)
+        {
+            bench_time = i * 0.05f;
+            simple_tiling::render_frame(colours_kernel);
+            if (!presenter_thread)
+            {
+                simple_tiling::present(&target, 1000);
+            }
+        }
+        const auto t1 = std::chrono::steady_clock::now();
+        simple_tiling::stop_presenter();
+
+        const simple_tiling_utils::present_stats stats = simple_tiling::GetPresentStats();
+        const double mb_per_present = stats.num_presents > 0 ? (stats.pixels_blitted * sizeof(uint32_t)) / (stats.num_presents * 1024.0 * 1024.0) : 0.0;
+        printf("%-10s %10.3f %10llu %14.1f %14llu %16.2f %16.1f %8llu\n", presenter_thread ? "thread" : "inline",
+               std::chrono::duration<double, std::milli>(t1 - t0).count() / bench_frames, static_cast<unsigned long long>(stats.num_presents),
+               stats.avg_present_us, static_cast<unsigned long long>(stats.max_present_us), mb_per_present, stats.avg_latency_us,
+               static_cast<unsigned long long>(stats.missed_deadlines));
+        simple_tiling::shutdown();
+    }
+
+    XDestroyWindow(display, window);
+    XCloseDisplay(display);
+}
+#else
+static void x11_suite(uint32_t)
+{
+    printf("Built without SIMPLE_TILING_X11; reconfigure with -DSIMPLE_TILING_X11=ON (needs libX11 + libXext)\n");
+}
+#endif
+
+int main(int argc, char** argv)
+{
+    const char* suite = argc > 1 ? argv[1] : "output";
+    const uint32_t num_tiles = argc > 2 ? static_cast<uint32_t>(atoi(argv[2])) : 8;
+
+    if (strcmp(suite, "output") == 0)
+    {
+        output_suite(num_tiles);
+    }
+    else if (strcmp(suite, "reconfigure") == 0)
+    {
+        reconfigure_suite(num_tiles);
+    }
+    else if (strcmp(suite, "layout") == 0)
+    {
+        layout_suite(num_tiles);
+    }
+    else if (strcmp(suite, "adaptive") == 0)
+    {
+        adaptive_suite(num_tiles);
+    }
+    else if (strcmp(suite, "checkerboard") == 0)
+    {
+        checkerboard_suite(num_tiles);
+    }
+    else if (strcmp(suite, "resolution") == 0)
+    {
+        resolution_suite(num_tiles);
+    }
+    else if (strcmp(suite, "rates") == 0)
+    {
+        rates_suite(num_tiles);
+    }
+    else if (strcmp(suite, "accumulation") == 0)
+    {
+        accumulation_suite(num_tiles);
+    }
+    else if (strcmp(suite, "reprojection") == 0)
+    {
+        reprojection_suite(num_tiles);
+    }
+    else if (strcmp(suite, "hdr") == 0)
+    {
+        hdr_suite(num_tiles);
+    }
+    else if (strcmp(suite, "post") == 0)
+    {
+        post_suite(num_tiles);
+    }
+    else if (strcmp(suite, "fused") == 0)
+    {
+        fused_suite(num_tiles);
+    }
+    else if (strcmp(suite, "inlined") == 0)
+    {
+        inlined_suite(num_tiles);
+    }
+    else if (strcmp(suite, "span") == 0)
+    {
+        span_suite(num_tiles);
+    }
+    else if (strcmp(suite, "sparse") == 0)
+    {
+        sparse_suite(num_tiles);
+    }
+    else if (strcmp(suite, "aa") == 0)
+    {
+        aa_suite(num_tiles);
+    }
+    else if (strcmp(suite, "x11") == 0)
+    {
+        x11_suite(num_tiles);
+    }
+    else
+    {
+        printf("Unknown suite \"%s\"\n", suite);
+        return 1;
+    }
+    return 0;
+}
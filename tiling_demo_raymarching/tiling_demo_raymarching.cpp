@@ -54,7 +54,9 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
     bool frame_issued = false;
     while (GetMessage(&msg, nullptr, 0, 0))
     {
-        simple_tiling::submit_draw_work([](__m256 pixels, uint32_t threadID, simple_tiling_utils::color_batch* colors_out)
+        // Span kernel; each call covers a whole block of the tile (rows of [count] pixels from (x, y)), so everything that doesn't depend on
+        // the pixel (helpers, the camera's focal length, each row's ray height) is set up once per call/row instead of once per batch
+        simple_tiling::submit_span_draw_work([](uint32_t* dst, uint32_t dst_stride, uint32_t x, uint32_t y, uint32_t count, uint32_t num_rows, uint32_t threadID)
         {
             // Minimal raymarcher
             /////////////////////
@@ -62,30 +64,11 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
             // Useful numbers
             auto wvec = _mm256_set1_ps(window_width);
             auto hvec = _mm256_set1_ps(window_height);
-            
-            // Camera ray directions
-            auto yvec = _mm256_floor_ps(_mm256_div_ps(pixels, wvec));
-            auto xvec = _mm256_sub_ps(pixels, _mm256_mul_ps(yvec, wvec));
-
-            yvec = _mm256_sub_ps(yvec, _mm256_mul_ps(yvec, _mm256_set1_ps(0.5f)));
-            xvec = _mm256_sub_ps(xvec, _mm256_mul_ps(wvec, _mm256_set1_ps(0.5f)));
-            auto zvec = _mm256_div_ps(wvec, _mm256_tan_ps(_mm256_set1_ps(1.62f * 0.5f)));
-
-            // Ray-marching utility variables
-            auto eps = _mm256_set1_ps(0.001f);
-            auto maxDist = _mm256_set1_ps(0.001f);
-            auto traceDistX = _mm256_set1_ps(0.0f);
-            auto traceDistY = _mm256_set1_ps(0.0f);
-            auto traceDistZ = _mm256_set1_ps(0.0f);
-
-            auto laneState = _mm256_set1_epi32(INT_MAX);   
-            const auto laneLiveState = _mm256_set1_epi32(0);
-
-            // Camera position
-            // Starting at the origin for now, keeping things simple
-            auto camPosX = _mm256_set1_ps(0.0f);
-            auto camPosY = _mm256_set1_ps(0.0f);
-            auto camPosZ = _mm256_set1_ps(0.0f);
+            const auto lane_offsets = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+            const auto zdist = _mm256_div_ps(wvec, _mm256_tan_ps(_mm256_set1_ps(1.62f * 0.5f)));
+
+            // Sub-pixel sample position; zero for ordinary passes, offset when anti-aliasing re-shades the sphere's edges
+            const simple_tiling_utils::sample_jitter jitter = simple_tiling::GetSampleJitter(threadID);
 
             auto vlen = [](__m256 xv, __m256 yv, __m256 zv)
             {
@@ -104,9 +87,6 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
                 *zv = _mm256_div_ps(*zv, len);
             };
 
-            // Normalize camera ray directions
-            normalize(&xvec, &yvec, &zvec);
-
             // Some lambdas to keep things readable
             auto sphereSDF = [](__m256* xv, __m256* yv, __m256* zv, float radius, float posx, float posy, float posz, __m256* outDistX, __m256* outDistY, __m256* outDistZ)
             {
@@ -126,65 +106,105 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
                 *outDistZ = _mm256_sub_ps(rayPosDiffZ, rv);
             };
 
-            while (memcmp(&laneState, &laneLiveState, sizeof(__m256)) != 0)
+            for (uint32_t row = 0; row < num_rows; row++)
             {
-                // SDF distance test
-                __m256 distX, distY, distZ;
-                sphereSDF(&camPosX, &camPosY, &camPosZ, 4.0f, 0.0f, 0.0f, -10.0f, &distX, &distY, &distZ);
+                // Camera ray directions
+                const auto row_y = _mm256_set1_ps(static_cast<float>(y + row) + jitter.y);
+                const auto row_yvec = _mm256_sub_ps(row_y, _mm256_mul_ps(row_y, _mm256_set1_ps(0.5f)));
+                uint32_t* colors_out = dst + (row * dst_stride);
+                for (uint32_t i = 0; i < count; i += NUM_VECTOR_LANES)
+                {
+                    auto xvec = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(x + i) + jitter.x), lane_offsets);
+                    auto yvec = row_yvec;
+                    xvec = _mm256_sub_ps(xvec, _mm256_mul_ps(wvec, _mm256_set1_ps(0.5f)));
+                    auto zvec = zdist;
+
+                    // Normalize camera ray directions
+                    normalize(&xvec, &yvec, &zvec);
+
+                    // Ray-marching utility variables
+                    auto eps = _mm256_set1_ps(0.001f);
+                    auto maxDist = _mm256_set1_ps(0.001f);
+                    auto traceDistX = _mm256_set1_ps(0.0f);
+                    auto traceDistY = _mm256_set1_ps(0.0f);
+                    auto traceDistZ = _mm256_set1_ps(0.0f);
+
+                    auto laneState = _mm256_set1_epi32(INT_MAX);   
+                    const auto laneLiveState = _mm256_set1_epi32(0);
+
+                    // Camera position
+                    // Starting at the origin for now, keeping things simple
+                    auto camPosX = _mm256_set1_ps(0.0f);
+                    auto camPosY = _mm256_set1_ps(0.0f);
+                    auto camPosZ = _mm256_set1_ps(0.0f);
+
+                    while (memcmp(&laneState, &laneLiveState, sizeof(__m256)) != 0)
+                    {
+                        // SDF distance test
+                        __m256 distX, distY, distZ;
+                        sphereSDF(&camPosX, &camPosY, &camPosZ, 4.0f, 0.0f, 0.0f, -10.0f, &distX, &distY, &distZ);
                 
-                // For each lane; compare manhattan distance to eps (per-axis) and overwrite existing 
-                laneState = _mm256_and_epi32(laneState, _mm256_castps_si256(_mm256_cmp_ps(distX, eps, _CMP_GT_OQ)));
-                laneState = _mm256_and_epi32(laneState, _mm256_castps_si256(_mm256_cmp_ps(distY, eps, _CMP_GT_OQ)));
-                laneState = _mm256_and_epi32(laneState, _mm256_castps_si256(_mm256_cmp_ps(distZ, eps, _CMP_GT_OQ)));
-
-                // Zero-out distance changes for inactive lanes
-                const auto laneMask = _mm256_castsi256_ps(_mm256_div_epi32(laneState, laneLiveState));
-                distX = _mm256_mul_ps(distX, laneMask);
-                distY = _mm256_mul_ps(distY, laneMask);
-                distZ = _mm256_mul_ps(distZ, laneMask);
-
-                // Shift ray forward
-                camPosX = _mm256_add_ps(camPosX, distX);
-                camPosY = _mm256_add_ps(camPosY, distY);
-                camPosZ = _mm256_add_ps(camPosZ, distZ);
-
-                // Accumulate trace distance
-                traceDistX = _mm256_add_ps(traceDistX, distX);
-                traceDistY = _mm256_add_ps(traceDistY, distX);
-                traceDistZ = _mm256_add_ps(traceDistZ, distX);
-
-                // For each lane; compare manhattan distance to eps (per-axis) and merge with existing 
-                auto skyHit = _mm256_castps_si256(_mm256_cmp_ps(traceDistX, maxDist, _CMP_GT_OQ));
-                skyHit = _mm256_and_epi32(skyHit, _mm256_castps_si256(_mm256_cmp_ps(traceDistY, maxDist, _CMP_GT_OQ)));
-                skyHit = _mm256_and_epi32(skyHit, _mm256_castps_si256(_mm256_cmp_ps(traceDistZ, maxDist, _CMP_GT_OQ)));
-                laneState = _mm256_or_epi32(skyHit, laneState);
-            }
-
-            // Shading
-            // Hex colors are in ARGB order
-            ///////////////////////////////
-
-            // Bithackery on floats...hm :p
-            // Need to do some type juggling here I think
-
-            // Sky
-            auto skyMask = _mm256_cmp_ps(traceDistX, maxDist, _CMP_EQ_OQ);
-            skyMask = _mm256_and_ps(_mm256_cmp_ps(traceDistY, maxDist, _CMP_EQ_OQ), skyMask);
-            skyMask = _mm256_and_ps(_mm256_cmp_ps(traceDistZ, maxDist, _CMP_EQ_OQ), skyMask);
-            skyMask = _mm256_div_ps(skyMask, _mm256_set1_ps(INT_MAX));
+                        // For each lane; compare manhattan distance to eps (per-axis) and overwrite existing 
+                        laneState = _mm256_and_epi32(laneState, _mm256_castps_si256(_mm256_cmp_ps(distX, eps, _CMP_GT_OQ)));
+                        laneState = _mm256_and_epi32(laneState, _mm256_castps_si256(_mm256_cmp_ps(distY, eps, _CMP_GT_OQ)));
+                        laneState = _mm256_and_epi32(laneState, _mm256_castps_si256(_mm256_cmp_ps(distZ, eps, _CMP_GT_OQ)));
+
+                        // Zero-out distance changes for inactive lanes
+                        const auto laneMask = _mm256_castsi256_ps(_mm256_div_epi32(laneState, laneLiveState));
+                        distX = _mm256_mul_ps(distX, laneMask);
+                        distY = _mm256_mul_ps(distY, laneMask);
+                        distZ = _mm256_mul_ps(distZ, laneMask);
+
+                        // Shift ray forward
+                        camPosX = _mm256_add_ps(camPosX, distX);
+                        camPosY = _mm256_add_ps(camPosY, distY);
+                        camPosZ = _mm256_add_ps(camPosZ, distZ);
+
+                        // Accumulate trace distance
+                        traceDistX = _mm256_add_ps(traceDistX, distX);
+                        traceDistY = _mm256_add_ps(traceDistY, distX);
+                        traceDistZ = _mm256_add_ps(traceDistZ, distX);
+
+                        // For each lane; compare manhattan distance to eps (per-axis) and merge with existing 
+                        auto skyHit = _mm256_castps_si256(_mm256_cmp_ps(traceDistX, maxDist, _CMP_GT_OQ));
+                        skyHit = _mm256_and_epi32(skyHit, _mm256_castps_si256(_mm256_cmp_ps(traceDistY, maxDist, _CMP_GT_OQ)));
+                        skyHit = _mm256_and_epi32(skyHit, _mm256_castps_si256(_mm256_cmp_ps(traceDistZ, maxDist, _CMP_GT_OQ)));
+                        laneState = _mm256_or_epi32(skyHit, laneState);
+                    }
+
+                    // Shading
+                    // Hex colors are in ARGB order
+                    ///////////////////////////////
+
+                    // Bithackery on floats...hm :p
+                    // Need to do some type juggling here I think
+
+                    // Sky
+                    auto skyMask = _mm256_cmp_ps(traceDistX, maxDist, _CMP_EQ_OQ);
+                    skyMask = _mm256_and_ps(_mm256_cmp_ps(traceDistY, maxDist, _CMP_EQ_OQ), skyMask);
+                    skyMask = _mm256_and_ps(_mm256_cmp_ps(traceDistZ, maxDist, _CMP_EQ_OQ), skyMask);
+                    skyMask = _mm256_div_ps(skyMask, _mm256_set1_ps(INT_MAX));
             
-            auto skyMaskInteger = _mm256_castps_si256(skyMask);
-            auto skyRGB = _mm256_mul_epi32(skyMaskInteger, _mm256_set1_epi32(0x000000ff)); // Blue
+                    auto skyMaskInteger = _mm256_castps_si256(skyMask);
+                    auto skyRGB = _mm256_mul_epi32(skyMaskInteger, _mm256_set1_epi32(0x000000ff)); // Blue
             
-            // Surface
-            auto surfRGB = _mm256_set1_epi32(0x00ffa500); // Orange (yes I googled it)
-
-            // Final color, naive non-blending color mix
-            auto rgb = _mm256_xor_epi32(skyRGB, surfRGB);
-            rgb = _mm256_or_epi32(rgb, _mm256_set1_epi32(0xff000000)); // OR in alpha here
-            memcpy(colors_out, &rgb, sizeof(__m256));
+                    // Surface
+                    auto surfRGB = _mm256_set1_epi32(0x00ffa500); // Orange (yes I googled it)
+
+                    // Final color, naive non-blending color mix
+                    auto rgb = _mm256_xor_epi32(skyRGB, surfRGB);
+                    rgb = _mm256_or_epi32(rgb, _mm256_set1_epi32(0xff000000)); // OR in alpha here
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(colors_out + i), rgb);
+                }
+            }
         });
 
+        // Geometry only covers part of the screen, so tiles over it take much longer than sky tiles; let the library even them out
+        simple_tiling::rebalance_tiles();
+
+        // Trade resolution for frame time whenever the spheres fill enough of the screen to blow the budget
+        simple_tiling::update_dynamic_resolution();
+
         if (!TranslateAccelerator(msg.hwnd, hAccelTable, &msg))
         {
             TranslateMessage(&msg);
@@ -249,6 +269,11 @@ BOOL InitInstance(HINSTANCE hInstance, int nCmdShow)
     // Required to be initialized early, since [ShowWindow] will invoke WM_PAINT -> ::win_paint, which depeends on
     // a valid BITMAPINFO being defined for copy-outs
     simple_tiling::setup(NUM_TILE_THREADS, window_width, window_height, true);
+    simple_tiling::set_adaptive_tiling(true);
+    simple_tiling::set_dynamic_resolution(true, 16.0f, 0.5f, 0.25f);
+
+    // Smooth out the sphere's silhouette; only the pixels along it pay for the extra samples
+    simple_tiling::set_anti_aliasing(simple_tiling_utils::AA_ADAPTIVE_4X);
 
     ShowWindow(hWnd, nCmdShow);
     UpdateWindow(hWnd);